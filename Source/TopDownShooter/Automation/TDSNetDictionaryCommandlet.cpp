@@ -0,0 +1,125 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSNetDictionaryCommandlet.h"
+#include "TDSNetCompression.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+UTDSNetDictionaryCommandlet::UTDSNetDictionaryCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+}
+
+int32 UTDSNetDictionaryCommandlet::Main(const FString& Params)
+{
+    FString CaptureDir;
+    if (!FParse::Value(*Params, TEXT("Captures="), CaptureDir))
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSNetDictionary: -Captures= is required"));
+        return 1;
+    }
+
+    FString OutputPackage = TEXT("/Game/Net/TDSNetDictionary");
+    FParse::Value(*Params, TEXT("Output="), OutputPackage);
+
+    TArray<FString> CaptureFiles;
+    IFileManager::Get().FindFiles(CaptureFiles, *(CaptureDir / TEXT("*.tdsnetcap")), true, false);
+    if (CaptureFiles.IsEmpty())
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSNetDictionary: no .tdsnetcap files in %s"), *CaptureDir);
+        return 1;
+    }
+
+    // Частоты байтов по всем пакетам выборки
+    uint64 Frequencies[FTDSHuffmanCodec::NumSymbols] = {};
+    TArray<TArray<uint8>> Packets;
+    int64 TotalBytes = 0;
+    TArray<uint8> Packet;
+
+    for (const FString& FileName : CaptureFiles)
+    {
+        TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*(CaptureDir / FileName)));
+        if (!Reader)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("TDSNetDictionary: failed to open %s"), *FileName);
+            continue;
+        }
+
+        while (Reader->Tell() < Reader->TotalSize())
+        {
+            int32 NumBits = 0;
+            *Reader << NumBits;
+            const int32 NumBytes = FMath::DivideAndRoundUp(NumBits, 8);
+            if (NumBits <= 0 || Reader->Tell() + NumBytes > Reader->TotalSize())
+            {
+                UE_LOG(LogTemp, Warning, TEXT("TDSNetDictionary: %s is truncated"), *FileName);
+                break;
+            }
+
+            Packet.SetNumUninitialized(NumBytes);
+            Reader->Serialize(Packet.GetData(), NumBytes);
+            for (const uint8 Byte : Packet)
+            {
+                ++Frequencies[Byte];
+            }
+            TotalBytes += NumBytes;
+            Packets.Add(Packet);
+        }
+    }
+
+    if (Packets.IsEmpty())
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSNetDictionary: captures contain no packets"));
+        return 1;
+    }
+
+    uint8 Lengths[FTDSHuffmanCodec::NumSymbols];
+    FTDSHuffmanCodec::BuildCodeLengths(Frequencies, Lengths);
+
+    FTDSHuffmanCodec Codec;
+    if (!Codec.Initialize(Lengths))
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSNetDictionary: failed to build code"));
+        return 1;
+    }
+
+    // Оценка как в FTDSCompressionHandlerComponent::Outgoing: каждый пакет сжат или отправлен как есть
+    int64 SentBits = 0;
+    int32 CompressedPackets = 0;
+    for (const TArray<uint8>& Captured : Packets)
+    {
+        // Заголовок сжатого пакета: бит формата и 16 бит исходной длины
+        const int64 RawBits = Captured.Num() * 8;
+        const int64 CompressedBits = 17 + Codec.GetEncodedBits(Captured.GetData(), Captured.Num());
+        CompressedPackets += CompressedBits <= RawBits;
+        SentBits += FMath::Min(RawBits + 1, CompressedBits);
+    }
+    const float Ratio = static_cast<float>(static_cast<double>(SentBits) / (TotalBytes * 8));
+
+    UPackage* Package = CreatePackage(*OutputPackage);
+    UTDSNetDictionary* Dictionary = NewObject<UTDSNetDictionary>(Package, *FPackageName::GetShortName(OutputPackage), RF_Public | RF_Standalone);
+    Dictionary->CodeLengths = TArray<uint8>(Lengths, FTDSHuffmanCodec::NumSymbols);
+    Dictionary->TrainedPackets = Packets.Num();
+    Dictionary->TrainedBytes = TotalBytes;
+    Dictionary->TrainedRatio = Ratio;
+    Dictionary->MarkPackageDirty();
+
+    const FString FileName = FPackageName::LongPackageNameToFilename(OutputPackage, FPackageName::GetAssetPackageExtension());
+    FSavePackageArgs SaveArgs;
+    SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+    if (!UPackage::SavePackage(Package, Dictionary, *FileName, SaveArgs))
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSNetDictionary: failed to save %s"), *FileName);
+        return 1;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("TDSNetDictionary: %d packets, %lld bytes from %d files; ratio %.3f, %d packets compressed; saved %s"),
+        Packets.Num(), TotalBytes, CaptureFiles.Num(), Ratio, CompressedPackets, *FileName);
+    return 0;
+}
@@ -0,0 +1,28 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TDSNetDictionaryCommandlet.generated.h"
+
+/**
+ * Обучение словаря сжатия пакетов (UTDSNetDictionary) на записанном трафике.
+ * Выборка пишется сервером и клиентами с ключом -TDSNetCapture=<папка>
+ * (например, во время UTDSNetScenarioCommandlet или матча ботов).
+ *
+ *   UnrealEditor-Cmd TopDownShooter.uproject -run=TDSNetDictionary -Captures=<папка>
+ *       [-Output=/Game/Net/TDSNetDictionary]
+ *
+ * Результат – ассет, который уходит в cook вместе с игрой.
+ */
+UCLASS()
+class UTDSNetDictionaryCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UTDSNetDictionaryCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
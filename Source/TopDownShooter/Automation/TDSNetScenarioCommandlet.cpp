@@ -0,0 +1,181 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSNetScenarioCommandlet.h"
+#include "TDSNetScenarioSubsystem.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace TDSNetScenario
+{
+    /** Профиль сети; задержка и разброс – в одну сторону, мс */
+    struct FNetProfile
+    {
+        const TCHAR* Name;
+        int32 PktLag;
+        int32 PktLagVariance;
+        int32 PktLoss;
+    };
+
+    /** Off плюс аналоги стандартных профилей NetEmulation редактора */
+    static const FNetProfile Profiles[] =
+    {
+        { TEXT("Off"),     0,   0,  0 },
+        { TEXT("Average"), 30,  10, 1 },
+        { TEXT("Bad"),     100, 30, 5 },
+    };
+
+    /** Сколько серверных секунд даём процессам на загрузку и подключение */
+    static constexpr double StartDelaySeconds = 30.0;
+
+    /** Запас времени сверх расписания, после которого процессы снимаются */
+    static constexpr double TimeoutMarginSeconds = 60.0;
+
+    static const FNetProfile* FindProfile(const FString& Name)
+    {
+        for (const FNetProfile& Profile : Profiles)
+        {
+            if (Name.Equals(Profile.Name, ESearchCase::IgnoreCase))
+            {
+                return &Profile;
+            }
+        }
+        return nullptr;
+    }
+
+    static FString GetNetEmulationArgs(const FNetProfile& Profile)
+    {
+        return FString::Printf(TEXT("-PktLag=%d -PktLagVariance=%d -PktLoss=%d"), Profile.PktLag, Profile.PktLagVariance, Profile.PktLoss);
+    }
+}
+
+UTDSNetScenarioCommandlet::UTDSNetScenarioCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UTDSNetScenarioCommandlet::Main(const FString& Params)
+{
+    FString Map;
+    if (!FParse::Value(*Params, TEXT("Map="), Map))
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSNetScenario: -Map= is required"));
+        return 1;
+    }
+
+    int32 NumClients = 2;
+    int32 Port = 17777;
+    double PhaseSeconds = 20.0;
+    FString ProfilesString = TEXT("Off,Average,Bad");
+    FString SummaryPath = FPaths::ProfilingDir() / TEXT("TDSNetScenario") /
+        FString::Printf(TEXT("Summary-%s.csv"), *FDateTime::Now().ToString());
+
+    FParse::Value(*Params, TEXT("Clients="), NumClients);
+    FParse::Value(*Params, TEXT("Port="), Port);
+    FParse::Value(*Params, TEXT("PhaseSeconds="), PhaseSeconds);
+    FParse::Value(*Params, TEXT("Profiles="), ProfilesString);
+    FParse::Value(*Params, TEXT("Output="), SummaryPath);
+    NumClients = FMath::Max(NumClients, 1);
+
+    TArray<FString> ProfileNames;
+    ProfilesString.ParseIntoArray(ProfileNames, TEXT(","));
+
+    const FString Executable = FPlatformProcess::ExecutablePath();
+    const FString Project = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+    const FString OutputDir = FPaths::GetPath(FPaths::ConvertRelativePathToFull(SummaryPath));
+    const double ScenarioSeconds = TDSNetScenario::StartDelaySeconds + static_cast<int32>(ETDSNetScenarioPhase::Count) * PhaseSeconds;
+
+    FString Summary;
+    int32 FailedProfiles = 0;
+
+    for (const FString& ProfileName : ProfileNames)
+    {
+        const TDSNetScenario::FNetProfile* Profile = TDSNetScenario::FindProfile(ProfileName);
+        if (!Profile)
+        {
+            UE_LOG(LogTemp, Error, TEXT("TDSNetScenario: unknown profile %s"), *ProfileName);
+            ++FailedProfiles;
+            continue;
+        }
+
+        const FString ServerCsv = OutputDir / FString::Printf(TEXT("Server-%s.csv"), Profile->Name);
+        IFileManager::Get().Delete(*ServerCsv, false, true, true);
+
+        const FString ScenarioArgs = FString::Printf(TEXT("-TDSNetScenarioStart=%.0f -TDSNetScenarioPhaseSeconds=%.0f -TDSNetScenarioProfile=%s %s"),
+            TDSNetScenario::StartDelaySeconds, PhaseSeconds, Profile->Name, *TDSNetScenario::GetNetEmulationArgs(*Profile));
+
+        const FString ServerArgs = FString::Printf(TEXT("\"%s\" %s -server -nullrhi -unattended -nosound -port=%d -TDSNetScenario=Server -TDSNetScenarioOutput=\"%s\" %s -log=TDSNetScenario-Server-%s.log"),
+            *Project, *Map, Port, *ServerCsv, *ScenarioArgs, Profile->Name);
+
+        UE_LOG(LogTemp, Display, TEXT("TDSNetScenario: profile %s, %d clients"), Profile->Name, NumClients);
+
+        TArray<FProcHandle> Processes;
+        Processes.Add(FPlatformProcess::CreateProc(*Executable, *ServerArgs, true, true, true, nullptr, 0, nullptr, nullptr));
+
+        // Даём серверу открыть порт до запуска клиентов
+        FPlatformProcess::Sleep(5.0f);
+
+        for (int32 ClientIndex = 0; ClientIndex < NumClients; ++ClientIndex)
+        {
+            const FString ClientArgs = FString::Printf(TEXT("\"%s\" 127.0.0.1:%d -game -nullrhi -unattended -nosound -windowed -TDSNetScenario=Client %s -log=TDSNetScenario-Client%d-%s.log"),
+                *Project, Port, *ScenarioArgs, ClientIndex, Profile->Name);
+            Processes.Add(FPlatformProcess::CreateProc(*Executable, *ClientArgs, true, true, true, nullptr, 0, nullptr, nullptr));
+        }
+
+        // Процессы сами выходят после последней фазы; зависшие снимаем по таймауту.
+        // Код выхода сервера – итог профиля: 1, если фаза не дошла до своего режима
+        const double Deadline = FPlatformTime::Seconds() + ScenarioSeconds + TDSNetScenario::TimeoutMarginSeconds;
+        int32 ServerReturnCode = INDEX_NONE;
+        for (int32 ProcessIndex = 0; ProcessIndex < Processes.Num(); ++ProcessIndex)
+        {
+            FProcHandle& Process = Processes[ProcessIndex];
+            while (Process.IsValid() && FPlatformProcess::IsProcRunning(Process) && FPlatformTime::Seconds() < Deadline)
+            {
+                FPlatformProcess::Sleep(1.0f);
+            }
+
+            if (Process.IsValid() && FPlatformProcess::IsProcRunning(Process))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("TDSNetScenario: terminating process that outlived the scenario"));
+                FPlatformProcess::TerminateProc(Process, true);
+            }
+            else if (ProcessIndex == 0 && Process.IsValid())
+            {
+                FPlatformProcess::GetProcReturnCode(Process, &ServerReturnCode);
+            }
+            FPlatformProcess::CloseProc(Process);
+        }
+
+        const bool bServerFailed = ServerReturnCode != 0;
+        if (bServerFailed)
+        {
+            UE_LOG(LogTemp, Error, TEXT("TDSNetScenario: profile %s failed, server exit code %d"), Profile->Name, ServerReturnCode);
+            ++FailedProfiles;
+        }
+
+        TArray<FString> Lines;
+        if (!FFileHelper::LoadFileToStringArray(Lines, *ServerCsv) || Lines.Num() < 2)
+        {
+            UE_LOG(LogTemp, Error, TEXT("TDSNetScenario: no server results for profile %s"), Profile->Name);
+            FailedProfiles += bServerFailed ? 0 : 1;
+            continue;
+        }
+
+        // Заголовок берём из первого профиля
+        for (int32 LineIndex = Summary.IsEmpty() ? 0 : 1; LineIndex < Lines.Num(); ++LineIndex)
+        {
+            Summary += Lines[LineIndex] + TEXT("\n");
+        }
+    }
+
+    if (!Summary.IsEmpty() && FFileHelper::SaveStringToFile(Summary, *SummaryPath))
+    {
+        UE_LOG(LogTemp, Display, TEXT("TDSNetScenario: summary written to %s"), *SummaryPath);
+    }
+
+    return FailedProfiles == 0 && !Summary.IsEmpty() ? 0 : 1;
+}
@@ -0,0 +1,31 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TDSNetScenarioCommandlet.generated.h"
+
+/**
+ * Многопроцессный сетевой сценарий: для каждого профиля сети поднимает сервер и N клиентов
+ * по loopback, ждёт окончания UTDSNetScenarioSubsystem и сводит CSV сервера в один файл.
+ *
+ *   UnrealEditor-Cmd TopDownShooter.uproject -run=TDSNetScenario -Map=/Game/Maps/Arena
+ *       [-Clients=2] [-Profiles=Off,Average,Bad] [-PhaseSeconds=20] [-Port=17777] [-Output=Summary.csv]
+ *
+ * Эмуляция сети задаётся ключами PktLag/PktLoss/PktLagVariance обоим процессам, поэтому
+ * требует сборки с DO_ENABLE_NET_TEST (не Shipping).
+ *
+ * Код выхода 1, если хоть один профиль провален: сервер вышел не с 0 (фаза не дошла до своего режима),
+ * был снят по таймауту или не записал CSV.
+ */
+UCLASS()
+class UTDSNetScenarioCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UTDSNetScenarioCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,351 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSNetScenarioSubsystem.h"
+#include "TDSScriptedMovement.h"
+#include "TDSCharacter.h"
+#include "TDSStats.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "EngineUtils.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace TDSNetScenario
+{
+    static constexpr int32 PhaseCount = static_cast<int32>(ETDSNetScenarioPhase::Count);
+
+    /** Радиус круга, по которому ходит клиент */
+    static constexpr float PathRadius = 600.0f;
+
+    /** Радиус поиска стены для wall run */
+    static constexpr float WallSearchRadius = 1000.0f;
+
+    /** Режим, которого персонаж должен достичь за фазу; false – у фазы его нет */
+    static bool GetPhaseTarget(ETDSNetScenarioPhase Phase, ETDSScriptedMove& OutMove)
+    {
+        switch (Phase)
+        {
+        case ETDSNetScenarioPhase::Gait:    OutMove = ETDSScriptedMove::Sprint;  return true;
+        case ETDSNetScenarioPhase::Slide:   OutMove = ETDSScriptedMove::Slide;   return true;
+        case ETDSNetScenarioPhase::Prone:   OutMove = ETDSScriptedMove::Prone;   return true;
+        case ETDSNetScenarioPhase::WallRun: OutMove = ETDSScriptedMove::WallRun; return true;
+        default:                            return false;
+        }
+    }
+
+    /** Шаг сценария внутри фазы: чередование подготовки (разгон, бег) и самого режима */
+    static ETDSScriptedMove GetScriptedMove(ETDSNetScenarioPhase Phase, double TimeInPhase)
+    {
+        switch (Phase)
+        {
+        case ETDSNetScenarioPhase::Gait:
+        {
+            static const ETDSScriptedMove Gaits[] = { ETDSScriptedMove::Walk, ETDSScriptedMove::Run, ETDSScriptedMove::Sprint };
+            return Gaits[FMath::FloorToInt(TimeInPhase) % UE_ARRAY_COUNT(Gaits)];
+        }
+        case ETDSNetScenarioPhase::Slide:
+            return FMath::FloorToInt(TimeInPhase / 1.5) % 2 ? ETDSScriptedMove::Slide : ETDSScriptedMove::Sprint;
+        case ETDSNetScenarioPhase::Prone:
+            return FMath::FloorToInt(TimeInPhase / 2.0) % 2 ? ETDSScriptedMove::Prone : ETDSScriptedMove::Run;
+        case ETDSNetScenarioPhase::WallRun:
+            return FMath::FloorToInt(TimeInPhase / 1.5) % 2 ? ETDSScriptedMove::WallRun : ETDSScriptedMove::Sprint;
+        default:
+            return ETDSScriptedMove::Run;
+        }
+    }
+}
+
+bool UTDSNetScenarioSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    if (!Super::ShouldCreateSubsystem(Outer))
+    {
+        return false;
+    }
+
+    const UWorld* World = Cast<UWorld>(Outer);
+    if (!World || !World->IsGameWorld())
+    {
+        return false;
+    }
+
+    FString Role;
+    return FParse::Value(FCommandLine::Get(), TEXT("TDSNetScenario="), Role);
+}
+
+void UTDSNetScenarioSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    FString Role;
+    FParse::Value(FCommandLine::Get(), TEXT("TDSNetScenario="), Role);
+    bServer = Role.Equals(TEXT("Server"), ESearchCase::IgnoreCase);
+
+    // Клиент до подключения грузит стартовую карту – сценарий идёт только в сетевом мире
+    const ENetMode NetMode = InWorld.GetNetMode();
+    if (bServer ? NetMode == NM_Client || NetMode == NM_Standalone : NetMode != NM_Client)
+    {
+        return;
+    }
+
+    FParse::Value(FCommandLine::Get(), TEXT("TDSNetScenarioStart="), StartTime);
+    FParse::Value(FCommandLine::Get(), TEXT("TDSNetScenarioPhaseSeconds="), PhaseSeconds);
+    FParse::Value(FCommandLine::Get(), TEXT("TDSNetScenarioProfile="), ProfileName);
+    PhaseSeconds = FMath::Max(PhaseSeconds, 1.0);
+
+    if (bServer && !FParse::Value(FCommandLine::Get(), TEXT("TDSNetScenarioOutput="), OutputPath))
+    {
+        OutputPath = FPaths::ProfilingDir() / TEXT("TDSNetScenario") /
+            FString::Printf(TEXT("TDSNetScenario-%s.csv"), *FDateTime::Now().ToString());
+    }
+
+    bActive = true;
+
+    UE_LOG(LogTemp, Log, TEXT("TDSNetScenario: %s, profile '%s', start %.0f s, %d phases of %.0f s"),
+        bServer ? TEXT("server") : TEXT("client"), *ProfileName, StartTime, TDSNetScenario::PhaseCount, PhaseSeconds);
+}
+
+TStatId UTDSNetScenarioSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UTDSNetScenarioSubsystem, STATGROUP_Tickables);
+}
+
+const TCHAR* UTDSNetScenarioSubsystem::LexPhase(ETDSNetScenarioPhase Phase)
+{
+    switch (Phase)
+    {
+    case ETDSNetScenarioPhase::Idle:    return TEXT("Idle");
+    case ETDSNetScenarioPhase::Gait:    return TEXT("Gait");
+    case ETDSNetScenarioPhase::Slide:   return TEXT("Slide");
+    case ETDSNetScenarioPhase::Prone:   return TEXT("Prone");
+    case ETDSNetScenarioPhase::WallRun: return TEXT("WallRun");
+    default:                            return TEXT("Unknown");
+    }
+}
+
+double UTDSNetScenarioSubsystem::GetScenarioTime() const
+{
+    const UWorld* World = GetWorld();
+    const AGameStateBase* GameState = World->GetGameState();
+    return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
+int32 UTDSNetScenarioSubsystem::GetPhaseIndex(double ScenarioTime) const
+{
+    if (ScenarioTime < StartTime)
+    {
+        return INDEX_NONE;
+    }
+
+    return FMath::Min(FMath::FloorToInt((ScenarioTime - StartTime) / PhaseSeconds), TDSNetScenario::PhaseCount);
+}
+
+void UTDSNetScenarioSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (!bActive || bFinished)
+    {
+        return;
+    }
+
+    const double ScenarioTime = GetScenarioTime();
+    const int32 PhaseIndex = GetPhaseIndex(ScenarioTime);
+
+    if (bServer)
+    {
+        TickServer(PhaseIndex);
+    }
+    else
+    {
+        TickClient(PhaseIndex, ScenarioTime);
+    }
+}
+
+void UTDSNetScenarioSubsystem::TickServer(int32 PhaseIndex)
+{
+    if (PhaseIndex == CurrentPhase)
+    {
+        SampleServerPhase();
+        return;
+    }
+
+    if (CurrentPhase != INDEX_NONE)
+    {
+        FinishServerPhase();
+    }
+
+    if (PhaseIndex >= TDSNetScenario::PhaseCount)
+    {
+        WriteResults();
+        bFinished = true;
+        const bool bPassed = Results.FindByPredicate([](const FPhaseResult& Result) { return !Result.HasPassed(); }) == nullptr;
+        FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1, TEXT("TDSNetScenario"));
+        return;
+    }
+
+    BeginServerPhase(PhaseIndex);
+}
+
+void UTDSNetScenarioSubsystem::BeginServerPhase(int32 PhaseIndex)
+{
+    const FTDSPerfCounters& Counters = FTDSPerfCounters::Get();
+    const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+
+    CurrentPhase = PhaseIndex;
+    PhaseStartRealTime = FPlatformTime::Seconds();
+    PhaseStartServerMoveRpcs = Counters.ServerMoveRpcs.load(std::memory_order_relaxed);
+    PhaseStartServerMoves = Counters.ServerMoves.load(std::memory_order_relaxed);
+    PhaseStartCorrections = Counters.Corrections.load(std::memory_order_relaxed);
+    PhaseStartInBytes = NetDriver ? NetDriver->InTotalBytes : 0;
+    PhaseStartOutBytes = NetDriver ? NetDriver->OutTotalBytes : 0;
+    PhaseCharacters.Reset();
+    PhaseCharactersReached.Reset();
+
+    UE_LOG(LogTemp, Log, TEXT("TDSNetScenario: phase %s, %d clients"),
+        LexPhase(static_cast<ETDSNetScenarioPhase>(PhaseIndex)), NetDriver ? NetDriver->ClientConnections.Num() : 0);
+}
+
+void UTDSNetScenarioSubsystem::FinishServerPhase()
+{
+    const FTDSPerfCounters& Counters = FTDSPerfCounters::Get();
+    const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+
+    FPhaseResult& Result = Results.AddDefaulted_GetRef();
+    Result.Phase = static_cast<ETDSNetScenarioPhase>(CurrentPhase);
+    Result.Clients = NetDriver ? NetDriver->ClientConnections.Num() : 0;
+    Result.Seconds = FMath::Max(FPlatformTime::Seconds() - PhaseStartRealTime, UE_KINDA_SMALL_NUMBER);
+    Result.ServerMoveRpcs = Counters.ServerMoveRpcs.load(std::memory_order_relaxed) - PhaseStartServerMoveRpcs;
+    Result.ServerMoves = Counters.ServerMoves.load(std::memory_order_relaxed) - PhaseStartServerMoves;
+    Result.Corrections = Counters.Corrections.load(std::memory_order_relaxed) - PhaseStartCorrections;
+    Result.InBytes = NetDriver ? NetDriver->InTotalBytes - PhaseStartInBytes : 0;
+    Result.OutBytes = NetDriver ? NetDriver->OutTotalBytes - PhaseStartOutBytes : 0;
+    Result.Characters = PhaseCharacters.Num();
+    Result.CharactersReached = PhaseCharactersReached.Num();
+
+    if (!Result.HasPassed())
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSNetScenario: phase %s failed, %d of %d characters reached its movement mode"),
+            LexPhase(Result.Phase), Result.CharactersReached, Result.Characters);
+    }
+}
+
+void UTDSNetScenarioSubsystem::SampleServerPhase()
+{
+    ETDSScriptedMove Target;
+    if (CurrentPhase == INDEX_NONE || !TDSNetScenario::GetPhaseTarget(static_cast<ETDSNetScenarioPhase>(CurrentPhase), Target))
+    {
+        return;
+    }
+
+    // Сценарий ведут только клиенты; их персонажи на сервере – под удалёнными контроллерами
+    for (TActorIterator<ATDSCharacter> It(GetWorld()); It; ++It)
+    {
+        ATDSCharacter* Character = *It;
+        if (!Character->IsPlayerControlled() || Character->IsLocallyControlled())
+        {
+            continue;
+        }
+
+        PhaseCharacters.Add(Character);
+        if (TDSScriptedMovement::HasReachedMove(*Character, Target))
+        {
+            PhaseCharactersReached.Add(Character);
+        }
+    }
+}
+
+bool UTDSNetScenarioSubsystem::FPhaseResult::HasPassed() const
+{
+    ETDSScriptedMove Target;
+    return !TDSNetScenario::GetPhaseTarget(Phase, Target) || (Characters > 0 && CharactersReached == Characters);
+}
+
+void UTDSNetScenarioSubsystem::TickClient(int32 PhaseIndex, double ScenarioTime)
+{
+    ATDSCharacter* Character = LocalCharacter.Get();
+    if (!Character)
+    {
+        const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+        Character = PlayerController ? Cast<ATDSCharacter>(PlayerController->GetPawn()) : nullptr;
+        if (!Character)
+        {
+            return;
+        }
+
+        LocalCharacter = Character;
+        Anchor = Character->GetActorLocation() + FVector(TDSNetScenario::PathRadius, 0.0f, 0.0f);
+    }
+
+    if (PhaseIndex >= TDSNetScenario::PhaseCount)
+    {
+        // Даём серверу закрыть последнюю фазу, затем выходим
+        TDSScriptedMovement::ReleaseInput(*Character);
+        if (ScenarioTime >= StartTime + TDSNetScenario::PhaseCount * PhaseSeconds + 2.0)
+        {
+            bFinished = true;
+            FPlatformMisc::RequestExit(false, TEXT("TDSNetScenario"));
+        }
+        return;
+    }
+
+    const ETDSNetScenarioPhase Phase = PhaseIndex == INDEX_NONE ? ETDSNetScenarioPhase::Idle : static_cast<ETDSNetScenarioPhase>(PhaseIndex);
+    if (Phase == ETDSNetScenarioPhase::Idle)
+    {
+        if (LastScriptStep != INDEX_NONE)
+        {
+            TDSScriptedMovement::ReleaseInput(*Character);
+            LastScriptStep = INDEX_NONE;
+        }
+        return;
+    }
+
+    const double TimeInPhase = ScenarioTime - StartTime - PhaseIndex * PhaseSeconds;
+    const ETDSScriptedMove Move = TDSNetScenario::GetScriptedMove(Phase, TimeInPhase);
+
+    // Ввод выставляется только при смене шага, чтобы не дёргать события походки каждый кадр
+    const int32 ScriptStep = PhaseIndex * 16 + static_cast<int32>(Move);
+    if (ScriptStep != LastScriptStep)
+    {
+        LastScriptStep = ScriptStep;
+        bHasWallTarget = Move == ETDSScriptedMove::WallRun &&
+            TDSScriptedMovement::FindWallRunTarget(*Character, TDSNetScenario::WallSearchRadius, WallTarget);
+        TDSScriptedMovement::ApplyMove(*Character, Move);
+    }
+
+    if (bHasWallTarget)
+    {
+        TDSScriptedMovement::SteerAlongWall(*Character, WallTarget);
+    }
+    else
+    {
+        TDSScriptedMovement::SteerAround(*Character, Anchor, TDSNetScenario::PathRadius);
+    }
+}
+
+void UTDSNetScenarioSubsystem::WriteResults()
+{
+    FString Csv = TEXT("Profile,Phase,Clients,Seconds,ServerMoveRpcsPerSec,MovesPerformedPerSec,CorrectionsPerSec,CorrectionsPer100Moves,")
+        TEXT("InKBytesPerSec,OutKBytesPerSec,CharactersReachedMode,Passed\n");
+    for (const FPhaseResult& Result : Results)
+    {
+        const double CorrectionsPer100 = Result.ServerMoves ? 100.0 * Result.Corrections / Result.ServerMoves : 0.0;
+        Csv += FString::Printf(TEXT("%s,%s,%d,%.1f,%.1f,%.1f,%.2f,%.2f,%.2f,%.2f,%d,%d\n"),
+            *ProfileName, LexPhase(Result.Phase), Result.Clients, Result.Seconds,
+            Result.ServerMoveRpcs / Result.Seconds, Result.ServerMoves / Result.Seconds,
+            Result.Corrections / Result.Seconds, CorrectionsPer100,
+            Result.InBytes / 1024.0 / Result.Seconds, Result.OutBytes / 1024.0 / Result.Seconds,
+            Result.CharactersReached, Result.HasPassed() ? 1 : 0);
+    }
+
+    if (FFileHelper::SaveStringToFile(Csv, *OutputPath))
+    {
+        UE_LOG(LogTemp, Log, TEXT("TDSNetScenario: results written to %s"), *OutputPath);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSNetScenario: failed to write %s"), *OutputPath);
+    }
+}
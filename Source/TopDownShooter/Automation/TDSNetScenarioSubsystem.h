@@ -0,0 +1,117 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "TDSScriptedMovement.h"
+#include "TDSNetScenarioSubsystem.generated.h"
+
+class ATDSCharacter;
+
+/** Фазы сетевого сценария; у сервера и клиентов одно расписание по серверному времени */
+enum class ETDSNetScenarioPhase : uint8
+{
+    Idle,
+    Gait,
+    Slide,
+    Prone,
+    WallRun,
+
+    Count
+};
+
+/**
+ * Одна сторона сетевого сценария (см. UTDSNetScenarioCommandlet).
+ *   -TDSNetScenario=Server  считает RPC ServerMove, выполненные ходы, коррекции и трафик по фазам
+ *                           и пишет CSV в -TDSNetScenarioOutput=
+ *   -TDSNetScenario=Client  ведёт локального персонажа по сценарию текущей фазы
+ *
+ * Фаза проваливается, если хоть один персонаж за неё так и не дошёл до её режима движения
+ * (спринт, слайд, prone, wall run); тогда сервер завершается с кодом 1.
+ *
+ * Фаза i длится [Start + i * PhaseSeconds, Start + (i + 1) * PhaseSeconds) серверного времени мира;
+ * Start и PhaseSeconds задаются -TDSNetScenarioStart= и -TDSNetScenarioPhaseSeconds=.
+ * Обе стороны завершают процесс после последней фазы.
+ */
+UCLASS()
+class TOPDOWNSHOOTER_API UTDSNetScenarioSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    static const TCHAR* LexPhase(ETDSNetScenarioPhase Phase);
+
+private:
+    struct FPhaseResult
+    {
+        ETDSNetScenarioPhase Phase = ETDSNetScenarioPhase::Idle;
+        int32 Clients = 0;
+        double Seconds = 0.0;
+        uint64 ServerMoveRpcs = 0;
+        uint64 ServerMoves = 0;
+        uint64 Corrections = 0;
+        uint64 InBytes = 0;
+        uint64 OutBytes = 0;
+
+        /** Персонажи фазы и сколько из них дошли до её режима */
+        int32 Characters = 0;
+        int32 CharactersReached = 0;
+
+        /** У фазы без целевого режима (Idle) всегда true */
+        bool HasPassed() const;
+    };
+
+    /** Время сценария: серверное время мира */
+    double GetScenarioTime() const;
+
+    /** Текущая фаза или INDEX_NONE до старта; PhaseCount после окончания */
+    int32 GetPhaseIndex(double ScenarioTime) const;
+
+    void TickServer(int32 PhaseIndex);
+    void TickClient(int32 PhaseIndex, double ScenarioTime);
+
+    /** Снять счётчики на границе фаз */
+    void BeginServerPhase(int32 PhaseIndex);
+    void FinishServerPhase();
+
+    /** Отметить персонажей, дошедших до режима текущей фазы */
+    void SampleServerPhase();
+
+    void WriteResults();
+
+    bool bServer = false;
+    bool bActive = false;
+    bool bFinished = false;
+
+    double StartTime = 15.0;
+    double PhaseSeconds = 20.0;
+    FString ProfileName;
+    FString OutputPath;
+
+    int32 CurrentPhase = INDEX_NONE;
+
+    /** Сервер: счётчики на начало текущей фазы */
+    double PhaseStartRealTime = 0.0;
+    uint64 PhaseStartServerMoveRpcs = 0;
+    uint64 PhaseStartServerMoves = 0;
+    uint64 PhaseStartCorrections = 0;
+    uint64 PhaseStartInBytes = 0;
+    uint64 PhaseStartOutBytes = 0;
+    TSet<TObjectKey<ATDSCharacter>> PhaseCharacters;
+    TSet<TObjectKey<ATDSCharacter>> PhaseCharactersReached;
+    TArray<FPhaseResult> Results;
+
+    /** Клиент: персонаж, шаг сценария и якорь траектории */
+    TWeakObjectPtr<ATDSCharacter> LocalCharacter;
+    int32 LastScriptStep = INDEX_NONE;
+    FVector Anchor = FVector::ZeroVector;
+    bool bHasWallTarget = false;
+    FTDSWallRunTarget WallTarget;
+};
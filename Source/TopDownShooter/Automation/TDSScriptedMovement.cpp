@@ -0,0 +1,137 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSScriptedMovement.h"
+#include "TDSCharacter.h"
+#include "TDSCharacterMovementComponent.h"
+#include "Engine/World.h"
+
+namespace TDSScriptedMovement
+{
+    /** Число лучей при поиске стены */
+    static constexpr int32 WallSearchRays = 16;
+
+    /** На каком расстоянии от стены бот прыгает, см */
+    static constexpr float WallJumpDistance = 120.0f;
+
+    void ApplyMove(ATDSCharacter& Character, ETDSScriptedMove Move)
+    {
+        UTDSCharacterMovementComponent* MoveComp = Character.GetTDSMovementComponent();
+        if (!MoveComp)
+        {
+            return;
+        }
+
+        // Slide и wall run требуют спринта (CanSlide/AreRequiredWallRunKeysDown)
+        const bool bSprint = Move == ETDSScriptedMove::Sprint || Move == ETDSScriptedMove::Slide || Move == ETDSScriptedMove::WallRun;
+        MoveComp->SetWalking(Move == ETDSScriptedMove::Walk);
+        MoveComp->SetSprinting(bSprint);
+        MoveComp->SetSlideInput(Move == ETDSScriptedMove::Slide);
+        MoveComp->SetProneInput(Move == ETDSScriptedMove::Prone);
+        MoveComp->SetWallRunInput(Move == ETDSScriptedMove::WallRun);
+        MoveComp->UpdateMovementWithGait();
+
+        // Prone включается только из приседа (CanProne)
+        if (Move == ETDSScriptedMove::Prone)
+        {
+            Character.Crouch();
+        }
+        else
+        {
+            Character.UnCrouch();
+        }
+
+        // Прыжок к стене делает SteerAlongWall
+        Character.StopJumping();
+    }
+
+    bool HasReachedMove(const ATDSCharacter& Character, ETDSScriptedMove Move)
+    {
+        const UTDSCharacterMovementComponent* MoveComp = Character.GetTDSMovementComponent();
+        if (!MoveComp)
+        {
+            return false;
+        }
+
+        switch (Move)
+        {
+        case ETDSScriptedMove::Walk:    return MoveComp->IsMovingOnGround() && MoveComp->GetCurrentGait() == EGait::Walk;
+        case ETDSScriptedMove::Run:     return MoveComp->IsMovingOnGround() && MoveComp->GetCurrentGait() == EGait::Run;
+        case ETDSScriptedMove::Sprint:  return MoveComp->IsMovingOnGround() && MoveComp->GetCurrentGait() == EGait::Sprint;
+        case ETDSScriptedMove::Slide:   return MoveComp->IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_Sliding);
+        case ETDSScriptedMove::Prone:   return MoveComp->IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_Prone);
+        case ETDSScriptedMove::WallRun: return MoveComp->IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_WallRunning);
+        }
+        return false;
+    }
+
+    void ReleaseInput(ATDSCharacter& Character)
+    {
+        ApplyMove(Character, ETDSScriptedMove::Run);
+    }
+
+    void SteerAround(ATDSCharacter& Character, const FVector& Anchor, float Radius)
+    {
+        const FVector Location = Character.GetActorLocation();
+        FVector Radial(Location.X - Anchor.X, Location.Y - Anchor.Y, 0.0f);
+        const float Distance = Radial.Size();
+        Radial = Distance > KINDA_SMALL_NUMBER ? Radial / Distance : FVector::ForwardVector;
+
+        // Касательная плюс подтягивание к окружности
+        const FVector Tangent(-Radial.Y, Radial.X, 0.0f);
+        const float Pull = FMath::Clamp((Radius - Distance) / Radius, -1.0f, 1.0f);
+        Character.AddMovementInput((Tangent + Radial * Pull).GetSafeNormal2D());
+    }
+
+    bool FindWallRunTarget(const ATDSCharacter& Character, float SearchRadius, FTDSWallRunTarget& OutTarget)
+    {
+        const UWorld* World = Character.GetWorld();
+        const FVector Start = Character.GetActorLocation();
+
+        FCollisionQueryParams Params(SCENE_QUERY_STAT(TDSScriptedWallSearch), false, &Character);
+        float BestDistance = TNumericLimits<float>::Max();
+
+        for (int32 Ray = 0; Ray < WallSearchRays; ++Ray)
+        {
+            const float Angle = 2.0f * PI * Ray / WallSearchRays;
+            const FVector End = Start + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * SearchRadius;
+
+            FHitResult Hit;
+            if (!World->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility, Params))
+            {
+                continue;
+            }
+
+            // Только почти вертикальные поверхности (см. CanSurfaceBeWallRan)
+            if (FMath::Abs(Hit.ImpactNormal.Z) > 0.05f || Hit.Distance >= BestDistance)
+            {
+                continue;
+            }
+
+            BestDistance = Hit.Distance;
+            OutTarget.Point = Hit.ImpactPoint;
+            OutTarget.Normal = Hit.ImpactNormal.GetSafeNormal2D();
+        }
+
+        return BestDistance < TNumericLimits<float>::Max();
+    }
+
+    void SteerAlongWall(ATDSCharacter& Character, const FTDSWallRunTarget& Target)
+    {
+        const UTDSCharacterMovementComponent* MoveComp = Character.GetTDSMovementComponent();
+        if (!MoveComp)
+        {
+            return;
+        }
+
+        // Вдоль стены и к ней: издалека под 45°, у стены – почти параллельно, чтобы wall run не сорвался
+        const float Distance = FVector::DotProduct(Character.GetActorLocation() - Target.Point, Target.Normal);
+        const FVector Tangent(-Target.Normal.Y, Target.Normal.X, 0.0f);
+        const float Approach = FMath::Clamp(Distance / WallJumpDistance, 0.3f, 1.0f);
+        Character.AddMovementInput((Tangent - Target.Normal * Approach).GetSafeNormal2D());
+
+        if (Distance < WallJumpDistance && MoveComp->IsMovingOnGround())
+        {
+            Character.Jump();
+        }
+    }
+}
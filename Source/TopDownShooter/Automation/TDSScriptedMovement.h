@@ -0,0 +1,46 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ATDSCharacter;
+
+/** Шаги сценария движения, которыми нагрузочные прогоны управляют ботами и клиентами */
+enum class ETDSScriptedMove : uint8
+{
+    Walk,
+    Run,
+    Sprint,
+    Slide,
+    Prone,
+    WallRun
+};
+
+/** Стена, вдоль которой бот выполняет wall run */
+struct FTDSWallRunTarget
+{
+    FVector Point = FVector::ZeroVector;
+    FVector Normal = FVector::ForwardVector;
+};
+
+namespace TDSScriptedMovement
+{
+    /** Выставить ввод UTDSCharacterMovementComponent для шага (вызывать при смене шага) */
+    void ApplyMove(ATDSCharacter& Character, ETDSScriptedMove Move);
+
+    /** Дошёл ли персонаж до состояния шага: гейта для Walk/Run/Sprint, пользовательского режима для остальных */
+    bool HasReachedMove(const ATDSCharacter& Character, ETDSScriptedMove Move);
+
+    /** Отпустить весь сценарный ввод */
+    void ReleaseInput(ATDSCharacter& Character);
+
+    /** Добавить ввод движения по окружности радиуса Radius вокруг Anchor */
+    void SteerAround(ATDSCharacter& Character, const FVector& Anchor, float Radius);
+
+    /** Ближайшая вертикальная стена в радиусе SearchRadius; false – стены рядом нет */
+    bool FindWallRunTarget(const ATDSCharacter& Character, float SearchRadius, FTDSWallRunTarget& OutTarget);
+
+    /** Добавить ввод движения вдоль стены с подходом под углом и прыгнуть у стены – wall run начнётся по OnActorHit */
+    void SteerAlongWall(ATDSCharacter& Character, const FTDSWallRunTarget& Target);
+}
@@ -0,0 +1,427 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSSoakTestSubsystem.h"
+#include "TDSScriptedMovement.h"
+#include "TDSCharacter.h"
+#include "TDSCharacterMovementComponent.h"
+#include "TDSStats.h"
+#include "TDSNetProfilerSubsystem.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerStart.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace TDSSoak
+{
+    /** Длительность одной фазы сценария бота, сек */
+    static constexpr float PhaseSeconds = 2.0f;
+
+    /** Радиус круга, по которому ходит бот */
+    static constexpr float PathRadius = 600.0f;
+
+    /** Радиус поиска стены для wall run */
+    static constexpr float WallSearchRadius = 1000.0f;
+
+    /** Минимальная доля фаз, дошедших до своего режима, при которой прогон считается успешным */
+    static constexpr float MinReachedPct = 90.0f;
+
+    /** Шаг сетки точек появления ботов */
+    static constexpr float SpawnSpacing = 250.0f;
+
+    static float Percentile(TArray<float> Samples, float Fraction)
+    {
+        if (Samples.IsEmpty())
+        {
+            return 0.0f;
+        }
+
+        Samples.Sort();
+        const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Samples.Num()) - 1, 0, Samples.Num() - 1);
+        return Samples[Index];
+    }
+}
+
+bool UTDSSoakTestSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    if (!Super::ShouldCreateSubsystem(Outer))
+    {
+        return false;
+    }
+
+    const UWorld* World = Cast<UWorld>(Outer);
+    if (!World || !World->IsGameWorld())
+    {
+        return false;
+    }
+
+    FString Counts;
+    return FParse::Value(FCommandLine::Get(), TEXT("TDSSoak="), Counts);
+}
+
+void UTDSSoakTestSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    // Боты и замеры имеют смысл только на сервере
+    if (InWorld.GetNetMode() == NM_Client)
+    {
+        return;
+    }
+
+    FString CountsString;
+    FParse::Value(FCommandLine::Get(), TEXT("TDSSoak="), CountsString, false);
+
+    TArray<FString> Tokens;
+    CountsString.ParseIntoArray(Tokens, TEXT(","));
+    for (const FString& Token : Tokens)
+    {
+        const int32 Count = FCString::Atoi(*Token);
+        if (Count > 0)
+        {
+            BotCounts.Add(Count);
+        }
+    }
+    BotCounts.Sort();
+
+    if (BotCounts.IsEmpty())
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSSoak: no bot counts in -TDSSoak=%s"), *CountsString);
+        return;
+    }
+
+    FParse::Value(FCommandLine::Get(), TEXT("TDSSoakStepSeconds="), StepSeconds);
+    FParse::Value(FCommandLine::Get(), TEXT("TDSSoakWarmupSeconds="), WarmupSeconds);
+    StepSeconds = FMath::Max(StepSeconds, 1.0f);
+    WarmupSeconds = FMath::Clamp(WarmupSeconds, 0.0f, StepSeconds - 1.0f);
+    bExitWhenDone = FParse::Param(FCommandLine::Get(), TEXT("TDSSoakExit"));
+
+    if (!FParse::Value(FCommandLine::Get(), TEXT("TDSSoakOutput="), OutputPath))
+    {
+        OutputPath = FPaths::ProfilingDir() / TEXT("TDSSoak") /
+            FString::Printf(TEXT("TDSSoak-%s.csv"), *FDateTime::Now().ToString());
+    }
+
+    FString ClassPath;
+    if (FParse::Value(FCommandLine::Get(), TEXT("TDSSoakCharacterClass="), ClassPath))
+    {
+        BotClass = LoadClass<ATDSCharacter>(nullptr, *ClassPath);
+        if (!BotClass)
+        {
+            UE_LOG(LogTemp, Error, TEXT("TDSSoak: failed to load character class %s"), *ClassPath);
+        }
+    }
+
+    if (!BotClass)
+    {
+        const AGameModeBase* GameMode = InWorld.GetAuthGameMode();
+        if (GameMode && GameMode->DefaultPawnClass && GameMode->DefaultPawnClass->IsChildOf(ATDSCharacter::StaticClass()))
+        {
+            BotClass = GameMode->DefaultPawnClass.Get();
+        }
+        else
+        {
+            BotClass = ATDSCharacter::StaticClass();
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("TDSSoak: %d steps, %.0f s each, class %s, output %s"),
+        BotCounts.Num(), StepSeconds, *BotClass->GetName(), *OutputPath);
+
+    BeginStep(0);
+}
+
+TStatId UTDSSoakTestSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UTDSSoakTestSubsystem, STATGROUP_Tickables);
+}
+
+void UTDSSoakTestSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (!BotCounts.IsValidIndex(CurrentStep))
+    {
+        return;
+    }
+
+    const double Now = GetWorld()->GetTimeSeconds();
+    for (FBot& Bot : Bots)
+    {
+        DriveBot(Bot, Now, DeltaTime);
+    }
+
+    const double StepTime = Now - StepStartTime;
+    if (!bSampling)
+    {
+        if (StepTime >= WarmupSeconds)
+        {
+            BeginSampling();
+        }
+        return;
+    }
+
+    // FApp учитывает сон до NetServerMaxTickRate, поэтому работа кадра = дельта минус простой
+    const double FrameSeconds = FApp::GetDeltaTime();
+    FrameMsSamples.Add(static_cast<float>(FrameSeconds * 1000.0));
+    WorkMsSamples.Add(static_cast<float>(FMath::Max(FrameSeconds - FApp::GetIdleTime(), 0.0) * 1000.0));
+
+    if (StepTime >= StepSeconds)
+    {
+        FinishStep();
+        BeginStep(CurrentStep + 1);
+    }
+}
+
+void UTDSSoakTestSubsystem::DriveBot(FBot& Bot, double Now, float DeltaTime)
+{
+    ATDSCharacter* Character = Bot.Character.Get();
+    UTDSCharacterMovementComponent* MoveComp = Character ? Character->GetTDSMovementComponent() : nullptr;
+    if (!MoveComp)
+    {
+        return;
+    }
+
+    const double BotTime = Now + Bot.PhaseOffset;
+    const int32 Phase = FMath::FloorToInt(BotTime / TDSSoak::PhaseSeconds) % PhaseCount;
+
+    const ETDSScriptedMove Move = static_cast<ETDSScriptedMove>(Phase);
+
+    if (Phase != Bot.LastPhase)
+    {
+        FinishBotPhase(Bot);
+
+        Bot.LastPhase = Phase;
+        Bot.bReachedPhase = false;
+        Bot.bPhaseSampled = bSampling;
+        Bot.bHasWallTarget = Move == ETDSScriptedMove::WallRun &&
+            TDSScriptedMovement::FindWallRunTarget(*Character, TDSSoak::WallSearchRadius, Bot.WallTarget);
+        TDSScriptedMovement::ApplyMove(*Character, Move);
+    }
+
+    // Без стены рядом бот остаётся на круге, и фаза засчитывается как не дошедшая до режима
+    if (Bot.bHasWallTarget)
+    {
+        TDSScriptedMovement::SteerAlongWall(*Character, Bot.WallTarget);
+    }
+    else
+    {
+        TDSScriptedMovement::SteerAround(*Character, Bot.Anchor, TDSSoak::PathRadius);
+    }
+
+    Bot.bReachedPhase |= TDSScriptedMovement::HasReachedMove(*Character, Move);
+
+    // Во время прогрева тоже: первый замер только запоминает значения
+    MeasureReplication(Bot, Now);
+
+    if (bSampling)
+    {
+        ++BotSamples;
+        SlideSamples += MoveComp->IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_Sliding);
+        ProneSamples += MoveComp->IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_Prone);
+        WallRunSamples += MoveComp->IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_WallRunning);
+    }
+}
+
+void UTDSSoakTestSubsystem::MeasureReplication(FBot& Bot, double Now)
+{
+    ATDSCharacter* Character = Bot.Character.Get();
+    UTDSNetProfilerSubsystem* Profiler = GetWorld()->GetSubsystem<UTDSNetProfilerSubsystem>();
+    if (!Character || !Profiler || Now < Bot.NextReplicationTime)
+    {
+        return;
+    }
+    Bot.NextReplicationTime = Now + 1.0 / FMath::Max(Character->NetUpdateFrequency, 1.0f);
+
+    // Без клиентов движок не собирает движение для отправки – то же, что делает PreReplication
+    Character->GatherCurrentMovement();
+    const bool bPlanar = Character->UpdatePlanarReplicatedMovement();
+
+    static const FName ReplicatedMovementName(TEXT("ReplicatedMovement"));
+    static const FName PlanarReplicatedMovementName(TEXT("PlanarReplicatedMovement"));
+    int64 Bits = Profiler->MeasureChangedBits(*Character, bPlanar ? ReplicatedMovementName : PlanarReplicatedMovementName);
+    if (UTDSCharacterMovementComponent* MoveComp = Character->GetTDSMovementComponent())
+    {
+        Bits += Profiler->MeasureChangedBits(*MoveComp);
+    }
+
+    if (bSampling)
+    {
+        ReplicatedBits += Bits;
+    }
+}
+
+void UTDSSoakTestSubsystem::FinishBotPhase(const FBot& Bot)
+{
+    // Фазы, начатые до замера, не учитываются
+    if (!bSampling || !Bot.bPhaseSampled)
+    {
+        return;
+    }
+
+    ++PhasesFinished[Bot.LastPhase];
+    PhasesReached[Bot.LastPhase] += Bot.bReachedPhase ? 1 : 0;
+}
+
+void UTDSSoakTestSubsystem::SpawnBots(int32 Count)
+{
+    UWorld* World = GetWorld();
+
+    FVector Origin = FVector::ZeroVector;
+    for (TActorIterator<APlayerStart> It(World); It; ++It)
+    {
+        Origin = It->GetActorLocation();
+        break;
+    }
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+    // Квадратная сетка вокруг PlayerStart
+    const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Count)));
+    while (Bots.Num() < Count)
+    {
+        const int32 Index = Bots.Num();
+        const FVector Offset(
+            (Index % GridSize - GridSize / 2) * TDSSoak::SpawnSpacing,
+            (Index / GridSize - GridSize / 2) * TDSSoak::SpawnSpacing,
+            0.0f);
+
+        ATDSCharacter* Character = World->SpawnActor<ATDSCharacter>(BotClass, Origin + Offset, FRotator::ZeroRotator, SpawnParams);
+        if (!Character)
+        {
+            UE_LOG(LogTemp, Error, TEXT("TDSSoak: failed to spawn bot %d"), Index);
+            break;
+        }
+
+        Character->SpawnDefaultController();
+
+        FBot& Bot = Bots.AddDefaulted_GetRef();
+        Bot.Character = Character;
+        Bot.Anchor = Origin + Offset + FVector(TDSSoak::PathRadius, 0.0f, 0.0f);
+        Bot.PhaseOffset = FMath::FRandRange(0.0f, TDSSoak::PhaseSeconds * PhaseCount);
+    }
+}
+
+void UTDSSoakTestSubsystem::BeginStep(int32 StepIndex)
+{
+    CurrentStep = StepIndex;
+    if (!BotCounts.IsValidIndex(CurrentStep))
+    {
+        WriteResults();
+        return;
+    }
+
+    SpawnBots(BotCounts[CurrentStep]);
+
+    StepStartTime = GetWorld()->GetTimeSeconds();
+    bSampling = false;
+
+    UE_LOG(LogTemp, Log, TEXT("TDSSoak: step %d, %d bots"), CurrentStep, Bots.Num());
+}
+
+void UTDSSoakTestSubsystem::BeginSampling()
+{
+    const FTDSPerfCounters& Counters = FTDSPerfCounters::Get();
+
+    bSampling = true;
+    WorkMsSamples.Reset();
+    FrameMsSamples.Reset();
+    SampleStartMovementCycles = Counters.MovementCycles.load(std::memory_order_relaxed);
+    SampleStartTraces = Counters.Traces.load(std::memory_order_relaxed);
+    ReplicatedBits = 0;
+    SampleStartTime = FPlatformTime::Seconds();
+    SlideSamples = 0;
+    ProneSamples = 0;
+    WallRunSamples = 0;
+    BotSamples = 0;
+
+    for (int32 Phase = 0; Phase < PhaseCount; ++Phase)
+    {
+        PhasesFinished[Phase] = 0;
+        PhasesReached[Phase] = 0;
+    }
+}
+
+void UTDSSoakTestSubsystem::FinishStep()
+{
+    const FTDSPerfCounters& Counters = FTDSPerfCounters::Get();
+
+    FStepResult& Result = Results.AddDefaulted_GetRef();
+    Result.BotCount = Bots.Num();
+    Result.Frames = WorkMsSamples.Num();
+    Result.WorkMsP50 = TDSSoak::Percentile(WorkMsSamples, 0.50f);
+    Result.WorkMsP95 = TDSSoak::Percentile(WorkMsSamples, 0.95f);
+    Result.WorkMsP99 = TDSSoak::Percentile(WorkMsSamples, 0.99f);
+    Result.FrameMsP99 = TDSSoak::Percentile(FrameMsSamples, 0.99f);
+
+    const float Frames = FMath::Max(Result.Frames, 1);
+    const uint64 MovementCycles = Counters.MovementCycles.load(std::memory_order_relaxed) - SampleStartMovementCycles;
+    Result.MovementMsPerFrame = FPlatformTime::ToMilliseconds64(MovementCycles) / Frames;
+    Result.TracesPerFrame = (Counters.Traces.load(std::memory_order_relaxed) - SampleStartTraces) / Frames;
+
+    const double Seconds = FMath::Max(FPlatformTime::Seconds() - SampleStartTime, UE_KINDA_SMALL_NUMBER);
+    Result.ReplicatedKBytesPerSecond = ReplicatedBits / 8.0 / 1024.0 / Seconds;
+
+    const double Samples = FMath::Max<int64>(BotSamples, 1);
+    Result.SlidePct = 100.0 * SlideSamples / Samples;
+    Result.PronePct = 100.0 * ProneSamples / Samples;
+    Result.WallRunPct = 100.0 * WallRunSamples / Samples;
+
+    for (int32 Phase = 0; Phase < PhaseCount; ++Phase)
+    {
+        Result.ReachedPct[Phase] = PhasesFinished[Phase] ? 100.0 * PhasesReached[Phase] / PhasesFinished[Phase] : 0.0;
+    }
+
+    bSampling = false;
+
+    UE_LOG(LogTemp, Log, TEXT("TDSSoak: N=%d work p50/p95/p99 %.2f/%.2f/%.2f ms, movement %.3f ms/frame, traces %.1f/frame, replicated %.1f KB/s"),
+        Result.BotCount, Result.WorkMsP50, Result.WorkMsP95, Result.WorkMsP99,
+        Result.MovementMsPerFrame, Result.TracesPerFrame, Result.ReplicatedKBytesPerSecond);
+}
+
+void UTDSSoakTestSubsystem::WriteResults()
+{
+    // Столбцы *ReachedPct идут в порядке ETDSScriptedMove
+    FString Csv = TEXT("Bots,Frames,WorkMsP50,WorkMsP95,WorkMsP99,FrameMsP99,MovementMsPerFrame,TracesPerFrame,ReplicatedKBytesPerSecond,SlidePct,PronePct,WallRunPct,")
+        TEXT("WalkReachedPct,RunReachedPct,SprintReachedPct,SlideReachedPct,ProneReachedPct,WallRunReachedPct\n");
+
+    bool bFailed = false;
+    for (const FStepResult& Result : Results)
+    {
+        Csv += FString::Printf(TEXT("%d,%d,%.3f,%.3f,%.3f,%.3f,%.4f,%.2f,%.2f,%.1f,%.1f,%.1f"),
+            Result.BotCount, Result.Frames, Result.WorkMsP50, Result.WorkMsP95, Result.WorkMsP99, Result.FrameMsP99,
+            Result.MovementMsPerFrame, Result.TracesPerFrame, Result.ReplicatedKBytesPerSecond,
+            Result.SlidePct, Result.PronePct, Result.WallRunPct);
+
+        for (int32 Phase = 0; Phase < PhaseCount; ++Phase)
+        {
+            Csv += FString::Printf(TEXT(",%.1f"), Result.ReachedPct[Phase]);
+
+            if (Result.ReachedPct[Phase] < TDSSoak::MinReachedPct)
+            {
+                bFailed = true;
+                UE_LOG(LogTemp, Error, TEXT("TDSSoak: N=%d, phase %d reached its movement mode in %.1f%% of runs (< %.0f%%)"),
+                    Result.BotCount, Phase, Result.ReachedPct[Phase], TDSSoak::MinReachedPct);
+            }
+        }
+        Csv += TEXT("\n");
+    }
+
+    if (FFileHelper::SaveStringToFile(Csv, *OutputPath))
+    {
+        UE_LOG(LogTemp, Log, TEXT("TDSSoak: results written to %s"), *OutputPath);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSSoak: failed to write %s"), *OutputPath);
+    }
+
+    if (bExitWhenDone)
+    {
+        FPlatformMisc::RequestExitWithStatus(false, bFailed ? 1 : 0, TEXT("TDSSoak"));
+    }
+}
@@ -0,0 +1,148 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TDSScriptedMovement.h"
+#include "TDSSoakTestSubsystem.generated.h"
+
+class ATDSCharacter;
+
+/**
+ * Нагрузочный прогон сервера ботами.
+ * Включается только ключом командной строки, например:
+ *   TopDownShooterServer MapName -nullrhi -TDSSoak=8,16,32 -TDSSoakStepSeconds=60 -TDSSoakExit
+ *
+ * На каждом шаге добирает ботов ATDSCharacter до N, гоняет их по сценарию
+ * (walk -> run -> sprint -> slide -> prone -> wall run) через UTDSCharacterMovementComponent,
+ * после прогрева снимает метрики и в конце пишет одну строку CSV на каждое N в
+ * Saved/Profiling/TDSSoak (или в файл из -TDSSoakOutput=).
+ * Для каждой фазы сценария считается доля фаз, в которых бот дошёл до её режима движения;
+ * если хоть где-то она ниже TDSSoak::MinReachedPct, прогон считается проваленным (код выхода 1).
+ *
+ * Клиентов у прогона нет, поэтому трафик оценивается по самим ботам: с частотой NetUpdateFrequency
+ * каждого бота его движение собирается как перед отправкой, а изменившиеся реплицируемые свойства
+ * персонажа и компонента движения измеряются UTDSNetProfilerSubsystem::MeasureChangedBits –
+ * ReplicatedKBytesPerSecond означает трафик к одному клиенту, видящему всех ботов. Время замера входит
+ * в работу кадра, как на сервере с клиентами в неё входила бы сама репликация.
+ *
+ * Необязательные ключи:
+ *   -TDSSoakWarmupSeconds=5       прогрев перед замером на каждом шаге
+ *   -TDSSoakCharacterClass=Path   класс бота (по умолчанию DefaultPawnClass режима, если он ATDSCharacter)
+ *   -TDSSoakExit                  завершить процесс после записи CSV
+ */
+UCLASS()
+class TOPDOWNSHOOTER_API UTDSSoakTestSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+private:
+    struct FBot
+    {
+        TWeakObjectPtr<ATDSCharacter> Character;
+
+        /** Точка, вокруг которой бот ходит по кругу */
+        FVector Anchor = FVector::ZeroVector;
+
+        /** Сдвиг фазы сценария, чтобы боты не переключались синхронно */
+        float PhaseOffset = 0.0f;
+
+        /** Время мира следующего замера репликации бота */
+        double NextReplicationTime = 0.0;
+
+        /** Фаза сценария на прошлом тике */
+        int32 LastPhase = INDEX_NONE;
+
+        /** Бот дошёл до режима текущей фазы */
+        bool bReachedPhase = false;
+
+        /** Фаза началась во время замера и учитывается в нём целиком */
+        bool bPhaseSampled = false;
+
+        /** Стена для фазы wall run; ищется при входе в фазу */
+        bool bHasWallTarget = false;
+        FTDSWallRunTarget WallTarget;
+    };
+
+    /** Все шаги ETDSScriptedMove по порядку */
+    static constexpr int32 PhaseCount = static_cast<int32>(ETDSScriptedMove::WallRun) + 1;
+
+    /** Результат одного шага N */
+    struct FStepResult
+    {
+        int32 BotCount = 0;
+        int32 Frames = 0;
+        float WorkMsP50 = 0.0f;
+        float WorkMsP95 = 0.0f;
+        float WorkMsP99 = 0.0f;
+        float FrameMsP99 = 0.0f;
+        float MovementMsPerFrame = 0.0f;
+        float TracesPerFrame = 0.0f;
+        float ReplicatedKBytesPerSecond = 0.0f;
+        float SlidePct = 0.0f;
+        float PronePct = 0.0f;
+        float WallRunPct = 0.0f;
+
+        /** Доля завершённых фаз каждого шага ETDSScriptedMove, в которых режим был достигнут */
+        float ReachedPct[PhaseCount] = {};
+    };
+
+    /** Сценарий управления ботом */
+    void DriveBot(FBot& Bot, double Now, float DeltaTime);
+
+    /** Учесть завершённую фазу бота в замере */
+    void FinishBotPhase(const FBot& Bot);
+
+    /** Добрать ботов до Count */
+    void SpawnBots(int32 Count);
+
+    /** Начать шаг с индексом StepIndex или завершить прогон */
+    void BeginStep(int32 StepIndex);
+
+    /** Начать замер после прогрева */
+    void BeginSampling();
+
+    /** Свернуть замер текущего шага в FStepResult */
+    void FinishStep();
+
+    /** Записать CSV и (если задан -TDSSoakExit) завершить процесс */
+    void WriteResults();
+
+    /** Измерить изменения реплицируемых свойств бота, если подошло его время обновления по сети */
+    void MeasureReplication(FBot& Bot, double Now);
+
+    TArray<int32> BotCounts;
+    TArray<FBot> Bots;
+    TArray<FStepResult> Results;
+
+    TSubclassOf<ATDSCharacter> BotClass;
+    FString OutputPath;
+    float StepSeconds = 30.0f;
+    float WarmupSeconds = 5.0f;
+    bool bExitWhenDone = false;
+
+    int32 CurrentStep = INDEX_NONE;
+    double StepStartTime = 0.0;
+    bool bSampling = false;
+
+    /** Данные замера текущего шага */
+    TArray<float> WorkMsSamples;
+    TArray<float> FrameMsSamples;
+    uint64 SampleStartMovementCycles = 0;
+    uint64 SampleStartTraces = 0;
+    int64 ReplicatedBits = 0;
+    double SampleStartTime = 0.0;
+    int64 SlideSamples = 0;
+    int64 ProneSamples = 0;
+    int64 WallRunSamples = 0;
+    int64 BotSamples = 0;
+    int64 PhasesFinished[PhaseCount] = {};
+    int64 PhasesReached[PhaseCount] = {};
+};
@@ -18,6 +18,11 @@ struct FCameraOffsetSettings
     float OffsetMultiplier = 1.0f;
 };
 
+/**
+ *       .
+ *   :   ATDSPlayerCameraManager     
+ *         CameraOffset/CameraLocation.
+ */
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class TOPDOWNSHOOTER_API UTDSCameraControlComponent : public UActorComponent
 {
@@ -26,12 +31,19 @@ class TOPDOWNSHOOTER_API UTDSCameraControlComponent : public UActorComponent
 public:
     UTDSCameraControlComponent();
 
+    /**
+     *  :  (,  Blueprint-)   
+     *        .
+     */
+    bool IsPresentationAllowed() const;
+
+    /**       */
+    void RefreshTickPolicy();
+
 protected:
-    virtual void BeginPlay() override;
+    virtual void RegisterComponentTickFunctions(bool bRegister) override;
 
 public:
-    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-
     /**  ,      */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera")
     float CircleRadius = 150.0f;
@@ -53,6 +65,14 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera")
     float CameraJumpLookAhead = 300.0f;
 
+    /**
+     *  CameraLocation  POV     (   ,  ).
+     *   :  Blueprint  CameraLocation   ,
+     *     .        Blueprint.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera")
+    bool bApplyOffsetToView = false;
+
     UPROPERTY(BlueprintReadOnly, Category = "Camera")
     FVector2D CameraOffset;
 
@@ -67,16 +87,4 @@ public:
     /** ,      */
     UPROPERTY(BlueprintReadOnly, Category = "Camera")
     bool bIsCharacterInAir = false;
-
-private:
-    APlayerController* PlayerController;
-    ACharacter* CharacterOwner;
-    FVector2D ScreenCenter;
-    int32 LastScreenWidth = 0;
-    int32 LastScreenHeight = 0;
-
-    void UpdateCameraOffset();
-    void UpdateCameraLocation();
-    void UpdateScreenSize();
-    float GetScreenScaleFactor();
 };
\ No newline at end of file
@@ -0,0 +1,229 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSOcclusionFadeSubsystem.h"
+#include "TDSStats.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Character.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+
+namespace TDSOcclusionFade
+{
+    static TAutoConsoleVariable<bool> CVarEnabled(
+        TEXT("TDS.OcclusionFade.Enabled"), true,
+        TEXT("Затухание геометрии между камерой и персонажем."));
+
+    static TAutoConsoleVariable<int32> CVarDataIndex(
+        TEXT("TDS.OcclusionFade.DataIndex"), 0,
+        TEXT("Индекс Custom Primitive Data, в который пишется непрозрачность."));
+
+    static TAutoConsoleVariable<float> CVarMinOpacity(
+        TEXT("TDS.OcclusionFade.MinOpacity"), 0.2f,
+        TEXT("Непрозрачность полностью затухшего примитива."));
+
+    static TAutoConsoleVariable<float> CVarFadeTime(
+        TEXT("TDS.OcclusionFade.FadeTime"), 0.2f,
+        TEXT("Время полного затухания/восстановления, сек."));
+
+    static TAutoConsoleVariable<float> CVarRestoreDelay(
+        TEXT("TDS.OcclusionFade.RestoreDelay"), 0.35f,
+        TEXT("Гистерезис: сколько секунд примитив должен не перекрывать обзор, прежде чем начнёт восстанавливаться."));
+
+    static TAutoConsoleVariable<float> CVarRadiusScale(
+        TEXT("TDS.OcclusionFade.RadiusScale"), 0.75f,
+        TEXT("Радиус sweep относительно радиуса капсулы персонажа."));
+
+    static TAutoConsoleVariable<int32> CVarMaxPrimitives(
+        TEXT("TDS.OcclusionFade.MaxPrimitives"), 32,
+        TEXT("Максимальное число одновременно затухающих примитивов."));
+}
+
+const FName UTDSOcclusionFadeSubsystem::NoFadeTag(TEXT("TDSNoOcclusionFade"));
+
+bool UTDSOcclusionFadeSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if UE_SERVER
+    return false;
+#else
+    if (!Super::ShouldCreateSubsystem(Outer))
+    {
+        return false;
+    }
+
+    // Чисто визуальная логика – на выделенном сервере не нужна
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && !IsRunningDedicatedServer();
+#endif
+}
+
+void UTDSOcclusionFadeSubsystem::Deinitialize()
+{
+    RestoreAll();
+    Super::Deinitialize();
+}
+
+TStatId UTDSOcclusionFadeSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UTDSOcclusionFadeSubsystem, STATGROUP_Tickables);
+}
+
+void UTDSOcclusionFadeSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    if (!TDSOcclusionFade::CVarEnabled.GetValueOnGameThread())
+    {
+        RestoreAll();
+        return;
+    }
+
+    const double Now = World->GetTimeSeconds();
+
+    // Один sweep на локальный вьюпорт
+    for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* PlayerController = It->Get();
+        if (PlayerController && PlayerController->IsLocalController())
+        {
+            SweepOccluders(*PlayerController, Now);
+        }
+    }
+
+    UpdateAndApplyFades(DeltaTime, Now);
+}
+
+void UTDSOcclusionFadeSubsystem::SweepOccluders(const APlayerController& PlayerController, double Now)
+{
+    const APawn* Pawn = PlayerController.GetPawn();
+    if (!Pawn || !PlayerController.PlayerCameraManager)
+    {
+        return;
+    }
+
+    float Radius = 30.0f;
+    if (const ACharacter* Character = Cast<ACharacter>(Pawn))
+    {
+        Radius = Character->GetCapsuleComponent()->GetScaledCapsuleRadius();
+    }
+    Radius *= TDSOcclusionFade::CVarRadiusScale.GetValueOnGameThread();
+
+    const FVector Start = PlayerController.PlayerCameraManager->GetCameraLocation();
+    const FVector Target = Pawn->GetActorLocation();
+
+    FVector Direction = Target - Start;
+    const float Distance = Direction.Size();
+    if (Distance <= Radius)
+    {
+        return;
+    }
+    Direction /= Distance;
+
+    // Останавливаемся перед центром капсулы, чтобы не задевать пол под персонажем
+    const FVector End = Target - Direction * Radius;
+
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TDSOcclusionFade), false);
+    QueryParams.AddIgnoredActor(Pawn);
+
+    FCollisionObjectQueryParams ObjectParams;
+    ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic);
+    ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+
+    TArray<FHitResult> Hits;
+    FTDSPerfCounters::Get().CountTrace();
+    GetWorld()->SweepMultiByObjectType(Hits, Start, End, FQuat::Identity, ObjectParams, FCollisionShape::MakeSphere(Radius), QueryParams);
+
+    for (const FHitResult& Hit : Hits)
+    {
+        UPrimitiveComponent* Primitive = Hit.GetComponent();
+        if (!Primitive || Primitive->ComponentHasTag(NoFadeTag) || Cast<APawn>(Primitive->GetOwner()))
+        {
+            continue;
+        }
+
+        MarkOccluder(Primitive, Now);
+    }
+}
+
+void UTDSOcclusionFadeSubsystem::MarkOccluder(UPrimitiveComponent* Primitive, double Now)
+{
+    // Набор маленький – линейный поиск дешевле хеш-таблицы
+    for (FFadeEntry& Entry : FadeEntries)
+    {
+        if (Entry.Primitive.Get() == Primitive)
+        {
+            Entry.LastOccludedTime = Now;
+            return;
+        }
+    }
+
+    if (FadeEntries.Num() >= TDSOcclusionFade::CVarMaxPrimitives.GetValueOnGameThread())
+    {
+        return;
+    }
+
+    FFadeEntry& NewEntry = FadeEntries.AddDefaulted_GetRef();
+    NewEntry.Primitive = Primitive;
+    NewEntry.LastOccludedTime = Now;
+}
+
+void UTDSOcclusionFadeSubsystem::UpdateAndApplyFades(float DeltaTime, double Now)
+{
+    const int32 DataIndex = TDSOcclusionFade::CVarDataIndex.GetValueOnGameThread();
+    const float MinOpacity = FMath::Clamp(TDSOcclusionFade::CVarMinOpacity.GetValueOnGameThread(), 0.0f, 1.0f);
+    const float RestoreDelay = TDSOcclusionFade::CVarRestoreDelay.GetValueOnGameThread();
+    const float FadeSpeed = (1.0f - MinOpacity) / FMath::Max(TDSOcclusionFade::CVarFadeTime.GetValueOnGameThread(), KINDA_SMALL_NUMBER);
+
+    // 1) Считаем новую прозрачность для всего набора
+    for (FFadeEntry& Entry : FadeEntries)
+    {
+        const bool bOccluding = (Now - Entry.LastOccludedTime) <= RestoreDelay;
+        const float TargetOpacity = bOccluding ? MinOpacity : 1.0f;
+        Entry.Opacity = FMath::FInterpConstantTo(Entry.Opacity, TargetOpacity, DeltaTime, FadeSpeed);
+    }
+
+    // 2) Пакетно записываем изменившиеся значения и убираем восстановленные примитивы
+    for (int32 Index = FadeEntries.Num() - 1; Index >= 0; --Index)
+    {
+        FFadeEntry& Entry = FadeEntries[Index];
+        UPrimitiveComponent* Primitive = Entry.Primitive.Get();
+        if (!Primitive)
+        {
+            FadeEntries.RemoveAtSwap(Index);
+            continue;
+        }
+
+        if (Entry.Opacity != Entry.AppliedOpacity)
+        {
+            Primitive->SetCustomPrimitiveDataFloat(DataIndex, Entry.Opacity);
+            Entry.AppliedOpacity = Entry.Opacity;
+        }
+
+        if (Entry.Opacity >= 1.0f)
+        {
+            FadeEntries.RemoveAtSwap(Index);
+        }
+    }
+}
+
+void UTDSOcclusionFadeSubsystem::RestoreAll()
+{
+    const int32 DataIndex = TDSOcclusionFade::CVarDataIndex.GetValueOnGameThread();
+
+    for (const FFadeEntry& Entry : FadeEntries)
+    {
+        if (UPrimitiveComponent* Primitive = Entry.Primitive.Get())
+        {
+            Primitive->SetCustomPrimitiveDataFloat(DataIndex, 1.0f);
+        }
+    }
+
+    FadeEntries.Reset();
+}
@@ -0,0 +1,61 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TDSOcclusionFadeSubsystem.generated.h"
+
+class APlayerController;
+class UPrimitiveComponent;
+
+/**
+ * Затухание геометрии между top-down камерой и персонажем.
+ * Один sweep от камеры к капсуле на локальный вьюпорт за кадр, небольшой набор затухающих примитивов
+ * с гистерезисом и пакетная запись прозрачности в Custom Primitive Data (материал читает индекс
+ * TDS.OcclusionFade.DataIndex). Отдельные тики на стенах не нужны.
+ */
+UCLASS()
+class TOPDOWNSHOOTER_API UTDSOcclusionFadeSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /** Тег компонента, который никогда не должен затухать */
+    static const FName NoFadeTag;
+
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+private:
+    struct FFadeEntry
+    {
+        TWeakObjectPtr<UPrimitiveComponent> Primitive;
+
+        /** Текущая непрозрачность (1 = полностью видим) */
+        float Opacity = 1.0f;
+
+        /** Время последнего попадания в sweep */
+        double LastOccludedTime = 0.0;
+
+        /** Значение, записанное в Custom Primitive Data в прошлый раз */
+        float AppliedOpacity = 1.0f;
+    };
+
+    /** Затухающие (или восстанавливающиеся) примитивы */
+    TArray<FFadeEntry> FadeEntries;
+
+    /** Sweep от камеры к персонажу одного локального игрока; отмечает найденные примитивы */
+    void SweepOccluders(const APlayerController& PlayerController, double Now);
+
+    /** Пометить примитив как перекрывающий обзор */
+    void MarkOccluder(UPrimitiveComponent* Primitive, double Now);
+
+    /** Продвинуть прозрачность к цели и пакетно записать изменения */
+    void UpdateAndApplyFades(float DeltaTime, double Now);
+
+    /** Вернуть все примитивы к полной непрозрачности */
+    void RestoreAll();
+};
@@ -0,0 +1,273 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSPlayerCameraManager.h"
+#include "TDSCameraControlComponent.h"
+#include "TDSStats.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Engine/World.h"
+
+ATDSPlayerCameraManager::ATDSPlayerCameraManager()
+{
+    CameraControl = nullptr;
+    CameraControlOwner = nullptr;
+}
+
+void ATDSPlayerCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float DeltaTime)
+{
+    // Базовый POV: камера цели обзора уже на финальной позиции текущего кадра
+    Super::UpdateViewTarget(OutVT, DeltaTime);
+
+#if !UE_SERVER
+    // Смещение нужно только для локального вьюпорта
+    if (!PCOwner || !PCOwner->IsLocalController())
+    {
+        return;
+    }
+
+    RefreshCameraControl(OutVT.Target);
+    if (CameraControl)
+    {
+        ACharacter* Character = Cast<ACharacter>(OutVT.Target);
+        UpdateCameraOffset(Character);
+        UpdateCameraLocation(Character, OutVT.POV.Rotation);
+
+        // Применяем смещение в том же кадре (как SocketOffset пружины, в пространстве камеры)
+        if (CameraControl->bApplyOffsetToView)
+        {
+            OutVT.POV.Location += OutVT.POV.Rotation.RotateVector(CameraControl->CameraLocation);
+        }
+    }
+
+    // Прямоугольник считаем только для основной цели обзора, не для цели смешивания
+    if (&OutVT == &ViewTarget)
+    {
+        UpdateViewRect(OutVT.POV, OutVT.Target);
+    }
+#endif
+}
+
+void ATDSPlayerCameraManager::UpdateViewRect(const FMinimalViewInfo& POV, const AActor* Target)
+{
+    if (!Target)
+    {
+        ViewRect = FTDSViewRect();
+        return;
+    }
+
+    int32 ScreenWidth, ScreenHeight;
+    PCOwner->GetViewportSize(ScreenWidth, ScreenHeight);
+    const float AspectRatio = (ScreenWidth > 0 && ScreenHeight > 0) ? float(ScreenWidth) / float(ScreenHeight) : POV.AspectRatio;
+
+    const FVector TargetLocation = Target->GetActorLocation();
+    const FVector TargetVelocity = Target->GetVelocity();
+
+    ViewRect.PlaneZ = TargetLocation.Z;
+    ViewRect.Velocity = FVector2D(TargetVelocity.X, TargetVelocity.Y);
+    ViewRect.Rect = FBox2D(ForceInit);
+
+    const FRotationMatrix ViewMatrix(POV.Rotation);
+    const FVector Forward = ViewMatrix.GetUnitAxis(EAxis::X);
+    const FVector Right = ViewMatrix.GetUnitAxis(EAxis::Y);
+    const FVector Up = ViewMatrix.GetUnitAxis(EAxis::Z);
+
+    // Углы вьюпорта: (-1,-1), (1,-1), (-1,1), (1,1)
+    for (int32 Corner = 0; Corner < 4; ++Corner)
+    {
+        const float SignX = (Corner & 1) ? 1.0f : -1.0f;
+        const float SignY = (Corner & 2) ? 1.0f : -1.0f;
+
+        FVector RayStart;
+        FVector RayDirection;
+        if (POV.ProjectionMode == ECameraProjectionMode::Orthographic)
+        {
+            const float HalfWidth = POV.OrthoWidth * 0.5f;
+            RayStart = POV.Location + Right * (SignX * HalfWidth) + Up * (SignY * HalfWidth / AspectRatio);
+            RayDirection = Forward;
+        }
+        else
+        {
+            const float TanHalfFOV = FMath::Tan(FMath::DegreesToRadians(POV.FOV * 0.5f));
+            RayStart = POV.Location;
+            RayDirection = (Forward + Right * (SignX * TanHalfFOV) + Up * (SignY * TanHalfFOV / AspectRatio)).GetSafeNormal();
+        }
+
+        // Пересечение с горизонтальной плоскостью персонажа; если луч уходит выше горизонта – ограничиваем дальность
+        float Distance = MaxViewRectDistance;
+        if (RayDirection.Z < -KINDA_SMALL_NUMBER)
+        {
+            Distance = FMath::Min((ViewRect.PlaneZ - RayStart.Z) / RayDirection.Z, MaxViewRectDistance);
+        }
+
+        const FVector Hit = RayStart + RayDirection * FMath::Max(Distance, 0.0f);
+        ViewRect.Rect += FVector2D(Hit.X, Hit.Y);
+    }
+}
+
+void ATDSPlayerCameraManager::RefreshCameraControl(AActor* NewViewTarget)
+{
+    if (CameraControlOwner == NewViewTarget)
+    {
+        return;
+    }
+
+    CameraControlOwner = NewViewTarget;
+    CameraControl = NewViewTarget ? NewViewTarget->FindComponentByClass<UTDSCameraControlComponent>() : nullptr;
+}
+
+void ATDSPlayerCameraManager::UpdateCameraOffset(ACharacter* Character)
+{
+    if (!PCOwner || !Character || !Character->GetCharacterMovement())
+    {
+        return;
+    }
+
+    UTDSCameraControlComponent& Settings = *CameraControl;
+
+    // Если персонаж не локально контролируется и его CharacterMovement настроен на ориентацию по движению,
+    // то камера должна оставаться в центре экрана.
+    if (!Character->IsLocallyControlled() && Character->GetCharacterMovement()->bOrientRotationToMovement)
+    {
+        Settings.CameraOffset = FVector2D::ZeroVector;
+        return;
+    }
+
+    // Определяем, находится ли персонаж в воздухе.
+    Settings.bIsCharacterInAir = Character->GetCharacterMovement()->IsFalling();
+    if (Settings.bIsCharacterInAir)
+    {
+        // При прыжке смещение будет вычислено отдельно в UpdateCameraLocation.
+        return;
+    }
+
+    int32 ScreenWidth, ScreenHeight;
+    PCOwner->GetViewportSize(ScreenWidth, ScreenHeight);
+    ScreenCenter = FVector2D(ScreenWidth * 0.5f, ScreenHeight * 0.5f);
+    const float ScaledCircleRadius = Settings.CircleRadius * GetScreenScaleFactor();
+
+    if (Character->IsLocallyControlled())
+    {
+        // Логика для локального игрока – вычисляем смещение по позиции курсора мыши.
+        float MouseX, MouseY;
+        if (!PCOwner->GetMousePosition(MouseX, MouseY)) return;
+
+        // Инвертируем Y, чтобы координаты совпадали с системой экрана.
+        const FVector2D CursorPosition(MouseX, ScreenHeight - MouseY);
+        Settings.bIsCursorInCircle = FVector2D::Distance(CursorPosition, ScreenCenter) <= ScaledCircleRadius;
+        Settings.CameraOffset = CalculateOffsetFromCursor(CursorPosition, ScaledCircleRadius);
+        return;
+    }
+
+    // --- Логика для не локальных (remote) персонажей (наблюдение) – имитируем позицию курсора через направление взгляда ---
+    const FVector PawnLocation = Character->GetActorLocation();
+
+    // Получаем угол взгляда: если контроллер есть – используем его, иначе GetBaseAimRotation.
+    const FRotator AimRotation = Character->GetController()
+        ? Character->GetController()->GetControlRotation()
+        : Character->GetBaseAimRotation();
+
+    const float TraceDistance = 1000.0f;
+    FVector TraceEnd = PawnLocation + (AimRotation.Vector() * TraceDistance);
+
+    // Выполняем трассировку, чтобы учесть препятствия.
+    FHitResult Hit;
+    FCollisionQueryParams QueryParams;
+    QueryParams.AddIgnoredActor(Character);
+    FTDSPerfCounters::Get().CountTrace();
+    if (GetWorld()->LineTraceSingleByChannel(Hit, PawnLocation, TraceEnd, ECC_Visibility, QueryParams))
+    {
+        TraceEnd = Hit.ImpactPoint;
+    }
+
+    // Проецируем полученную точку на экран.
+    FVector2D SimulatedCursorPos;
+    if (!PCOwner->ProjectWorldLocationToScreen(TraceEnd, SimulatedCursorPos))
+    {
+        Settings.CameraOffset = FVector2D::ZeroVector;
+        return;
+    }
+
+    // Приводим координаты к системе экрана (инвертируем Y).
+    SimulatedCursorPos.Y = ScreenHeight - SimulatedCursorPos.Y;
+    Settings.CameraOffset = CalculateOffsetFromCursor(SimulatedCursorPos, ScaledCircleRadius);
+}
+
+FVector2D ATDSPlayerCameraManager::CalculateOffsetFromCursor(const FVector2D& CursorPosition, float ScaledCircleRadius) const
+{
+    const UTDSCameraControlComponent& Settings = *CameraControl;
+
+    const float DistanceToCenter = FVector2D::Distance(CursorPosition, ScreenCenter);
+    if (DistanceToCenter <= ScaledCircleRadius)
+    {
+        return FVector2D::ZeroVector;
+    }
+
+    const FVector2D Direction = (CursorPosition - ScreenCenter).GetSafeNormal();
+    const float RawOffsetX = (DistanceToCenter - ScaledCircleRadius) * Direction.X;
+    const float RawOffsetY = (DistanceToCenter - ScaledCircleRadius) * Direction.Y;
+
+    const float ClampedOffsetX = FMath::Clamp(RawOffsetX, -Settings.CameraOffsetLeft.MaxOffset, Settings.CameraOffsetRight.MaxOffset);
+    const float ClampedOffsetY = FMath::Clamp(RawOffsetY, -Settings.CameraOffsetDown.MaxOffset, Settings.CameraOffsetUp.MaxOffset);
+
+    return FVector2D(
+        ClampedOffsetX * (ClampedOffsetX > 0 ? Settings.CameraOffsetRight.OffsetMultiplier : Settings.CameraOffsetLeft.OffsetMultiplier),
+        ClampedOffsetY * (ClampedOffsetY > 0 ? Settings.CameraOffsetUp.OffsetMultiplier : Settings.CameraOffsetDown.OffsetMultiplier)
+    );
+}
+
+void ATDSPlayerCameraManager::UpdateCameraLocation(ACharacter* Character, const FRotator& ViewRotation)
+{
+    if (!Character || !Character->GetCharacterMovement())
+    {
+        return;
+    }
+
+    UTDSCameraControlComponent& Settings = *CameraControl;
+
+    if (Settings.bIsCharacterInAir)
+    {
+        Settings.CameraOffset = FVector2D::ZeroVector;
+
+        // Обрабатываем смещение камеры при прыжке (поворот камеры текущего кадра)
+        const FRotator YawRotation(0, ViewRotation.Yaw, 0); // Используем только Yaw
+
+        // Скорость после движения в этом кадре
+        FVector AdjustedVelocity = Character->GetCharacterMovement()->Velocity;
+        AdjustedVelocity.Z = 0; // Исключаем Z
+
+        const FVector ForwardOffset = YawRotation.RotateVector(AdjustedVelocity.GetSafeNormal()) * -Settings.CameraJumpLookAhead;
+
+        if (-ForwardOffset.Y < 0)
+        {
+            Settings.CameraLocation = FVector(
+                -ForwardOffset.Y, // X <- Y (инверсия)
+                ForwardOffset.X,  // Y <- X
+                -ForwardOffset.Y  // Z <- Y (инверсия)
+            );
+        }
+        else
+        {
+            Settings.CameraLocation = FVector::ZeroVector;
+        }
+    }
+    else
+    {
+        // При нахождении персонажа на земле используем вычисленное CameraOffset
+        Settings.CameraLocation = FVector(
+            FMath::Clamp(Settings.CameraOffset.Y, -Settings.CameraOffsetLeft.MaxOffset, Settings.CameraOffsetRight.MaxOffset), // X
+            FMath::Clamp(Settings.CameraOffset.X, -Settings.CameraOffsetDown.MaxOffset, Settings.CameraOffsetUp.MaxOffset),   // Y
+            FMath::Clamp(Settings.CameraOffset.Y, -Settings.CameraOffsetDown.MaxOffset, Settings.CameraOffsetUp.MaxOffset)    // Z
+        );
+    }
+}
+
+float ATDSPlayerCameraManager::GetScreenScaleFactor() const
+{
+    if (!PCOwner) return 1.0f;
+
+    int32 ScreenWidth, ScreenHeight;
+    PCOwner->GetViewportSize(ScreenWidth, ScreenHeight);
+
+    return FMath::Min(float(ScreenWidth) / 1920.0f, float(ScreenHeight) / 1080.0f);
+}
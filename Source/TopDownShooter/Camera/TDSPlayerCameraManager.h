@@ -0,0 +1,84 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera/PlayerCameraManager.h"
+#include "TDSPlayerCameraManager.generated.h"
+
+class ACharacter;
+class UTDSCameraControlComponent;
+
+/** Видимый прямоугольник на плоскости персонажа (top-down), обновляется раз в кадр */
+struct FTDSViewRect
+{
+    /** Прямоугольник в мировых XY */
+    FBox2D Rect = FBox2D(ForceInit);
+
+    /** Горизонтальная скорость цели обзора в этом кадре */
+    FVector2D Velocity = FVector2D::ZeroVector;
+
+    /** Высота плоскости, на которую проецировался вьюпорт */
+    float PlaneZ = 0.0f;
+
+    bool IsValid() const { return Rect.bIsValid != 0; }
+};
+
+/**
+ * Менеджер камеры TDS.
+ * Смещение камеры по курсору и упреждение при прыжке считаются здесь один раз на локальный вьюпорт
+ * для текущей цели обзора. Настройки берутся из UTDSCameraControlComponent цели обзора,
+ * результат записывается обратно в компонент для Blueprint.
+ */
+UCLASS()
+class TOPDOWNSHOOTER_API ATDSPlayerCameraManager : public APlayerCameraManager
+{
+    GENERATED_BODY()
+
+public:
+    ATDSPlayerCameraManager();
+
+    /** Компонент настроек камеры текущей цели обзора */
+    UFUNCTION(BlueprintPure, Category = "Camera")
+    UTDSCameraControlComponent* GetCameraControl() const { return CameraControl; }
+
+    /** Видимый прямоугольник последнего кадра (невалиден, пока камера не обновлялась) */
+    const FTDSViewRect& GetViewRect() const { return ViewRect; }
+
+    /** Максимальная дальность проекции луча вьюпорта, если он не пересекает плоскость персонажа */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Camera|Streaming")
+    float MaxViewRectDistance = 10000.0f;
+
+protected:
+    /**
+     * Смещение считается после базового расчёта POV цели обзора, то есть по финальной позиции
+     * и скорости персонажа в текущем кадре, и сразу применяется к POV.
+     */
+    virtual void UpdateViewTarget(FTViewTarget& OutVT, float DeltaTime) override;
+
+private:
+    /** Кэш компонента настроек для текущей цели обзора */
+    UPROPERTY(Transient)
+    TObjectPtr<UTDSCameraControlComponent> CameraControl;
+
+    UPROPERTY(Transient)
+    TObjectPtr<AActor> CameraControlOwner;
+
+    FVector2D ScreenCenter = FVector2D::ZeroVector;
+
+    FTDSViewRect ViewRect;
+
+    /** Спроецировать углы вьюпорта на плоскость цели обзора */
+    void UpdateViewRect(const FMinimalViewInfo& POV, const AActor* Target);
+
+    /** Обновить кэш компонента при смене цели обзора */
+    void RefreshCameraControl(AActor* NewViewTarget);
+
+    void UpdateCameraOffset(ACharacter* Character);
+    void UpdateCameraLocation(ACharacter* Character, const FRotator& ViewRotation);
+
+    /** Смещение камеры по позиции курсора (реального или имитированного) на экране */
+    FVector2D CalculateOffsetFromCursor(const FVector2D& CursorPosition, float ScaledCircleRadius) const;
+
+    float GetScreenScaleFactor() const;
+};
@@ -2,6 +2,10 @@
 
 #include "TDSCharacter.h"
 #include "TDSCharacterMovementComponent.h"
+#include "TDSCameraControlComponent.h"
+#include "TDSLagCompensationComponent.h"
+#include "TDSJoinReplicationSubsystem.h"
+#include "TDSLockstepSubsystem.h"
 #include "Net/UnrealNetwork.h"
 #include "Components/InputComponent.h"
 #include "GameFramework/InputSettings.h"
@@ -18,6 +22,8 @@ ATDSCharacter::ATDSCharacter(const FObjectInitializer& ObjectInitializer)
     // Настройки для мультиплеера
     bReplicates = true;
     SetReplicateMovement(true);
+
+    LagCompensation = CreateDefaultSubobject<UTDSLagCompensationComponent>(TEXT("LagCompensation"));
 }
 
 void ATDSCharacter::BeginPlay()
@@ -28,6 +34,21 @@ void ATDSCharacter::BeginPlay()
 void ATDSCharacter::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
+
+    if (PendingMovementStateMask != 0)
+    {
+        FlushMovementStateChanges();
+    }
+}
+
+void ATDSCharacter::NotifyControllerChanged()
+{
+    Super::NotifyControllerChanged();
+
+    if (UTDSCameraControlComponent* CameraControl = FindComponentByClass<UTDSCameraControlComponent>())
+    {
+        CameraControl->RefreshTickPolicy();
+    }
 }
 
 void ATDSCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -63,6 +84,148 @@ UTDSCharacterMovementComponent* ATDSCharacter::GetTDSMovementComponent() const
     return Cast<UTDSCharacterMovementComponent>(GetCharacterMovement());
 }
 
+#pragma region Projectiles
+
+namespace TDSCharacterProjectiles
+{
+    /** Допуск на расхождение точки вылета клиента с позицией персонажа на сервере, см */
+    static constexpr float MuzzleTolerance = 150.0f;
+
+    /** Сколько выстрелов сверх темпа принимается пачкой: RPC нескольких кадров клиента могут прийти в одном кадре сервера */
+    static constexpr int32 FireBurstShots = 2;
+}
+
+FTDSProjectileSpawn ATDSCharacter::MakeProjectileSpawn() const
+{
+    // Прицел по курсору задаёт ControlRotation; вертикаль убираем – стрельба в плоскости карты
+    FVector Direction = GetControlRotation().Vector();
+    Direction.Z = 0.0f;
+    if (!Direction.Normalize())
+    {
+        Direction = GetActorForwardVector();
+    }
+
+    FTDSProjectileSpawn SpawnEvent;
+    SpawnEvent.Origin = GetActorLocation() + Direction * MuzzleDistance;
+    SpawnEvent.Direction = Direction;
+    return SpawnEvent;
+}
+
+bool ATDSCharacter::ConsumeFireInterval(int32 BurstShots)
+{
+    const double Now = GetWorld()->GetTimeSeconds();
+    const double Interval = ProjectileParams.FireInterval;
+
+    // Запас больше BurstShots выстрелов за время простоя не копится
+    NextFireTime = FMath::Max(NextFireTime, Now - Interval * BurstShots);
+    if (NextFireTime > Now)
+    {
+        return false;
+    }
+
+    NextFireTime += Interval;
+    return true;
+}
+
+void ATDSCharacter::FireProjectile()
+{
+    UTDSProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UTDSProjectileSubsystem>();
+    if (!Projectiles || !ConsumeFireInterval(0))
+    {
+        return;
+    }
+
+    const FTDSProjectileSpawn SpawnEvent = MakeProjectileSpawn();
+    if (HasAuthority())
+    {
+        Projectiles->Spawn(this, SpawnEvent.Origin, SpawnEvent.Direction, ProjectileParams, true);
+        MulticastProjectileSpawned(SpawnEvent);
+    }
+    else if (IsLocallyControlled())
+    {
+        // Визуальный снаряд без ожидания сервера
+        Projectiles->Spawn(this, SpawnEvent.Origin, SpawnEvent.Direction, ProjectileParams, false);
+        ServerFireProjectile(SpawnEvent);
+    }
+}
+
+void ATDSCharacter::ServerFireProjectile_Implementation(FTDSProjectileSpawn SpawnEvent)
+{
+    UTDSProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UTDSProjectileSubsystem>();
+    if (!Projectiles)
+    {
+        return;
+    }
+
+    // Темп стрельбы проверяет сервер: клиент может слать RPC чаще, чем позволяет FireInterval
+    if (!ConsumeFireInterval(TDSCharacterProjectiles::FireBurstShots))
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("TDS: %s fires faster than %.3f s, shot rejected"), *GetName(), ProjectileParams.FireInterval);
+        return;
+    }
+
+    // Точку вылета клиента принимаем только рядом с серверной позицией персонажа
+    if (FVector::DistSquared(SpawnEvent.Origin, GetActorLocation()) > FMath::Square(MuzzleDistance + TDSCharacterProjectiles::MuzzleTolerance))
+    {
+        SpawnEvent.Origin = MakeProjectileSpawn().Origin;
+    }
+
+    Projectiles->Spawn(this, SpawnEvent.Origin, SpawnEvent.Direction, ProjectileParams, true);
+    MulticastProjectileSpawned(SpawnEvent);
+}
+
+void ATDSCharacter::MulticastProjectileSpawned_Implementation(FTDSProjectileSpawn SpawnEvent)
+{
+    // Сервер уже запустил авторитетный снаряд, владелец – предсказанный
+    if (HasAuthority() || IsLocallyControlled())
+    {
+        return;
+    }
+
+    if (UTDSProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UTDSProjectileSubsystem>())
+    {
+        Projectiles->Spawn(this, SpawnEvent.Origin, SpawnEvent.Direction, ProjectileParams, false);
+    }
+}
+
+#pragma endregion
+
+#pragma region Lockstep
+
+void ATDSCharacter::ServerLockstepInput_Implementation(int32 Tick, FTDSLockstepInput Input)
+{
+    if (UTDSLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UTDSLockstepSubsystem>())
+    {
+        Lockstep->ReceiveInput(*this, Tick, Input);
+    }
+}
+
+void ATDSCharacter::ServerLockstepHash_Implementation(int32 Tick, uint32 Hash)
+{
+    if (UTDSLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UTDSLockstepSubsystem>())
+    {
+        Lockstep->ReceiveHash(*this, Tick, Hash);
+    }
+}
+
+void ATDSCharacter::ClientLockstepFrame_Implementation(const FTDSLockstepFrame& Frame)
+{
+    if (UTDSLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UTDSLockstepSubsystem>())
+    {
+        Lockstep->ReceiveFrame(Frame);
+    }
+}
+
+void ATDSCharacter::ClientLockstepSnapshot_Implementation(const FTDSLockstepSnapshot& Snapshot)
+{
+    if (UTDSLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UTDSLockstepSubsystem>())
+    {
+        Lockstep->ReceiveSnapshot(Snapshot);
+    }
+}
+
+#pragma endregion
+
 #pragma region Basic Movement States
 
 void ATDSCharacter::SetWalking(bool NewWalk, bool bClientSimulation)
@@ -73,8 +236,8 @@ void ATDSCharacter::SetWalking(bool NewWalk, bool bClientSimulation)
     }
     bIsWalkingState = NewWalk;
     
-    // Уведомляем Blueprint о изменении состояния
-    OnMovementStateChanged(bIsWalkingState, bIsSprintingState, bIsStrafingState, bIsAimingState);
+    // Уведомляем подписчиков один раз за кадр
+    MarkMovementStateDirty(FTDSMovementState::Walk);
 }
 
 void ATDSCharacter::SetSprinting(bool NewSprint, bool bClientSimulation)
@@ -85,7 +248,7 @@ void ATDSCharacter::SetSprinting(bool NewSprint, bool bClientSimulation)
     }
     bIsSprintingState = NewSprint;
     
-    OnMovementStateChanged(bIsWalkingState, bIsSprintingState, bIsStrafingState, bIsAimingState);
+    MarkMovementStateDirty(FTDSMovementState::Sprint);
 }
 
 void ATDSCharacter::SetStrafing(bool NewStrafe, bool bClientSimulation)
@@ -96,7 +259,7 @@ void ATDSCharacter::SetStrafing(bool NewStrafe, bool bClientSimulation)
     }
     bIsStrafingState = NewStrafe;
     
-    OnMovementStateChanged(bIsWalkingState, bIsSprintingState, bIsStrafingState, bIsAimingState);
+    MarkMovementStateDirty(FTDSMovementState::Strafe);
 }
 
 void ATDSCharacter::SetAiming(bool NewAim, bool bClientSimulation)
@@ -107,7 +270,42 @@ void ATDSCharacter::SetAiming(bool NewAim, bool bClientSimulation)
     }
     bIsAimingState = NewAim;
     
-    OnMovementStateChanged(bIsWalkingState, bIsSprintingState, bIsStrafingState, bIsAimingState);
+    MarkMovementStateDirty(FTDSMovementState::Aim);
+}
+
+FTDSMovementState ATDSCharacter::GetMovementState() const
+{
+    FTDSMovementState State;
+    State.bWalk = bIsWalkingState;
+    State.bSprint = bIsSprintingState;
+    State.bStrafe = bIsStrafingState;
+    State.bAim = bIsAimingState;
+    return State;
+}
+
+void ATDSCharacter::MarkMovementStateDirty(uint8 Bits)
+{
+    PendingMovementStateMask |= Bits;
+}
+
+void ATDSCharacter::FlushMovementStateChanges()
+{
+    // Сравниваются все биты: OldState и NewState в событии расходятся ровно в ChangedMask
+    const FTDSMovementState NewState = GetMovementState();
+    const uint8 ChangedMask = NewState.ToMask() ^ DeliveredMovementState.ToMask();
+    PendingMovementStateMask = 0;
+
+    // Бит мог переключиться туда и обратно за один кадр – тогда сообщать не о чем
+    if (ChangedMask == 0)
+    {
+        return;
+    }
+
+    const FTDSMovementState OldState = DeliveredMovementState;
+    DeliveredMovementState = NewState;
+
+    MovementStateChanged.Broadcast(this, OldState, NewState, ChangedMask);
+    OnMovementStateChanged(OldState, NewState);
 }
 
 #pragma endregion
@@ -121,7 +319,7 @@ void ATDSCharacter::OnRep_IsWalkingState()
         TDSMovement->SetWalking(bIsWalkingState, true);
         TDSMovement->bNetworkUpdateReceived = true;
     }
-    OnMovementStateChanged(bIsWalkingState, bIsSprintingState, bIsStrafingState, bIsAimingState);
+    MarkMovementStateDirty(FTDSMovementState::Walk);
 }
 
 void ATDSCharacter::OnRep_IsSprintingState()
@@ -131,7 +329,7 @@ void ATDSCharacter::OnRep_IsSprintingState()
         TDSMovement->SetSprinting(bIsSprintingState, true);
         TDSMovement->bNetworkUpdateReceived = true;
     }
-    OnMovementStateChanged(bIsWalkingState, bIsSprintingState, bIsStrafingState, bIsAimingState);
+    MarkMovementStateDirty(FTDSMovementState::Sprint);
 }
 
 void ATDSCharacter::OnRep_IsStrafingState()
@@ -141,7 +339,7 @@ void ATDSCharacter::OnRep_IsStrafingState()
         TDSMovement->SetStrafing(bIsStrafingState, true);
         TDSMovement->bNetworkUpdateReceived = true;
     }
-    OnMovementStateChanged(bIsWalkingState, bIsSprintingState, bIsStrafingState, bIsAimingState);
+    MarkMovementStateDirty(FTDSMovementState::Strafe);
 }
 
 void ATDSCharacter::OnRep_IsAimingState()
@@ -151,7 +349,7 @@ void ATDSCharacter::OnRep_IsAimingState()
         TDSMovement->SetAiming(bIsAimingState, true);
         TDSMovement->bNetworkUpdateReceived = true;
     }
-    OnMovementStateChanged(bIsWalkingState, bIsSprintingState, bIsStrafingState, bIsAimingState);
+    MarkMovementStateDirty(FTDSMovementState::Aim);
 }
 
 #pragma endregion
@@ -267,50 +465,91 @@ ETDSCustomMovementMode ATDSCharacter::GetCurrentCustomMovementMode() const
 
 #pragma region Input Handling
 
+bool ATDSCharacter::RouteLockstepButton(uint8 Button, bool bDown)
+{
+    UTDSCharacterMovementComponent* TDSMovement = GetTDSMovementComponent();
+    if (!TDSMovement || !TDSMovement->IsLockstepDriven())
+    {
+        return false;
+    }
+
+    TDSMovement->SetLockstepButton(Button, bDown);
+    return true;
+}
+
 // Основные движения
 void ATDSCharacter::OnWalkPressed()
 {
-    SetWalking(true);
+    if (!RouteLockstepButton(FTDSLockstepInput::Walk, true))
+    {
+        SetWalking(true);
+    }
 }
 
 void ATDSCharacter::OnWalkReleased()
 {
-    SetWalking(false);
+    if (!RouteLockstepButton(FTDSLockstepInput::Walk, false))
+    {
+        SetWalking(false);
+    }
 }
 
 void ATDSCharacter::OnSprintPressed()
 {
-    SetSprinting(true);
+    if (!RouteLockstepButton(FTDSLockstepInput::Sprint, true))
+    {
+        SetSprinting(true);
+    }
 }
 
 void ATDSCharacter::OnSprintReleased()
 {
-    SetSprinting(false);
+    if (!RouteLockstepButton(FTDSLockstepInput::Sprint, false))
+    {
+        SetSprinting(false);
+    }
 }
 
 void ATDSCharacter::OnStrafePressed()
 {
-    SetStrafing(true);
+    if (!RouteLockstepButton(FTDSLockstepInput::Strafe, true))
+    {
+        SetStrafing(true);
+    }
 }
 
 void ATDSCharacter::OnStrafeReleased()
 {
-    SetStrafing(false);
+    if (!RouteLockstepButton(FTDSLockstepInput::Strafe, false))
+    {
+        SetStrafing(false);
+    }
 }
 
 void ATDSCharacter::OnAimPressed()
 {
-    SetAiming(true);
+    if (!RouteLockstepButton(FTDSLockstepInput::Aim, true))
+    {
+        SetAiming(true);
+    }
 }
 
 void ATDSCharacter::OnAimReleased()
 {
-    SetAiming(false);
+    if (!RouteLockstepButton(FTDSLockstepInput::Aim, false))
+    {
+        SetAiming(false);
+    }
 }
 
 // Кастомные движения
 void ATDSCharacter::OnWallRunPressed()
 {
+    if (RouteLockstepButton(FTDSLockstepInput::WallRun, true))
+    {
+        return;
+    }
+
     if (UTDSCharacterMovementComponent* TDSMovement = GetTDSMovementComponent())
     {
         TDSMovement->SetWallRunInput(true);
@@ -319,6 +558,11 @@ void ATDSCharacter::OnWallRunPressed()
 
 void ATDSCharacter::OnWallRunReleased()
 {
+    if (RouteLockstepButton(FTDSLockstepInput::WallRun, false))
+    {
+        return;
+    }
+
     if (UTDSCharacterMovementComponent* TDSMovement = GetTDSMovementComponent())
     {
         TDSMovement->SetWallRunInput(false);
@@ -327,6 +571,11 @@ void ATDSCharacter::OnWallRunReleased()
 
 void ATDSCharacter::OnSlidePressed()
 {
+    if (RouteLockstepButton(FTDSLockstepInput::Slide, true))
+    {
+        return;
+    }
+
     if (UTDSCharacterMovementComponent* TDSMovement = GetTDSMovementComponent())
     {
         TDSMovement->SetSlideInput(true);
@@ -335,6 +584,11 @@ void ATDSCharacter::OnSlidePressed()
 
 void ATDSCharacter::OnSlideReleased()
 {
+    if (RouteLockstepButton(FTDSLockstepInput::Slide, false))
+    {
+        return;
+    }
+
     if (UTDSCharacterMovementComponent* TDSMovement = GetTDSMovementComponent())
     {
         TDSMovement->SetSlideInput(false);
@@ -343,6 +597,11 @@ void ATDSCharacter::OnSlideReleased()
 
 void ATDSCharacter::OnPronePressed()
 {
+    if (RouteLockstepButton(FTDSLockstepInput::Prone, true))
+    {
+        return;
+    }
+
     if (UTDSCharacterMovementComponent* TDSMovement = GetTDSMovementComponent())
     {
         TDSMovement->SetProneInput(true);
@@ -351,6 +610,11 @@ void ATDSCharacter::OnPronePressed()
 
 void ATDSCharacter::OnProneReleased()
 {
+    if (RouteLockstepButton(FTDSLockstepInput::Prone, false))
+    {
+        return;
+    }
+
     if (UTDSCharacterMovementComponent* TDSMovement = GetTDSMovementComponent())
     {
         TDSMovement->SetProneInput(false);
@@ -368,4 +632,52 @@ void ATDSCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLif
     DOREPLIFETIME_CONDITION(ATDSCharacter, bIsSprintingState, COND_SkipOwner);
     DOREPLIFETIME_CONDITION(ATDSCharacter, bIsStrafingState, COND_SkipOwner);
     DOREPLIFETIME_CONDITION(ATDSCharacter, bIsAimingState, COND_SkipOwner);
+
+    // Движение для прокси в формате 2.5D (включается в PreReplication)
+    DOREPLIFETIME_CONDITION(ATDSCharacter, PlanarReplicatedMovement, COND_SimulatedOnly);
+}
+
+void ATDSCharacter::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+    // Super собирает ReplicatedMovement (GatherCurrentMovement) – сжатый формат строится из него
+    Super::PreReplication(ChangedPropertyTracker);
+
+    const bool bPlanar = UpdatePlanarReplicatedMovement();
+    if (bPlanar)
+    {
+        DOREPLIFETIME_ACTIVE_OVERRIDE_FAST(AActor, ReplicatedMovement, false);
+    }
+    DOREPLIFETIME_ACTIVE_OVERRIDE_FAST(ATDSCharacter, PlanarReplicatedMovement, bPlanar);
+}
+
+bool ATDSCharacter::UpdatePlanarReplicatedMovement()
+{
+    const UTDSCharacterMovementComponent* TDSMovement = GetTDSMovementComponent();
+    const bool bPlanar = TDSMovement && TDSMovement->UsesPlanarMovementCompression() && IsReplicatingMovement()
+        && !GetReplicatedMovement().bRepPhysics;
+
+    if (bPlanar)
+    {
+        PlanarReplicatedMovement.FromRepMovement(GetReplicatedMovement(), TDSMovement->IsMovingOnGround(),
+            TDSMovementCompression::GetLevelOrigin(GetWorld()));
+    }
+    return bPlanar;
+}
+
+bool ATDSCharacter::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+    const UTDSJoinReplicationSubsystem* JoinReplication = GetWorld()->GetSubsystem<UTDSJoinReplicationSubsystem>();
+    if (JoinReplication && !JoinReplication->IsAdmitted(*this, RealViewer))
+    {
+        return false;
+    }
+
+    return Super::IsNetRelevantFor(RealViewer, ViewTarget, SrcLocation);
+}
+
+void ATDSCharacter::OnRep_PlanarReplicatedMovement()
+{
+    // Дальше – обычный путь движка: PostNetReceiveVelocity, PostNetReceiveLocationAndRotation, сглаживание CMC
+    PlanarReplicatedMovement.ToRepMovement(GetReplicatedMovement_Mutable(), TDSMovementCompression::GetLevelOrigin(GetWorld()));
+    OnRep_ReplicatedMovement();
 }
@@ -5,11 +5,53 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "TDSCharacterMovementComponent.h"
+#include "TDSProjectileSubsystem.h"
+#include "TDSMovementCompression.h"
+#include "TDSLockstep.h"
 #include "InputAction.h"
 #include "InputMappingContext.h"
 #include "TDSCharacter.generated.h"
 
 class UTDSCharacterMovementComponent;
+class UTDSLagCompensationComponent;
+class ATDSCharacter;
+
+/** Основные состояния движения персонажа – для события их смены */
+USTRUCT(BlueprintType)
+struct FTDSMovementState
+{
+    GENERATED_BODY()
+
+    /** Биты маски изменений */
+    enum EBits : uint8
+    {
+        Walk   = 1 << 0,
+        Sprint = 1 << 1,
+        Strafe = 1 << 2,
+        Aim    = 1 << 3,
+    };
+
+    UPROPERTY(BlueprintReadOnly, Category="TDS Character")
+    bool bWalk = false;
+
+    UPROPERTY(BlueprintReadOnly, Category="TDS Character")
+    bool bSprint = false;
+
+    UPROPERTY(BlueprintReadOnly, Category="TDS Character")
+    bool bStrafe = false;
+
+    UPROPERTY(BlueprintReadOnly, Category="TDS Character")
+    bool bAim = false;
+
+    uint8 ToMask() const
+    {
+        return (bWalk ? Walk : 0) | (bSprint ? Sprint : 0) | (bStrafe ? Strafe : 0) | (bAim ? Aim : 0);
+    }
+};
+
+/** Смена состояний движения, не чаще раза в кадр; ChangedMask – биты FTDSMovementState::EBits */
+DECLARE_MULTICAST_DELEGATE_FourParams(FTDSOnMovementStateChanged, ATDSCharacter* /*Character*/,
+    const FTDSMovementState& /*OldState*/, const FTDSMovementState& /*NewState*/, uint8 /*ChangedMask*/);
 
 UCLASS()
 class TOPDOWNSHOOTER_API ATDSCharacter : public ACharacter
@@ -59,6 +101,28 @@ public:
 
     UFUNCTION(BlueprintCallable, Category="TDS Character", meta=(HidePin="bClientSimulation"))
     void SetAiming(bool NewAim, bool bClientSimulation = false);
+
+    /** Текущие состояния движения одной структурой */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="TDS Character")
+    FTDSMovementState GetMovementState() const;
+
+    /** Нативная подписка на смену состояний (вызывается вместе с OnMovementStateChanged) */
+    FTDSOnMovementStateChanged MovementStateChanged;
+
+    /** Биты FTDSMovementState::EBits, изменённые в обход SetWalking/...: доставить в ближайшем Tick */
+    void MarkMovementStateDirty(uint8 Bits);
+
+private:
+    /**
+     * Смены состояний за кадр копятся в маске и доставляются одним вызовом из Tick:
+     * сетевое обновление, изменившее три бита, запускает Blueprint один раз, а не три.
+     */
+    uint8 PendingMovementStateMask = 0;
+
+    /** Состояние, о котором подписчики уже знают */
+    FTDSMovementState DeliveredMovementState;
+
+    void FlushMovementStateChanges();
 #pragma endregion
 
 #pragma region Custom Movement Controls
@@ -100,11 +164,18 @@ public:
 public:
     virtual void Tick(float DeltaTime) override;
 
+    /** Смена контроллера меняет локальность пешки – обновляем политику камерных компонентов */
+    virtual void NotifyControllerChanged() override;
+
     /** Доступ к кастомному компоненту движения */
     UFUNCTION(BlueprintCallable, Category="TDS Movement")
     UTDSCharacterMovementComponent* GetTDSMovementComponent() const;
     
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+    virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+    /** Подключающимся к идущему матчу персонажи открываются по очереди, см. UTDSJoinReplicationSubsystem */
+    virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
 
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input")
     UInputMappingContext* InputMappingContext;
@@ -120,6 +191,93 @@ protected:
     virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 #pragma endregion
 
+#pragma region Movement Compression
+public:
+    /**
+     * Перенести собранный ReplicatedMovement в PlanarReplicatedMovement, если движение идёт в сжатом формате.
+     * Вызывается из PreReplication; замеры без клиентов зовут её после GatherCurrentMovement.
+     * @return true – реплицируется PlanarReplicatedMovement, а не ReplicatedMovement
+     */
+    bool UpdatePlanarReplicatedMovement();
+
+private:
+    /**
+     * ReplicatedMovement в формате 2.5D для симулируемых прокси (UTDSCharacterMovementComponent::UsesPlanarMovementCompression).
+     * Пока сжатие включено, ReplicatedMovement актора не реплицируется, прокси получают движение отсюда.
+     */
+    UPROPERTY(ReplicatedUsing=OnRep_PlanarReplicatedMovement)
+    FTDSRepMovement PlanarReplicatedMovement;
+
+    UFUNCTION()
+    void OnRep_PlanarReplicatedMovement();
+#pragma endregion
+
+#pragma region Lag Compensation
+public:
+    /** История поз капсулы для серверной проверки попаданий */
+    UFUNCTION(BlueprintCallable, Category="TDS Character")
+    UTDSLagCompensationComponent* GetLagCompensation() const { return LagCompensation; }
+
+private:
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="TDS Character", meta=(AllowPrivateAccess="true"))
+    TObjectPtr<UTDSLagCompensationComponent> LagCompensation;
+#pragma endregion
+
+#pragma region Projectiles
+public:
+    /**
+     * Выстрел по направлению прицела (ControlRotation из ATDSPlayerController::UpdateControlRotation).
+     * Владелец сразу запускает визуальный снаряд, сервер – авторитетный и рассылает событие остальным.
+     */
+    UFUNCTION(BlueprintCallable, Category="TDS Combat")
+    void FireProjectile();
+
+    /** Баллистика снарядов персонажа */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="TDS Combat")
+    FTDSProjectileParams ProjectileParams;
+
+    /** Расстояние от центра капсулы до точки вылета снаряда */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="TDS Combat", meta=(ClampMin="0.0"))
+    float MuzzleDistance = 60.0f;
+
+protected:
+    UFUNCTION(Server, Unreliable)
+    void ServerFireProjectile(FTDSProjectileSpawn SpawnEvent);
+
+    UFUNCTION(NetMulticast, Unreliable)
+    void MulticastProjectileSpawned(FTDSProjectileSpawn SpawnEvent);
+
+private:
+    /** Точка вылета и направление по текущему прицелу */
+    FTDSProjectileSpawn MakeProjectileSpawn() const;
+
+    /**
+     * Прошёл ли ProjectileParams.FireInterval с прошлого выстрела; true – выстрел засчитан.
+     * @param BurstShots  сколько выстрелов сверх темпа можно сделать подряд после паузы
+     */
+    bool ConsumeFireInterval(int32 BurstShots);
+
+    /** Время мира, раньше которого следующий выстрел не принимается */
+    double NextFireTime = 0.0;
+#pragma endregion
+
+#pragma region Lockstep
+public:
+    /** Сообщения UTDSLockstepSubsystem: ввод и хэш идут от владельца, кадры и снимки – владельцу */
+    UFUNCTION(Server, Unreliable)
+    void ServerLockstepInput(int32 Tick, FTDSLockstepInput Input);
+
+    UFUNCTION(Server, Unreliable)
+    void ServerLockstepHash(int32 Tick, uint32 Hash);
+
+    /** Надёжные и в одном канале: снимок и кадры приходят в порядке отправки */
+    UFUNCTION(Client, Reliable)
+    void ClientLockstepFrame(const FTDSLockstepFrame& Frame);
+
+    UFUNCTION(Client, Reliable)
+    void ClientLockstepSnapshot(const FTDSLockstepSnapshot& Snapshot);
+#pragma endregion
+
 #pragma region Input Handling
 protected:
     /** Input Actions для различных типов движения */
@@ -167,13 +325,21 @@ protected:
     
     UFUNCTION(BlueprintCallable, Category="TDS Input")
     void OnProneReleased();
+
+private:
+    /**
+     * Под lockstep кнопка только попадает во ввод шага, состояние сменится в SimulateLockstepTick.
+     * Иначе оно переключилось бы сразу, затем обратно запоздавшим вводом и снова своим – с событиями на каждое.
+     * @return true – ввод забрал lockstep
+     */
+    bool RouteLockstepButton(uint8 Button, bool bDown);
 #pragma endregion
 
 #pragma region Blueprint Events
 protected:
-    /** События для Blueprint */
+    /** События для Blueprint; смена состояний движения приходит не чаще раза в кадр */
     UFUNCTION(BlueprintImplementableEvent, Category="TDS Character")
-    void OnMovementStateChanged(bool bWalk, bool bSprint, bool bStrafe, bool bAim);
+    void OnMovementStateChanged(const FTDSMovementState& OldState, const FTDSMovementState& NewState);
 
     UFUNCTION(BlueprintImplementableEvent, Category="TDS Character")
     void OnCustomMovementStarted(ETDSCustomMovementMode MovementMode);
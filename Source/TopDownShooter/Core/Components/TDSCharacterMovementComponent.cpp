@@ -2,6 +2,10 @@
 
 #include "TDSCharacterMovementComponent.h"
 #include "TDSCharacter.h"
+#include "TDSStats.h"
+#include "TDSServerGovernorSubsystem.h"
+#include "TDSMovementCompression.h"
+#include "TDSLockstep.h"
 #include "GameFramework/Character.h"
 #include "GameFramework/PlayerController.h"
 #include "Components/CapsuleComponent.h"
@@ -13,6 +17,53 @@
 #include "KismetAnimationLibrary.h"
 #include "Kismet/KismetMathLibrary.h"
 
+namespace TDSNetTier
+{
+    static TAutoConsoleVariable<bool> CVarEnabled(
+        TEXT("TDS.NetTier.Enabled"), true,
+        TEXT("Выбирать NetUpdateFrequency персонажа по состоянию движения."));
+
+    static TAutoConsoleVariable<float> CVarNormalHz(
+        TEXT("TDS.NetTier.NormalHz"), 30.0f,
+        TEXT("Частота обновлений при ходьбе/беге, Гц (Fast – исходная частота актора)."));
+
+    static TAutoConsoleVariable<float> CVarIdleHz(
+        TEXT("TDS.NetTier.IdleHz"), 10.0f,
+        TEXT("Частота обновлений стоящего персонажа, Гц."));
+
+    static TAutoConsoleVariable<float> CVarDormantHz(
+        TEXT("TDS.NetTier.DormantHz"), 2.0f,
+        TEXT("Частота обновлений персонажа, который стоит или лежит дольше DormantSeconds, Гц."));
+
+    static TAutoConsoleVariable<float> CVarDormantSeconds(
+        TEXT("TDS.NetTier.DormantSeconds"), 2.0f,
+        TEXT("Сколько секунд персонаж должен стоять, чтобы перейти в Dormant."));
+
+    static TAutoConsoleVariable<float> CVarIdleSpeed(
+        TEXT("TDS.NetTier.IdleSpeed"), 10.0f,
+        TEXT("Скорость, ниже которой персонаж считается стоящим, см/с."));
+
+    static TAutoConsoleVariable<float> CVarAimDegrees(
+        TEXT("TDS.NetTier.AimDegrees"), 5.0f,
+        TEXT("Поворот прицела между оценками, после которого персонаж на AimHoldSeconds переходит в Fast."));
+
+    static TAutoConsoleVariable<float> CVarAimHoldSeconds(
+        TEXT("TDS.NetTier.AimHoldSeconds"), 0.5f,
+        TEXT("Сколько держать Fast после поворота прицела, сек."));
+
+    /** Период переоценки ступени, сек */
+    static constexpr float EvaluateInterval = 0.1f;
+}
+
+namespace TDSGait
+{
+    /** Скорость, ниже которой прокси считается без ввода движения, см/с */
+    static constexpr float DeriveMinSpeed = 10.0f;
+
+    /** Режимы Walk/Run: полный ввод, если скорость выше максимальной скорости Walk с этим запасом */
+    static constexpr float DeriveFullInputMargin = 1.05f;
+}
+
 //////////////////////////////////////////////////////////////////////////
 // UTDSCharacterMovementComponent
 
@@ -28,6 +79,9 @@ UTDSCharacterMovementComponent::UTDSCharacterMovementComponent()
     ProneKeysDown = 0;
     bNetworkUpdateReceived = 0;
 
+    // Ходы клиента сериализуются своими данными (см. FTDSCharacterNetworkMoveData)
+    SetNetworkMoveDataContainer(PlanarMoveDataContainer);
+
     // Инициализация Wall Running
     WallRunDirection = FVector::ZeroVector;
     WallRunSide = ETDSWallRunSide::Left;
@@ -59,6 +113,29 @@ void UTDSCharacterMovementComponent::BeginPlay()
         DefaultCapsuleRadius = CharacterOwner->GetCapsuleComponent()->GetUnscaledCapsuleRadius();
     }
 
+    // События Blueprint вызываются через ProcessEvent – только если класс их действительно реализует
+    const UClass* Class = GetClass();
+    bBPImplementsGaitChanged = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UTDSCharacterMovementComponent, OnGaitChanged));
+    bBPImplementsMovementParametersUpdated = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UTDSCharacterMovementComponent, OnMovementParametersUpdated));
+    bBPImplementsMovementCustomUpdated = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UTDSCharacterMovementComponent, OnMovementCustomUpdated));
+    NotifiedGait = CurrentGait;
+
+    // Проверка клиентских ходов нужна только серверу
+    if (GetOwnerRole() == ROLE_Authority && GetWorld())
+    {
+        MoveValidation = GetWorld()->GetSubsystem<UTDSMoveValidationSubsystem>();
+        RefreshMoveEnvelope();
+
+        ServerGovernor = GetWorld()->GetSubsystem<UTDSServerGovernorSubsystem>();
+        if (ServerGovernor.IsValid())
+        {
+            ServerGovernor->Register(*this);
+        }
+
+        BaseNetUpdateFrequency = GetOwner()->NetUpdateFrequency;
+        LastNetTierYaw = static_cast<float>(CharacterOwner ? CharacterOwner->GetControlRotation().Yaw : 0.0);
+    }
+
     // Подписываемся на события коллизии только для Authority и AutonomousProxy
     if (GetPawnOwner()->GetLocalRole() > ROLE_SimulatedProxy)
     {
@@ -68,6 +145,11 @@ void UTDSCharacterMovementComponent::BeginPlay()
 
 void UTDSCharacterMovementComponent::OnComponentDestroyed(bool bDestroyingHierarchy)
 {
+    if (UTDSServerGovernorSubsystem* Governor = ServerGovernor.Get())
+    {
+        Governor->Unregister(*this);
+    }
+
     if (GetPawnOwner() != nullptr && GetPawnOwner()->GetLocalRole() > ROLE_SimulatedProxy)
     {
         GetPawnOwner()->OnActorHit.RemoveDynamic(this, &UTDSCharacterMovementComponent::OnActorHit);
@@ -91,8 +173,8 @@ void UTDSCharacterMovementComponent::GetLifetimeReplicatedProps(TArray<FLifetime
     DOREPLIFETIME_CONDITION(UTDSCharacterMovementComponent, WallRunDirection, COND_SkipOwner);
     DOREPLIFETIME_CONDITION(UTDSCharacterMovementComponent, WallRunSide, COND_SkipOwner);
     
-    // Новые переменные для системы гейтов
-    DOREPLIFETIME_CONDITION(UTDSCharacterMovementComponent, CurrentGait, COND_SkipOwner);
+    // Гейт прокси выводят сами, реплицируется только поправка
+    DOREPLIFETIME_CONDITION(UTDSCharacterMovementComponent, ReplicatedGaitOverride, COND_SkipOwner);
 }
 
 #pragma region Gait System Implementation
@@ -107,12 +189,15 @@ void UTDSCharacterMovementComponent::UpdateMovementWithGait()
 
     // 1) Определяем текущий гейт
     EGait DesiredGait = GetDesiredGait();
-    if (CurrentGait != DesiredGait)
-    {
-        EGait OldGait = CurrentGait;
-        CurrentGait = DesiredGait;
-        OnGaitChanged(OldGait, CurrentGait);
-    }
+    CurrentGait = DesiredGait;
+    NotifyGaitChanged();
+
+    // Параметры пересчитываются на каждом ходу, но событие нужно только при их изменении
+    const float OldMaxAcceleration = MaxAcceleration;
+    const float OldBrakingDeceleration = BrakingDecelerationWalking;
+    const float OldGroundFriction = GroundFriction;
+    const float OldMaxWalkSpeed = MaxWalkSpeed;
+    const float OldMaxWalkSpeedCrouched = MaxWalkSpeedCrouched;
 
     // 2) Устанавливаем максимальное ускорение
     MaxAcceleration = CalculateMaxAccelerationWithGait();
@@ -135,8 +220,46 @@ void UTDSCharacterMovementComponent::UpdateMovementWithGait()
         MaxWalkSpeedCrouched = CalculateMaxCrouchSpeed();
     }
 
-    // Вызываем событие для Blueprint
-    OnMovementParametersUpdated();
+    bMovementParametersDirty |= MaxAcceleration != OldMaxAcceleration
+        || BrakingDecelerationWalking != OldBrakingDeceleration
+        || GroundFriction != OldGroundFriction
+        || MaxWalkSpeed != OldMaxWalkSpeed
+        || MaxWalkSpeedCrouched != OldMaxWalkSpeedCrouched;
+    NotifyMovementParametersUpdated();
+}
+
+void UTDSCharacterMovementComponent::NotifyGaitChanged()
+{
+    if (CurrentGait == NotifiedGait || !CanBroadcastMovementEvents())
+    {
+        return;
+    }
+
+    const EGait OldGait = NotifiedGait;
+    NotifiedGait = CurrentGait;
+
+    GaitChanged.Broadcast(OldGait, CurrentGait);
+    if (bBPImplementsGaitChanged)
+    {
+        OnGaitChanged(OldGait, CurrentGait);
+    }
+}
+
+void UTDSCharacterMovementComponent::NotifyMovementParametersUpdated()
+{
+    if (!bMovementParametersDirty || !CanBroadcastMovementEvents())
+    {
+        return;
+    }
+    bMovementParametersDirty = false;
+
+    MovementParametersUpdated.Broadcast();
+
+    // Событие для Blueprint (регулятор нагрузки может его отключить)
+    if (bBPImplementsMovementParametersUpdated && !bSuppressMovementBPEvents)
+    {
+        OnMovementParametersUpdated();
+    }
 }
 
 EGait UTDSCharacterMovementComponent::GetDesiredGait() const
@@ -202,18 +325,65 @@ EGait UTDSCharacterMovementComponent::GetDesiredGait() const
     }
 }
 
+EGait UTDSCharacterMovementComponent::DeriveReplicatedGait() const
+{
+    if (!bUseGaitSystem)
+    {
+        return EGait::Run;
+    }
+
+    const float Speed2D = Velocity.Size2D();
+    const bool bMoving = Speed2D > TDSGait::DeriveMinSpeed;
+
+    // Величина ввода прокси не видна: в режимах Walk/Run её заменяет скорость выше скорости Walk
+    bool bFullMovementInput = true;
+    if (MovementStickMode == EAnalogStickBehavior::FixedWalkRun || MovementStickMode == EAnalogStickBehavior::VariableWalkRun)
+    {
+        bFullMovementInput = Speed2D > WalkSpeeds.GetMax() * TDSGait::DeriveFullInputMargin;
+    }
+
+    if (bFullMovementInput)
+    {
+        // Те же условия, что в CanSprintWithGait, с направлением скорости вместо ускорения
+        if (SprintState && bMoving)
+        {
+            const bool bOrientToMovement = !(AimState || StrafeState);
+            const float AbsYawDelta = CharacterOwner
+                ? FMath::Abs(FRotator::NormalizeAxis(CharacterOwner->GetActorRotation().Yaw - Velocity.Rotation().Yaw))
+                : 0.0f;
+            if (bOrientToMovement || AbsYawDelta < 50.f)
+            {
+                return EGait::Sprint;
+            }
+        }
+        return EGait::Run;
+    }
+
+    return WalkState ? EGait::Walk : EGait::Run;
+}
+
+void UTDSCharacterMovementComponent::UpdateReplicatedGait()
+{
+    if (GetOwnerRole() == ROLE_Authority)
+    {
+        ReplicatedGaitOverride = DeriveReplicatedGait() != CurrentGait ? static_cast<uint8>(CurrentGait) + 1 : 0;
+    }
+    else if (GetOwnerRole() == ROLE_SimulatedProxy)
+    {
+        CurrentGait = ReplicatedGaitOverride ? static_cast<EGait>(ReplicatedGaitOverride - 1) : DeriveReplicatedGait();
+        NotifyGaitChanged();
+    }
+}
+
 void UTDSCharacterMovementComponent::SetGait(EGait NewGait)
 {
     if (CurrentGait != NewGait)
     {
-        EGait OldGait = CurrentGait;
         CurrentGait = NewGait;
         
-        // Обновляем параметры движения
+        // Обновляем параметры движения; смену гейта сообщает NotifyGaitChanged ровно один раз
         UpdateMovementWithGait();
-        
-        // Уведомляем Blueprint
-        OnGaitChanged(OldGait, CurrentGait);
+        NotifyGaitChanged();
     }
 }
 
@@ -521,37 +691,65 @@ void UTDSCharacterMovementComponent::UpdateCachedInput() const
 
 void UTDSCharacterMovementComponent::SetWalking(bool NewWalk, bool bClientSimulation)
 {
+    if (!bClientSimulation)
+    {
+        SetLockstepButton(FTDSLockstepInput::Walk, NewWalk);
+    }
+
     WalkState = NewWalk;
+    WakeNetUpdate();
     if (ATDSCharacter* TDSChar = Cast<ATDSCharacter>(CharacterOwner))
     {
         TDSChar->bIsWalkingState = NewWalk;
+        TDSChar->MarkMovementStateDirty(FTDSMovementState::Walk);
     }
 }
 
 void UTDSCharacterMovementComponent::SetSprinting(bool NewSprint, bool bClientSimulation)
 {
+    if (!bClientSimulation)
+    {
+        SetLockstepButton(FTDSLockstepInput::Sprint, NewSprint);
+    }
+
     SprintState = NewSprint;
+    WakeNetUpdate();
     if (ATDSCharacter* TDSChar = Cast<ATDSCharacter>(CharacterOwner))
     {
         TDSChar->bIsSprintingState = NewSprint;
+        TDSChar->MarkMovementStateDirty(FTDSMovementState::Sprint);
     }
 }
 
 void UTDSCharacterMovementComponent::SetStrafing(bool NewStrafe, bool bClientSimulation)
 {
+    if (!bClientSimulation)
+    {
+        SetLockstepButton(FTDSLockstepInput::Strafe, NewStrafe);
+    }
+
     StrafeState = NewStrafe;
+    WakeNetUpdate();
     if (ATDSCharacter* TDSChar = Cast<ATDSCharacter>(CharacterOwner))
     {
         TDSChar->bIsStrafingState = NewStrafe;
+        TDSChar->MarkMovementStateDirty(FTDSMovementState::Strafe);
     }
 }
 
 void UTDSCharacterMovementComponent::SetAiming(bool NewAim, bool bClientSimulation)
 {
+    if (!bClientSimulation)
+    {
+        SetLockstepButton(FTDSLockstepInput::Aim, NewAim);
+    }
+
     AimState = NewAim;
+    WakeNetUpdate();
     if (ATDSCharacter* TDSChar = Cast<ATDSCharacter>(CharacterOwner))
     {
         TDSChar->bIsAimingState = NewAim;
+        TDSChar->MarkMovementStateDirty(FTDSMovementState::Aim);
     }
 }
 
@@ -559,17 +757,43 @@ void UTDSCharacterMovementComponent::SetSlideInput(bool bSlidePressed)
 {
     bSlideKeyDown = bSlidePressed;
     SlideKeysDown = bSlidePressed;
+    SetLockstepButton(FTDSLockstepInput::Slide, bSlidePressed);
 }
 
 void UTDSCharacterMovementComponent::SetProneInput(bool bPronePressed)
 {
     bProneKeyDown = bPronePressed;
     ProneKeysDown = bPronePressed;
+    SetLockstepButton(FTDSLockstepInput::Prone, bPronePressed);
 }
 
 void UTDSCharacterMovementComponent::SetWallRunInput(bool bWallRunPressed)
 {
     WallRunKeysDown = bWallRunPressed;
+    SetLockstepButton(FTDSLockstepInput::WallRun, bWallRunPressed);
+}
+
+void UTDSCharacterMovementComponent::UpdateCustomMovementKeys()
+{
+    // Логика для слайда
+    if (bSlideKeyDown && CanSlide() && !IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_Sliding))
+    {
+        BeginSlide();
+    }
+    else if (!bSlideKeyDown && IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_Sliding))
+    {
+        EndSlide();
+    }
+
+    // Логика для prone
+    if (bProneKeyDown && CanProne() && !IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_Prone))
+    {
+        BeginProne();
+    }
+    else if (!bProneKeyDown && IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_Prone))
+    {
+        EndProne();
+    }
 }
 
 bool UTDSCharacterMovementComponent::IsCustomMovementMode(ETDSCustomMovementMode CustomMode) const
@@ -599,6 +823,7 @@ bool UTDSCharacterMovementComponent::BeginWallRun()
     }
 
     SetMovementMode(EMovementMode::MOVE_Custom, static_cast<uint8>(ETDSCustomMovementMode::CMOVE_WallRunning));
+    WakeNetUpdate();
     OnWallRunStarted(WallRunSide);
     return true;
 }
@@ -608,6 +833,7 @@ void UTDSCharacterMovementComponent::EndWallRun()
     if (IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_WallRunning))
     {
         SetMovementMode(EMovementMode::MOVE_Falling);
+        WakeNetUpdate();
         OnWallRunEnded();
     }
 }
@@ -634,6 +860,7 @@ bool UTDSCharacterMovementComponent::IsNextToWall(float VerticalTolerance)
 
     auto LineTrace = [&](const FVector& Start, const FVector& End)
     {
+        FTDSPerfCounters::Get().CountTrace();
         return GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility);
     };
 
@@ -730,6 +957,7 @@ bool UTDSCharacterMovementComponent::BeginSlide()
 
     SetMovementMode(EMovementMode::MOVE_Custom, static_cast<uint8>(ETDSCustomMovementMode::CMOVE_Sliding));
     SetCapsuleSize(SlideCapsuleHalfHeight);
+    WakeNetUpdate();
     OnSlideStarted();
     return true;
 }
@@ -740,6 +968,7 @@ void UTDSCharacterMovementComponent::EndSlide()
     {
         RestoreCapsuleSize();
         SetMovementMode(EMovementMode::MOVE_Walking);
+        WakeNetUpdate();
         OnSlideEnded();
     }
 }
@@ -788,6 +1017,7 @@ bool UTDSCharacterMovementComponent::BeginProne()
 
     SetMovementMode(EMovementMode::MOVE_Custom, static_cast<uint8>(ETDSCustomMovementMode::CMOVE_Prone));
     SetCapsuleSize(ProneCapsuleHalfHeight);
+    WakeNetUpdate();
     OnProneStarted();
     return true;
 }
@@ -798,6 +1028,7 @@ void UTDSCharacterMovementComponent::EndProne()
     {
         RestoreCapsuleSize();
         SetMovementMode(EMovementMode::MOVE_Walking);
+        WakeNetUpdate();
         OnProneEnded();
     }
 }
@@ -829,6 +1060,344 @@ void UTDSCharacterMovementComponent::PhysProne(float DeltaTime, int32 Iterations
 
 #pragma endregion
 
+#pragma region Move Validation
+
+void UTDSCharacterMovementComponent::RefreshMoveEnvelope()
+{
+    FTDSMoveEnvelope& Envelope = MoveValidationState.Envelope;
+    auto SetSlot = [&Envelope](ETDSMoveEnvelopeSlot Slot, float Speed)
+    {
+        Envelope.MaxSpeed[static_cast<int32>(Slot)] = Speed;
+    };
+
+    // Гейтовые скорости задаются по направлениям – берём максимум
+    if (bUseGaitSystem)
+    {
+        SetSlot(ETDSMoveEnvelopeSlot::Walk, WalkSpeeds.GetMax());
+        SetSlot(ETDSMoveEnvelopeSlot::Run, RunSpeeds.GetMax());
+        SetSlot(ETDSMoveEnvelopeSlot::Sprint, SprintSpeeds.GetMax());
+        SetSlot(ETDSMoveEnvelopeSlot::Crouch, CrouchSpeeds.GetMax());
+    }
+    else
+    {
+        // Те же множители, что в GetMaxSpeed
+        SetSlot(ETDSMoveEnvelopeSlot::Walk, MaxWalkSpeed * 0.5f);
+        SetSlot(ETDSMoveEnvelopeSlot::Run, MaxWalkSpeed);
+        SetSlot(ETDSMoveEnvelopeSlot::Sprint, MaxWalkSpeed * 1.5f);
+        SetSlot(ETDSMoveEnvelopeSlot::Crouch, MaxWalkSpeedCrouched);
+    }
+
+    SetSlot(ETDSMoveEnvelopeSlot::Slide, FMath::Max(SlideSpeed, Envelope.MaxSpeed[static_cast<int32>(ETDSMoveEnvelopeSlot::Sprint)]));
+    SetSlot(ETDSMoveEnvelopeSlot::Prone, ProneSpeed);
+    SetSlot(ETDSMoveEnvelopeSlot::WallRun, WallRunSpeed);
+
+    // В воздухе горизонтальная скорость сохраняется от любого режима
+    float AirSpeed = 0.0f;
+    for (int32 Slot = 0; Slot < static_cast<int32>(ETDSMoveEnvelopeSlot::Air); ++Slot)
+    {
+        AirSpeed = FMath::Max(AirSpeed, Envelope.MaxSpeed[Slot]);
+    }
+    SetSlot(ETDSMoveEnvelopeSlot::Air, AirSpeed);
+
+    Envelope.SlideDeceleration = SlideDeceleration;
+    Envelope.MinSlideSpeed = MinSlideSpeed;
+
+    // Мягкое торможение гейта при наличии ввода (см. CalculateBrakingDecelerationWithGait) – нижняя оценка
+    Envelope.CarryDeceleration = FMath::Max(FMath::Min(bUseGaitSystem ? 500.0f : BrakingDecelerationWalking, SlideDeceleration), 100.0f);
+}
+
+bool UTDSCharacterMovementComponent::PrepareMoveValidation(const FCharacterNetworkMoveData& MoveData, float& OutDeltaTime, FVector& OutServerLocation)
+{
+    UTDSMoveValidationSubsystem* Validation = MoveValidation.Get();
+    FNetworkPredictionData_Server_Character* ServerData = GetPredictionData_Server_Character();
+    if (!Validation || !ServerData || !UpdatedComponent || !CharacterOwner)
+    {
+        return false;
+    }
+
+    // Позиция на подвижной базе относительная – дешёво её не проверить
+    if (MoveData.MovementBase)
+    {
+        Validation->SkipMove();
+        return false;
+    }
+
+    // Считается до Super: он обновит CurrentClientTimeStamp и сдвинет персонажа
+    OutDeltaTime = ServerData->GetServerMoveDeltaTime(MoveData.TimeStamp, CharacterOwner->GetActorTimeDilation());
+    OutServerLocation = UpdatedComponent->GetComponentLocation();
+    return true;
+}
+
+void UTDSCharacterMovementComponent::QueueMoveValidation(float DeltaTime, const FVector& ServerLocation, const FVector& ClientLocation)
+{
+    if (UTDSMoveValidationSubsystem* Validation = MoveValidation.Get())
+    {
+        Validation->QueueMove(*this, GetMoveEnvelopeSlot(), DeltaTime, ServerLocation, ClientLocation);
+    }
+}
+
+ETDSMoveEnvelopeSlot UTDSCharacterMovementComponent::GetMoveEnvelopeSlot() const
+{
+    // Заявленный клиентом режим (MoveData.MovementMode) не используется: иначе клиент выбирает себе предел сам.
+    // Состояние снимается после выполнения хода – сервер уже применил ввод и сам решил, начался ли слайд или wall run.
+    if (MovementMode == MOVE_Custom)
+    {
+        switch (static_cast<ETDSCustomMovementMode>(CustomMovementMode))
+        {
+        case ETDSCustomMovementMode::CMOVE_WallRunning:
+            return ETDSMoveEnvelopeSlot::WallRun;
+        case ETDSCustomMovementMode::CMOVE_Sliding:
+            return ETDSMoveEnvelopeSlot::Slide;
+        case ETDSCustomMovementMode::CMOVE_Prone:
+            return ETDSMoveEnvelopeSlot::Prone;
+        default:
+            return ETDSMoveEnvelopeSlot::Air;
+        }
+    }
+
+    if (MovementMode != MOVE_Walking && MovementMode != MOVE_NavWalking)
+    {
+        return ETDSMoveEnvelopeSlot::Air;
+    }
+
+    if (IsCrouching())
+    {
+        return ETDSMoveEnvelopeSlot::Crouch;
+    }
+
+    // Без системы гейтов ячейку задают состояния walk/sprint (см. RefreshMoveEnvelope)
+    if (!bUseGaitSystem)
+    {
+        return SprintState ? ETDSMoveEnvelopeSlot::Sprint : WalkState ? ETDSMoveEnvelopeSlot::Walk : ETDSMoveEnvelopeSlot::Run;
+    }
+
+    switch (CurrentGait)
+    {
+    case EGait::Walk:   return ETDSMoveEnvelopeSlot::Walk;
+    case EGait::Sprint: return ETDSMoveEnvelopeSlot::Sprint;
+    default:            return ETDSMoveEnvelopeSlot::Run;
+    }
+}
+
+#pragma endregion
+
+#pragma region Server Governor
+
+void UTDSCharacterMovementComponent::ApplyGovernorState(bool bReduceSubsteps, bool bReduceNetUpdate, bool bSuppressBPEvents)
+{
+    if (bReduceSubsteps != bGovernorReducedSubsteps)
+    {
+        bGovernorReducedSubsteps = bReduceSubsteps;
+        if (bReduceSubsteps)
+        {
+            GovernorSavedMaxTimeStep = MaxSimulationTimeStep;
+            GovernorSavedMaxIterations = MaxSimulationIterations;
+            MaxSimulationTimeStep = FMath::Max(MaxSimulationTimeStep, UTDSServerGovernorSubsystem::GetFarMaxTimeStep());
+            MaxSimulationIterations = FMath::Min(MaxSimulationIterations, UTDSServerGovernorSubsystem::GetFarMaxIterations());
+        }
+        else
+        {
+            MaxSimulationTimeStep = GovernorSavedMaxTimeStep;
+            MaxSimulationIterations = GovernorSavedMaxIterations;
+        }
+    }
+
+    if (bReduceNetUpdate != bGovernorReducedNetUpdate)
+    {
+        bGovernorReducedNetUpdate = bReduceNetUpdate;
+        ApplyNetUpdateFrequency();
+
+        // Персонаж сдвинулся – сразу отдаём актуальное состояние
+        if (!bReduceNetUpdate && GetOwner())
+        {
+            GetOwner()->ForceNetUpdate();
+        }
+    }
+
+    bSuppressMovementBPEvents = bSuppressBPEvents;
+}
+
+#pragma endregion
+
+#pragma region Lockstep
+
+void UTDSCharacterMovementComponent::SetLockstepButton(uint8 Button, bool bDown)
+{
+    LockstepButtons = bDown ? (LockstepButtons | Button) : (LockstepButtons & ~Button);
+}
+
+FTDSLockstepInput UTDSCharacterMovementComponent::ConsumeLockstepInput()
+{
+    FTDSLockstepInput Input;
+    Input.Buttons = LockstepButtons;
+
+    if (CharacterOwner)
+    {
+        // Тик компонента выключен – ввод накопился за все кадры с прошлого шага
+        Input.SetMove(ConsumeInputVector());
+        Input.SetAimYaw(CharacterOwner->GetBaseAimRotation().Yaw);
+    }
+    return Input;
+}
+
+void UTDSCharacterMovementComponent::SimulateLockstepTick(float DeltaSeconds, const FTDSLockstepInput& Input)
+{
+    SCOPE_CYCLE_COUNTER(STAT_TDSMovementTick);
+    FTDSScopedMovementTimer MovementTimer;
+
+    ATDSCharacter* TDSChar = Cast<ATDSCharacter>(CharacterOwner);
+    if (!TDSChar || !HasValidData())
+    {
+        return;
+    }
+
+    // Состояния – через персонажа, чтобы сработали его события; bClientSimulation не трогает LockstepButtons
+    if (WalkState != Input.HasButton(FTDSLockstepInput::Walk))
+    {
+        TDSChar->SetWalking(Input.HasButton(FTDSLockstepInput::Walk), true);
+    }
+    if (SprintState != Input.HasButton(FTDSLockstepInput::Sprint))
+    {
+        TDSChar->SetSprinting(Input.HasButton(FTDSLockstepInput::Sprint), true);
+    }
+    if (StrafeState != Input.HasButton(FTDSLockstepInput::Strafe))
+    {
+        TDSChar->SetStrafing(Input.HasButton(FTDSLockstepInput::Strafe), true);
+    }
+    if (AimState != Input.HasButton(FTDSLockstepInput::Aim))
+    {
+        TDSChar->SetAiming(Input.HasButton(FTDSLockstepInput::Aim), true);
+    }
+
+    bSlideKeyDown = Input.HasButton(FTDSLockstepInput::Slide);
+    SlideKeysDown = bSlideKeyDown;
+    bProneKeyDown = Input.HasButton(FTDSLockstepInput::Prone);
+    ProneKeysDown = bProneKeyDown;
+    WallRunKeysDown = Input.HasButton(FTDSLockstepInput::WallRun);
+    UpdateCustomMovementKeys();
+
+    // Контроллер есть не у всех участников, поэтому поворот по прицелу задаётся напрямую и одинаково везде
+    if (StrafeState || AimState)
+    {
+        UpdatedComponent->SetWorldRotation(FRotator(0.0, Input.GetAimYaw(), 0.0));
+    }
+
+    Acceleration = ScaleInputAcceleration(ConstrainInputAcceleration(Input.GetMove()));
+    AnalogInputModifier = ComputeAnalogInputModifier();
+    PerformMovement(DeltaSeconds);
+}
+
+#pragma endregion
+
+#pragma region Net Update Tiers
+
+void UTDSCharacterMovementComponent::WakeNetUpdate()
+{
+    if (BaseNetUpdateFrequency <= 0.0f)
+    {
+        return;
+    }
+
+    NetIdleSeconds = 0.0f;
+    NetTierTimer = TDSNetTier::EvaluateInterval;
+
+    // Не ниже Normal до следующей оценки, даже если персонаж ещё не сдвинулся
+    const ETDSNetUpdateTier NewTier = FMath::Max(EvaluateNetUpdateTier(), ETDSNetUpdateTier::Normal);
+    if (NewTier != NetUpdateTier)
+    {
+        NetUpdateTier = NewTier;
+        ApplyNetUpdateFrequency();
+    }
+    GetOwner()->ForceNetUpdate();
+}
+
+ETDSNetUpdateTier UTDSCharacterMovementComponent::EvaluateNetUpdateTier() const
+{
+    // Быстрые режимы и недавний поворот прицела – полная частота
+    if (IsFalling() || IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_WallRunning) ||
+        IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_Sliding) || NetAimSeconds > 0.0f)
+    {
+        return ETDSNetUpdateTier::Fast;
+    }
+
+    const bool bMoving = !GetCurrentAcceleration().IsNearlyZero() ||
+        Velocity.SizeSquared() > FMath::Square(TDSNetTier::CVarIdleSpeed.GetValueOnGameThread());
+    if (bMoving)
+    {
+        return CurrentGait == EGait::Sprint ? ETDSNetUpdateTier::Fast : ETDSNetUpdateTier::Normal;
+    }
+
+    // Стоит или лежит неподвижно
+    return NetIdleSeconds >= TDSNetTier::CVarDormantSeconds.GetValueOnGameThread() ? ETDSNetUpdateTier::Dormant : ETDSNetUpdateTier::Idle;
+}
+
+void UTDSCharacterMovementComponent::UpdateNetUpdateTier(float DeltaTime)
+{
+    NetAimSeconds = FMath::Max(NetAimSeconds - DeltaTime, 0.0f);
+
+    NetTierTimer -= DeltaTime;
+    if (NetTierTimer > 0.0f)
+    {
+        return;
+    }
+    const float Elapsed = TDSNetTier::EvaluateInterval - NetTierTimer;
+    NetTierTimer = TDSNetTier::EvaluateInterval;
+
+    // На сервере ControlRotation удалённого игрока приходит с его ходами
+    const float Yaw = static_cast<float>(CharacterOwner->GetControlRotation().Yaw);
+    if (FMath::Abs(FMath::FindDeltaAngleDegrees(LastNetTierYaw, Yaw)) > TDSNetTier::CVarAimDegrees.GetValueOnGameThread())
+    {
+        NetAimSeconds = TDSNetTier::CVarAimHoldSeconds.GetValueOnGameThread();
+    }
+    LastNetTierYaw = Yaw;
+
+    const ETDSNetUpdateTier NewTier = EvaluateNetUpdateTier();
+    NetIdleSeconds = NewTier <= ETDSNetUpdateTier::Idle ? NetIdleSeconds + Elapsed : 0.0f;
+
+    if (NewTier != NetUpdateTier)
+    {
+        const bool bWaking = NewTier > NetUpdateTier;
+        NetUpdateTier = NewTier;
+        ApplyNetUpdateFrequency();
+
+        if (bWaking)
+        {
+            GetOwner()->ForceNetUpdate();
+        }
+    }
+}
+
+void UTDSCharacterMovementComponent::ApplyNetUpdateFrequency()
+{
+    AActor* Owner = GetOwner();
+    if (!Owner || BaseNetUpdateFrequency <= 0.0f)
+    {
+        return;
+    }
+
+    float Frequency = BaseNetUpdateFrequency;
+    if (TDSNetTier::CVarEnabled.GetValueOnGameThread())
+    {
+        switch (NetUpdateTier)
+        {
+        case ETDSNetUpdateTier::Dormant: Frequency = TDSNetTier::CVarDormantHz.GetValueOnGameThread(); break;
+        case ETDSNetUpdateTier::Idle:    Frequency = TDSNetTier::CVarIdleHz.GetValueOnGameThread(); break;
+        case ETDSNetUpdateTier::Normal:  Frequency = TDSNetTier::CVarNormalHz.GetValueOnGameThread(); break;
+        case ETDSNetUpdateTier::Fast:    break;
+        }
+    }
+
+    // Регулятор нагрузки дополнительно ограничивает стоящих персонажей
+    if (bGovernorReducedNetUpdate)
+    {
+        Frequency = FMath::Min(Frequency, UTDSServerGovernorSubsystem::GetIdleNetUpdateFrequency());
+    }
+
+    Owner->NetUpdateFrequency = FMath::Clamp(Frequency, 1.0f, BaseNetUpdateFrequency);
+}
+
+#pragma endregion
+
 #pragma region Capsule Management
 
 void UTDSCharacterMovementComponent::SetCapsuleSize(float NewHalfHeight, float NewRadius, bool bUpdateOverlaps)
@@ -887,31 +1456,26 @@ void UTDSCharacterMovementComponent::OnActorHit(AActor* SelfActor, AActor* Other
 
 void UTDSCharacterMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+    SCOPE_CYCLE_COUNTER(STAT_TDSMovementTick);
+    FTDSScopedMovementTimer MovementTimer;
+
     // Локальная логика управления
     if (GetPawnOwner()->IsLocallyControlled())
     {
-        // Логика для слайда
-        if (bSlideKeyDown && CanSlide() && !IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_Sliding))
-        {
-            BeginSlide();
-        }
-        else if (!bSlideKeyDown && IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_Sliding))
-        {
-            EndSlide();
-        }
-
-        // Логика для prone
-        if (bProneKeyDown && CanProne() && !IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_Prone))
-        {
-            BeginProne();
-        }
-        else if (!bProneKeyDown && IsCustomMovementMode(ETDSCustomMovementMode::CMOVE_Prone))
-        {
-            EndProne();
-        }
+        UpdateCustomMovementKeys();
     }
 
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    if (CharacterOwner && GetNetMode() != NM_Standalone)
+    {
+        UpdateReplicatedGait();
+    }
+
+    if (BaseNetUpdateFrequency > 0.0f)
+    {
+        UpdateNetUpdateTier(DeltaTime);
+    }
 }
 
 void UTDSCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
@@ -929,6 +1493,12 @@ void UTDSCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
     const bool NewSlide = SlideKeysDown;
     const bool NewProne = ProneKeysDown;
 
+    // Смена состояния от клиента будит сетевые обновления на сервере
+    if (WalkState != NewWalk || SprintState != NewSprint || StrafeState != NewStrafe || AimState != NewAim)
+    {
+        WakeNetUpdate();
+    }
+
     // Обновляем состояния
     WalkState = NewWalk;
     SprintState = NewSprint;
@@ -938,15 +1508,21 @@ void UTDSCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
     SlideKeysDown = NewSlide;
     ProneKeysDown = NewProne;
 
-    // Синхронизируем с персонажем на сервере
+    // Синхронизируем с персонажем на сервере; подписчики узнают о смене в его Tick
     if (CharacterOwner->HasAuthority())
     {
         if (ATDSCharacter* TDSChar = Cast<ATDSCharacter>(CharacterOwner))
         {
+            const uint8 OldMask = TDSChar->GetMovementState().ToMask();
             TDSChar->bIsWalkingState = NewWalk;
             TDSChar->bIsSprintingState = NewSprint;
             TDSChar->bIsStrafingState = NewStrafe;
             TDSChar->bIsAimingState = NewAim;
+
+            if (const uint8 ChangedMask = OldMask ^ TDSChar->GetMovementState().ToMask())
+            {
+                TDSChar->MarkMovementStateDirty(ChangedMask);
+            }
         }
     }
 }
@@ -955,14 +1531,31 @@ void UTDSCharacterMovementComponent::UpdateCharacterStateBeforeMovement(float De
 {
     Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
     
-    // Обновляем параметры движения с учетом гейта
-    if (bUseGaitSystem)
+    // Обновляем параметры движения с учетом гейта; при повторе ходов их уже восстановил PrepMoveFor
+    if (bUseGaitSystem && !bClientUpdating)
     {
         UpdateMovementWithGait();
     }
     
-    // Вызываем Blueprint событие
-    OnMovementCustomUpdated(DeltaSeconds);
+    // Повтор сохранённых ходов не вызывает событий: они уже прозвучали при первом выполнении хода
+    if (CanBroadcastMovementEvents())
+    {
+        MovementCustomUpdated.Broadcast(DeltaSeconds);
+
+        // Без переопределения в Blueprint – прямой вызов нативной реализации, минуя ProcessEvent
+        // (регулятор нагрузки может отключить событие Blueprint)
+        if (bBPImplementsMovementCustomUpdated)
+        {
+            if (!bSuppressMovementBPEvents)
+            {
+                OnMovementCustomUpdated(DeltaSeconds);
+            }
+        }
+        else
+        {
+            OnMovementCustomUpdated_Implementation(DeltaSeconds);
+        }
+    }
 
     // Логика ротации для всех ролей
     const bool bShouldUseControllerRotation = (AimState || StrafeState);
@@ -1024,6 +1617,8 @@ void UTDSCharacterMovementComponent::OnMovementModeChanged(EMovementMode Previou
     }
 
     Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+
+    WakeNetUpdate();
 }
 
 void UTDSCharacterMovementComponent::PhysCustom(float DeltaTime, int32 Iterations)
@@ -1167,11 +1762,56 @@ FNetworkPredictionData_Client* UTDSCharacterMovementComponent::GetPredictionData
     return ClientPredictionData;
 }
 
+bool UTDSCharacterMovementComponent::ClientUpdatePositionAfterServerUpdate()
+{
+    const bool bResult = Super::ClientUpdatePositionAfterServerUpdate();
+
+    // Во время повтора события не вызывались; итог повтора сообщается один раз
+    NotifyGaitChanged();
+    NotifyMovementParametersUpdated();
+
+    return bResult;
+}
+
 void UTDSCharacterMovementComponent::OnMovementCustomUpdated_Implementation(float DeltaSeconds)
 {
     // Базовая реализация - может быть переопределена в Blueprint
 }
 
+void UTDSCharacterMovementComponent::ServerMovePacked_ServerReceive(const FCharacterServerMovePackedBits& PackedBits)
+{
+    // RPC, а не ходы: в одном пакете их до трёх (ServerMoveRpcsPerSec в TDS.NetScenario)
+    FTDSPerfCounters::Get().CountServerMoveRpc();
+    Super::ServerMovePacked_ServerReceive(PackedBits);
+}
+
+void UTDSCharacterMovementComponent::ServerMove_PerformMovement(const FCharacterNetworkMoveData& MoveData)
+{
+    FTDSPerfCounters::Get().CountServerMove();
+
+    float MoveDeltaTime = 0.0f;
+    FVector ServerLocation = FVector::ZeroVector;
+    const bool bValidate = PrepareMoveValidation(MoveData, MoveDeltaTime, ServerLocation);
+
+    Super::ServerMove_PerformMovement(MoveData);
+
+    if (bValidate)
+    {
+        QueueMoveValidation(MoveDeltaTime, ServerLocation, MoveData.Location);
+    }
+}
+
+bool UTDSCharacterMovementComponent::ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc, const FVector& RelativeClientLoc, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+    const bool bError = Super::ServerCheckClientError(ClientTimeStamp, DeltaTime, Accel, ClientLoc, RelativeClientLoc, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+    if (bError)
+    {
+        // Ошибка клиента → сервер отправит коррекцию
+        FTDSPerfCounters::Get().CountCorrection();
+    }
+    return bError;
+}
+
 #pragma endregion
 
 //////////////////////////////////////////////////////////////////////////
@@ -1185,9 +1825,14 @@ FSavedMove_TDS::FSavedMove_TDS()
     , SavedWallRunKeysDown(0)
     , SavedSlideKeysDown(0)
     , SavedProneKeysDown(0)
-    , SavedGait(EGait::Run)
     , SavedMoveInput(FVector2D::ZeroVector)
     , SavedMoveWSInput(FVector2D::ZeroVector)
+    , SavedMoveGait(EGait::Run)
+    , SavedMaxAcceleration(0.0f)
+    , SavedBrakingDecelerationWalking(0.0f)
+    , SavedGroundFriction(0.0f)
+    , SavedMaxWalkSpeed(0.0f)
+    , SavedMaxWalkSpeedCrouched(0.0f)
 {
 }
 
@@ -1202,9 +1847,14 @@ void FSavedMove_TDS::Clear()
     SavedWallRunKeysDown = 0;
     SavedSlideKeysDown = 0;
     SavedProneKeysDown = 0;
-    SavedGait = EGait::Run;
     SavedMoveInput = FVector2D::ZeroVector;
     SavedMoveWSInput = FVector2D::ZeroVector;
+    SavedMoveGait = EGait::Run;
+    SavedMaxAcceleration = 0.0f;
+    SavedBrakingDecelerationWalking = 0.0f;
+    SavedGroundFriction = 0.0f;
+    SavedMaxWalkSpeed = 0.0f;
+    SavedMaxWalkSpeedCrouched = 0.0f;
 }
 
 void FSavedMove_TDS::SetMoveFor(ACharacter* Character, float InDeltaTime, const FVector& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
@@ -1222,9 +1872,11 @@ void FSavedMove_TDS::SetMoveFor(ACharacter* Character, float InDeltaTime, const
         SavedProneKeysDown = MoveComp->ProneKeysDown;
         
         // Сохраняем данные гейта
-        SavedGait = MoveComp->GetCurrentGait();
         SavedMoveInput = MoveComp->GetMovementInput();
         SavedMoveWSInput = MoveComp->GetMovementWorldSpaceInput();
+
+        // CanCombineWith вызывается до выполнения нового хода – сравниваются параметры, с которыми он начнётся
+        SaveMoveParameters(*MoveComp);
     }
 }
 
@@ -1242,11 +1894,54 @@ void FSavedMove_TDS::PrepMoveFor(ACharacter* Character)
         MoveComp->SlideKeysDown = SavedSlideKeysDown;
         MoveComp->ProneKeysDown = SavedProneKeysDown;
         
-        // Восстанавливаем гейт
-        MoveComp->SetGait(SavedGait);
+        // Повтор хода после коррекции: гейт и параметры берутся из снимка как есть,
+        // без SetGait/UpdateMovementWithGait и событий (см. ClientUpdatePositionAfterServerUpdate)
+        MoveComp->CurrentGait = SavedMoveGait;
+        MoveComp->MaxAcceleration = SavedMaxAcceleration;
+        MoveComp->BrakingDecelerationWalking = SavedBrakingDecelerationWalking;
+        MoveComp->GroundFriction = SavedGroundFriction;
+        MoveComp->MaxWalkSpeed = SavedMaxWalkSpeed;
+        MoveComp->MaxWalkSpeedCrouched = SavedMaxWalkSpeedCrouched;
+    }
+}
+
+void FSavedMove_TDS::PostUpdate(ACharacter* Character, EPostUpdateMode PostUpdateMode)
+{
+    Super::PostUpdate(Character, PostUpdateMode);
+
+    // Снимок берётся один раз, после первого выполнения хода; повтор его не перезаписывает
+    if (PostUpdateMode != PostUpdate_Record)
+    {
+        return;
+    }
+
+    if (const UTDSCharacterMovementComponent* MoveComp = Cast<UTDSCharacterMovementComponent>(Character->GetCharacterMovement()))
+    {
+        SaveMoveParameters(*MoveComp);
     }
 }
 
+void FSavedMove_TDS::SaveMoveParameters(const UTDSCharacterMovementComponent& MoveComp)
+{
+    SavedMoveGait = MoveComp.CurrentGait;
+    SavedMaxAcceleration = MoveComp.MaxAcceleration;
+    SavedBrakingDecelerationWalking = MoveComp.BrakingDecelerationWalking;
+    SavedGroundFriction = MoveComp.GroundFriction;
+    SavedMaxWalkSpeed = MoveComp.MaxWalkSpeed;
+    SavedMaxWalkSpeedCrouched = MoveComp.MaxWalkSpeedCrouched;
+}
+
+bool FSavedMove_TDS::HasSameMoveParameters(const FSavedMove_TDS& Other) const
+{
+    // Значения копируются из компонента без вычислений, поэтому сравниваются точно
+    return SavedMoveGait == Other.SavedMoveGait &&
+        SavedMaxAcceleration == Other.SavedMaxAcceleration &&
+        SavedBrakingDecelerationWalking == Other.SavedBrakingDecelerationWalking &&
+        SavedGroundFriction == Other.SavedGroundFriction &&
+        SavedMaxWalkSpeed == Other.SavedMaxWalkSpeed &&
+        SavedMaxWalkSpeedCrouched == Other.SavedMaxWalkSpeedCrouched;
+}
+
 uint8 FSavedMove_TDS::GetCompressedFlags() const
 {
     uint8 Flags = Super::GetCompressedFlags();
@@ -1274,8 +1969,13 @@ bool FSavedMove_TDS::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* Ch
         SavedAimState != Other->SavedAimState ||
         SavedWallRunKeysDown != Other->SavedWallRunKeysDown ||
         SavedSlideKeysDown != Other->SavedSlideKeysDown ||
-        SavedProneKeysDown != Other->SavedProneKeysDown ||
-        SavedGait != Other->SavedGait)
+        SavedProneKeysDown != Other->SavedProneKeysDown)
+    {
+        return false;
+    }
+
+    // Объединённый ход повторяется с одним снимком параметров – ходы с разными параметрами не склеиваются
+    if (!HasSameMoveParameters(*Other))
     {
         return false;
     }
@@ -1283,6 +1983,57 @@ bool FSavedMove_TDS::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* Ch
     return Super::CanCombineWith(NewMove, Character, MaxDelta);
 }
 
+//////////////////////////////////////////////////////////////////////////
+// FTDSCharacterNetworkMoveData Implementation
+
+bool FTDSCharacterNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
+{
+    const UTDSCharacterMovementComponent& MoveComp = static_cast<const UTDSCharacterMovementComponent&>(CharacterMovement);
+    if (!MoveComp.UsesPlanarMovementCompression())
+    {
+        return Super::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+    }
+
+    // Порядок полей как в FCharacterNetworkMoveData::Serialize, меняется только формат ускорения и положения
+    NetworkMoveType = MoveType;
+
+    bool bLocalSuccess = true;
+    const bool bIsSaving = Ar.IsSaving();
+
+    Ar << TimeStamp;
+
+    FVector PlanarAcceleration = Acceleration;
+    TDSMovementCompression::SerializeAcceleration(Ar, PlanarAcceleration);
+    Acceleration = PlanarAcceleration;
+
+    // Положение нужно серверу только для сверки с допуском MAXPOSITIONERRORSQUARED (3 см²):
+    // округление до 1 см по осям даёт не больше 0.75 см²
+    const FVector LevelOrigin = TDSMovementCompression::GetLevelOrigin(MoveComp.GetWorld());
+    FVector PlanarLocation = Location - LevelOrigin;
+    TDSMovementCompression::SerializeLocation(Ar, PlanarLocation);
+    Location = PlanarLocation + LevelOrigin;
+
+    ControlRotation.NetSerialize(Ar, PackageMap, bLocalSuccess);
+
+    SerializeOptionalValue<uint8>(bIsSaving, Ar, CompressedMoveFlags, 0);
+
+    if (MoveType == ENetworkMoveType::NewMove)
+    {
+        SerializeOptionalValue<UPrimitiveComponent*>(bIsSaving, Ar, MovementBase, nullptr);
+        SerializeOptionalValue<FName>(bIsSaving, Ar, MovementBaseBoneName, NAME_None);
+        SerializeOptionalValue<uint8>(bIsSaving, Ar, MovementMode, MOVE_Walking);
+    }
+
+    return !Ar.IsError() && bLocalSuccess;
+}
+
+FTDSCharacterNetworkMoveDataContainer::FTDSCharacterNetworkMoveDataContainer()
+{
+    NewMoveData = &MoveData[0];
+    PendingMoveData = &MoveData[1];
+    OldMoveData = &MoveData[2];
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FNetworkPredictionData_Client_TDS Implementation
 
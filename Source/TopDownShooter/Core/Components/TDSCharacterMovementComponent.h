@@ -7,10 +7,13 @@
 #include "CharacterMovementComponentAsync.h"
 #include "Curves/CurveFloat.h"
 #include "Net/UnrealNetwork.h"
+#include "TDSMoveValidationSubsystem.h"
 #include "TDSCharacterMovementComponent.generated.h"
 
 class ATDSCharacter;
 class UEnhancedInputComponent;
+class UTDSServerGovernorSubsystem;
+struct FTDSLockstepInput;
 
 /** Гейт персонажа: ходьба, бег или спринт */
 UENUM(BlueprintType)
@@ -42,6 +45,16 @@ enum class ETDSCustomMovementMode : uint8
     CMOVE_MAX           UMETA(Hidden),
 };
 
+/** Ступень частоты сетевых обновлений персонажа, выбирается сервером по состоянию движения */
+UENUM(BlueprintType)
+enum class ETDSNetUpdateTier : uint8
+{
+    Dormant     UMETA(DisplayName = "Dormant"),
+    Idle        UMETA(DisplayName = "Idle"),
+    Normal      UMETA(DisplayName = "Normal"),
+    Fast        UMETA(DisplayName = "Fast"),
+};
+
 /** Сторона стены для Wall Running */
 UENUM(BlueprintType)
 enum class ETDSWallRunSide : uint8
@@ -50,6 +63,26 @@ enum class ETDSWallRunSide : uint8
     Right   UMETA(DisplayName = "Right"),
 };
 
+/** Нативные события компонента движения; не вызываются при повторе сохранённых ходов на клиенте */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FTDSOnGaitChanged, EGait /*OldGait*/, EGait /*NewGait*/);
+DECLARE_MULTICAST_DELEGATE(FTDSOnMovementParametersUpdated);
+DECLARE_MULTICAST_DELEGATE_OneParam(FTDSOnMovementCustomUpdated, float /*DeltaSeconds*/);
+
+/** Данные хода клиента; при bUsePlanarMovementCompression положение и ускорение пишутся в формате TDSMovementCompression */
+struct FTDSCharacterNetworkMoveData : public FCharacterNetworkMoveData
+{
+    typedef FCharacterNetworkMoveData Super;
+
+    virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+};
+
+struct FTDSCharacterNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+{
+    FTDSCharacterNetworkMoveDataContainer();
+
+    FTDSCharacterNetworkMoveData MoveData[3];
+};
+
 UCLASS(BlueprintType, Blueprintable)
 class TOPDOWNSHOOTER_API UTDSCharacterMovementComponent : public UCharacterMovementComponent
 {
@@ -60,13 +93,22 @@ public:
     
     friend class FSavedMove_TDS;
     friend class FNetworkPredictionData_Client_TDS;
+    friend class UTDSMoveValidationSubsystem;
+    friend class FTDSGaitDerivationTest;
 
 #pragma region Gait System Properties
 private:
-    /** Текущий гейт персонажа (реплицируется) */
-    UPROPERTY(Replicated, BlueprintReadOnly, Category="TDS Gait", Meta=(AllowPrivateAccess="true"))
+    /** Текущий гейт персонажа; у симулируемых прокси выводится из реплицируемого движения (DeriveReplicatedGait) */
+    UPROPERTY(BlueprintReadOnly, Category="TDS Gait", Meta=(AllowPrivateAccess="true"))
     EGait CurrentGait = EGait::Run;
 
+    /**
+     * Поправка гейта для прокси: 0 – гейт выводится локально, иначе EGait + 1.
+     * Сервер выставляет её только пока вывод расходится с авторитетным гейтом, поэтому реплицируется редко.
+     */
+    UPROPERTY(Replicated)
+    uint8 ReplicatedGaitOverride = 0;
+
     /** Кривая для коррекции скорости при движении вбок и назад */
     UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category="TDS Movement|Speeds", Meta=(AllowPrivateAccess="true"))
     TObjectPtr<UCurveFloat> StrafeSpeedMapCurve;
@@ -105,6 +147,23 @@ private:
     mutable float LastInputUpdateTime = 0.0f;
 #pragma endregion
 
+#pragma region Movement Compression
+public:
+    /** Сжимать ли движение под вид сверху (TDSMovementCompression); формат должен совпадать у сервера и клиентов */
+    bool UsesPlanarMovementCompression() const { return bUsePlanarMovementCompression; }
+
+private:
+    /**
+     * ReplicatedMovement для прокси и положения в ходах клиента в формате 2.5D.
+     * Персонаж на полу укладывается примерно в 80 бит против ~120 у FRepMovement движка
+     * (тест TopDownShooter.Net.PlanarMovementCompression); трафик в сценариях – TDS.NetScenario.
+     */
+    UPROPERTY(EditDefaultsOnly, Category="TDS Movement|Network", Meta=(AllowPrivateAccess="true"))
+    bool bUsePlanarMovementCompression = true;
+
+    FTDSCharacterNetworkMoveDataContainer PlanarMoveDataContainer;
+#pragma endregion
+
 #pragma region Custom Movement Properties
 private:
     /** Настройки ротации */
@@ -147,6 +206,33 @@ private:
     /** Сохраненные размеры капсулы */
     float DefaultCapsuleHalfHeight = 0.0f;
     float DefaultCapsuleRadius = 0.0f;
+
+    /** Серверная проверка ходов: огибающая, состояние и подсистема мира */
+    FTDSMoveValidationState MoveValidationState;
+    TWeakObjectPtr<UTDSMoveValidationSubsystem> MoveValidation;
+
+    /** Регулятор нагрузки и исходные значения, которые он временно подменяет */
+    TWeakObjectPtr<UTDSServerGovernorSubsystem> ServerGovernor;
+    bool bGovernorReducedSubsteps = false;
+    bool bGovernorReducedNetUpdate = false;
+    bool bSuppressMovementBPEvents = false;
+    float GovernorSavedMaxTimeStep = 0.0f;
+    int32 GovernorSavedMaxIterations = 0;
+
+    /** Ступени сетевых обновлений: исходная частота владельца, текущая ступень и счётчики */
+    ETDSNetUpdateTier NetUpdateTier = ETDSNetUpdateTier::Fast;
+    float BaseNetUpdateFrequency = 0.0f;
+    float NetTierTimer = 0.0f;
+    float NetIdleSeconds = 0.0f;
+    float NetAimSeconds = 0.0f;
+    float LastNetTierYaw = 0.0f;
+
+    /** Классифицировать персонажа по гейту, режиму, скорости и повороту прицела */
+    void UpdateNetUpdateTier(float DeltaTime);
+    ETDSNetUpdateTier EvaluateNetUpdateTier() const;
+
+    /** Записать NetUpdateFrequency владельца по ступени с учётом регулятора нагрузки */
+    void ApplyNetUpdateFrequency();
 #pragma endregion
 
 #pragma region Movement States
@@ -189,6 +275,15 @@ private:
     bool bSprintKeyDown = false;
     bool bSlideKeyDown = false;
     bool bProneKeyDown = false;
+
+    /**
+     * Кнопки игрока (FTDSLockstepInput::EButtons) для lockstep: меняются только вводом,
+     * а не применением чужого или запоздавшего ввода в SimulateLockstepTick.
+     */
+    uint8 LockstepButtons = 0;
+
+    /** Движение ведёт UTDSLockstepSubsystem */
+    bool bLockstepDriven = false;
 #pragma endregion
 
 #pragma region Public Methods - Gait System
@@ -247,6 +342,15 @@ private:
 
     /** Проверяет, есть ли входной вектор движения */
     bool HasMovementInputVector() const;
+
+    /**
+     * Гейт, восстановленный по тому, что видит прокси: скорость, поворот, WalkState/SprintState/AimState/StrafeState.
+     * Повторяет GetDesiredGait, заменяя ввод скоростью.
+     */
+    EGait DeriveReplicatedGait() const;
+
+    /** Сервер: сверить вывод с CurrentGait и обновить поправку; прокси: применить поправку или вывод */
+    void UpdateReplicatedGait();
 #pragma endregion
 
 #pragma region Public Methods - State Accessors
@@ -317,6 +421,46 @@ public:
 
     UFUNCTION(BlueprintCallable, Category="TDS Custom Movement")
     void EndProne();
+
+    /** Пересчитать огибающую скорости для серверной проверки ходов (после смены скоростей в рантайме) */
+    UFUNCTION(BlueprintCallable, Category="TDS Movement|Validation")
+    void RefreshMoveEnvelope();
+
+    /** Число клиентских ходов этого персонажа, не прошедших серверную проверку */
+    uint32 GetMoveViolations() const { return MoveValidationState.Violations; }
+
+    /**
+     * Ступени деградации от UTDSServerGovernorSubsystem; false возвращает исходные значения.
+     * @param bReduceSubsteps     меньше подшагов симуляции
+     * @param bReduceNetUpdate    пониженный NetUpdateFrequency владельца
+     * @param bSuppressBPEvents   не вызывать OnMovementParametersUpdated/OnMovementCustomUpdated
+     */
+    void ApplyGovernorState(bool bReduceSubsteps, bool bReduceNetUpdate, bool bSuppressBPEvents);
+
+    /** Текущая ступень частоты сетевых обновлений (только на сервере) */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="TDS Movement|Network")
+    ETDSNetUpdateTier GetNetUpdateTier() const { return NetUpdateTier; }
+
+    /** Смена состояния движения: сразу поднять ступень и отправить обновление */
+    void WakeNetUpdate();
+#pragma endregion
+
+#pragma region Lockstep
+public:
+    /** Ввод для UTDSLockstepSubsystem: накопленный ввод движения пешки (расходуется), прицел и кнопки */
+    FTDSLockstepInput ConsumeLockstepInput();
+
+    /**
+     * Шаг lockstep: применить ввод и выполнить движение с фиксированным шагом.
+     * Вызывается вместо тика компонента на всех участниках, в том числе для симулируемых прокси.
+     */
+    void SimulateLockstepTick(float DeltaSeconds, const FTDSLockstepInput& Input);
+
+    /** Кнопка ввода игрока (FTDSLockstepInput::EButtons); состояния меняет только SimulateLockstepTick */
+    void SetLockstepButton(uint8 Button, bool bDown);
+
+    void SetLockstepDriven(bool bDriven) { bLockstepDriven = bDriven; }
+    bool IsLockstepDriven() const { return bLockstepDriven; }
 #pragma endregion
 
 #pragma region Blueprint Events
@@ -351,6 +495,30 @@ public:
 
     UFUNCTION(BlueprintImplementableEvent, Category="TDS Gait")
     void OnMovementParametersUpdated();
+
+    /** Нативные подписки; вызываются вместе с одноимёнными событиями Blueprint */
+    FTDSOnGaitChanged GaitChanged;
+    FTDSOnMovementParametersUpdated MovementParametersUpdated;
+    FTDSOnMovementCustomUpdated MovementCustomUpdated;
+
+private:
+    /** Реализованы ли события в Blueprint класса (проверяется в BeginPlay) */
+    bool bBPImplementsGaitChanged = false;
+    bool bBPImplementsMovementParametersUpdated = false;
+    bool bBPImplementsMovementCustomUpdated = false;
+
+    /** Гейт, о котором уже сообщили подписчикам, и признак неотправленной смены параметров */
+    EGait NotifiedGait = EGait::Run;
+    bool bMovementParametersDirty = false;
+
+    /** События не вызываются при повторе сохранённых ходов: иначе они умножаются на число ходов */
+    bool CanBroadcastMovementEvents() const { return !bClientUpdating; }
+
+    /** Сообщить о смене гейта, если CurrentGait отличается от последнего отправленного */
+    void NotifyGaitChanged();
+
+    /** Сообщить об изменившихся параметрах движения */
+    void NotifyMovementParametersUpdated();
 #pragma endregion
 
 #pragma region Protected Methods - Engine Overrides
@@ -369,6 +537,10 @@ protected:
     virtual void OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity) override;
     virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+    virtual void ServerMovePacked_ServerReceive(const FCharacterServerMovePackedBits& PackedBits) override;
+    virtual void ServerMove_PerformMovement(const FCharacterNetworkMoveData& MoveData) override;
+    virtual bool ClientUpdatePositionAfterServerUpdate() override;
+    virtual bool ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc, const FVector& RelativeClientLoc, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
 #pragma endregion
 
 #pragma region Private Methods - Custom Movement Helpers
@@ -385,6 +557,16 @@ private:
     /** Prone Helper Functions */
     bool CanProne() const;
 
+    /** Начать или закончить слайд и prone по удерживаемым клавишам */
+    void UpdateCustomMovementKeys();
+
+    /** Move Validation: время и позиция до хода; false – ход не проверяется */
+    bool PrepareMoveValidation(const FCharacterNetworkMoveData& MoveData, float& OutDeltaTime, FVector& OutServerLocation);
+    void QueueMoveValidation(float DeltaTime, const FVector& ServerLocation, const FVector& ClientLocation);
+
+    /** Ячейка огибающей по собственному состоянию сервера: режим движения, присед, гейт */
+    ETDSMoveEnvelopeSlot GetMoveEnvelopeSlot() const;
+
     /** Capsule Management */
     void SetCapsuleSize(float NewHalfHeight, float NewRadius = -1.0f, bool bUpdateOverlaps = true);
     void RestoreCapsuleSize();
@@ -415,6 +597,7 @@ public:
     virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* Character, float MaxDelta) const override;
     virtual void SetMoveFor(ACharacter* Character, float DeltaTime, const FVector& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
     virtual void PrepMoveFor(ACharacter* Character) override;
+    virtual void PostUpdate(ACharacter* Character, EPostUpdateMode PostUpdateMode) override;
 
 private:
     // Основные состояния
@@ -429,9 +612,23 @@ private:
     uint8 SavedProneKeysDown : 1;
     
     // Система гейтов
-    EGait SavedGait;
     FVector2D SavedMoveInput;
     FVector2D SavedMoveWSInput;
+
+    /**
+     * Гейт и параметры движения. SetMoveFor запоминает те, с которыми ход начинается (по ним CanCombineWith
+     * сравнивает ещё не выполненный ход), PostUpdate – те, с которыми он выполнен; при повторе они
+     * восстанавливаются без пересчёта.
+     */
+    EGait SavedMoveGait;
+    float SavedMaxAcceleration;
+    float SavedBrakingDecelerationWalking;
+    float SavedGroundFriction;
+    float SavedMaxWalkSpeed;
+    float SavedMaxWalkSpeedCrouched;
+
+    void SaveMoveParameters(const UTDSCharacterMovementComponent& MoveComp);
+    bool HasSameMoveParameters(const FSavedMove_TDS& Other) const;
 };
 
 //////////////////////////////////////////////////////////////////////////
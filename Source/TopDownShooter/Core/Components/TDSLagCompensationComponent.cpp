@@ -0,0 +1,183 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSLagCompensationComponent.h"
+#include "TDSStats.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "DrawDebugHelpers.h"
+
+DECLARE_CYCLE_STAT(TEXT("TDS Lag Compensation Record"), STAT_TDSLagCompRecord, STATGROUP_TDS);
+DECLARE_CYCLE_STAT(TEXT("TDS Lag Compensation Rewind"), STAT_TDSLagCompRewind, STATGROUP_TDS);
+
+namespace TDSLagCompensation
+{
+    static TAutoConsoleVariable<float> CVarMaxRewindMs(
+        TEXT("TDS.LagCompensation.MaxRewindMs"), 250.0f,
+        TEXT("Максимальная глубина отката при проверке попаданий, мс."));
+
+    static TAutoConsoleVariable<bool> CVarDebug(
+        TEXT("TDS.LagCompensation.Debug"), false,
+        TEXT("Рисовать откатанную капсулу при каждой проверке."));
+}
+
+UTDSLagCompensationComponent::UTDSLagCompensationComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.bStartWithTickEnabled = false;
+
+    // Поза после движения и физики этого кадра
+    PrimaryComponentTick.TickGroup = TG_PostPhysics;
+
+    SetIsReplicatedByDefault(false);
+}
+
+void UTDSLagCompensationComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // История нужна только серверу
+    if (!GetOwner()->HasAuthority() || GetNetMode() == NM_Standalone)
+    {
+        return;
+    }
+
+    History.SetNumZeroed(HistoryCapacity);
+    Head = INDEX_NONE;
+    Count = 0;
+
+    SetComponentTickEnabled(true);
+    RecordPose();
+}
+
+void UTDSLagCompensationComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    RecordPose();
+}
+
+void UTDSLagCompensationComponent::RecordPose()
+{
+    SCOPE_CYCLE_COUNTER(STAT_TDSLagCompRecord);
+
+    const ACharacter* Character = Cast<ACharacter>(GetOwner());
+    const UCapsuleComponent* Capsule = Character ? Character->GetCapsuleComponent() : nullptr;
+    if (!Capsule || History.IsEmpty())
+    {
+        return;
+    }
+
+    const double Now = GetWorld()->GetTimeSeconds();
+
+    // Несколько записей за один кадр (BeginPlay + тик) – перезаписываем последнюю
+    if (Count == 0 || History[Head].ServerTime < Now)
+    {
+        Head = (Head + 1) % History.Num();
+        Count = FMath::Min(Count + 1, History.Num());
+    }
+
+    FTDSLagCompensationPose& Pose = History[Head];
+    Pose.ServerTime = Now;
+    Pose.Location = Capsule->GetComponentLocation();
+    Pose.Yaw = static_cast<float>(Capsule->GetComponentRotation().Yaw);
+    Pose.HalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+    Pose.Radius = Capsule->GetScaledCapsuleRadius();
+
+    const UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement();
+    Pose.MovementMode = MoveComp ? static_cast<uint8>(MoveComp->MovementMode) : 0;
+    Pose.CustomMovementMode = MoveComp ? MoveComp->CustomMovementMode : 0;
+}
+
+double UTDSLagCompensationComponent::GetOldestTime() const
+{
+    return Count > 0 ? GetByAge(0).ServerTime : 0.0;
+}
+
+bool UTDSLagCompensationComponent::GetPoseAtTime(double ServerTime, FTDSLagCompensationPose& OutPose) const
+{
+    if (Count == 0)
+    {
+        return false;
+    }
+
+    const FTDSLagCompensationPose& Newest = History[Head];
+    const double MaxRewind = TDSLagCompensation::CVarMaxRewindMs.GetValueOnGameThread() / 1000.0;
+    if (ServerTime < GetOldestTime() || ServerTime < Newest.ServerTime - MaxRewind)
+    {
+        return false;
+    }
+
+    if (ServerTime >= Newest.ServerTime)
+    {
+        OutPose = Newest;
+        return true;
+    }
+
+    // Первая запись не раньше ServerTime; буфер фиксированного размера – не больше log2(HistoryCapacity) шагов
+    int32 Low = 0;
+    int32 High = Count - 1;
+    while (Low < High)
+    {
+        const int32 Mid = (Low + High) / 2;
+        if (GetByAge(Mid).ServerTime < ServerTime)
+        {
+            Low = Mid + 1;
+        }
+        else
+        {
+            High = Mid;
+        }
+    }
+
+    const FTDSLagCompensationPose& After = GetByAge(Low);
+    if (Low == 0)
+    {
+        OutPose = After;
+        return true;
+    }
+
+    const FTDSLagCompensationPose& Before = GetByAge(Low - 1);
+    const float Alpha = static_cast<float>((ServerTime - Before.ServerTime) / FMath::Max(After.ServerTime - Before.ServerTime, UE_SMALL_NUMBER));
+
+    OutPose.ServerTime = ServerTime;
+    OutPose.Location = FMath::Lerp(Before.Location, After.Location, Alpha);
+    OutPose.Yaw = Before.Yaw + FMath::FindDeltaAngleDegrees(Before.Yaw, After.Yaw) * Alpha;
+    OutPose.HalfHeight = FMath::Lerp(Before.HalfHeight, After.HalfHeight, Alpha);
+    OutPose.Radius = FMath::Lerp(Before.Radius, After.Radius, Alpha);
+
+    // Режим движения не интерполируется – берём ближайший тик
+    const FTDSLagCompensationPose& Nearest = Alpha < 0.5f ? Before : After;
+    OutPose.MovementMode = Nearest.MovementMode;
+    OutPose.CustomMovementMode = Nearest.CustomMovementMode;
+    return true;
+}
+
+bool UTDSLagCompensationComponent::RewindLineTest(double ServerTime, const FVector& Start, const FVector& End, FVector& OutHitLocation) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_TDSLagCompRewind);
+
+    FTDSLagCompensationPose Pose;
+    if (!GetPoseAtTime(ServerTime, Pose))
+    {
+        return false;
+    }
+
+    // Капсула персонажа всегда вертикальна: ось – отрезок между центрами полусфер
+    const FVector AxisOffset(0.0, 0.0, FMath::Max(Pose.HalfHeight - Pose.Radius, 0.0f));
+    FVector OnAxis;
+    FMath::SegmentDistToSegmentSafe(Pose.Location - AxisOffset, Pose.Location + AxisOffset, Start, End, OnAxis, OutHitLocation);
+    const bool bHit = FVector::DistSquared(OnAxis, OutHitLocation) <= FMath::Square(Pose.Radius);
+
+#if ENABLE_DRAW_DEBUG
+    if (TDSLagCompensation::CVarDebug.GetValueOnGameThread())
+    {
+        DrawDebugCapsule(GetWorld(), Pose.Location, Pose.HalfHeight, Pose.Radius, FQuat::Identity,
+            bHit ? FColor::Red : FColor::Green, false, 2.0f);
+        DrawDebugLine(GetWorld(), Start, End, FColor::Yellow, false, 2.0f);
+    }
+#endif
+
+    return bHit;
+}
@@ -0,0 +1,93 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "TDSLagCompensationComponent.generated.h"
+
+/** Поза капсулы персонажа на момент серверного тика */
+USTRUCT(BlueprintType)
+struct FTDSLagCompensationPose
+{
+    GENERATED_BODY()
+
+    /** Время мира сервера (GetTimeSeconds) */
+    UPROPERTY(BlueprintReadOnly, Category = "TDS Lag Compensation")
+    double ServerTime = 0.0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "TDS Lag Compensation")
+    FVector Location = FVector::ZeroVector;
+
+    UPROPERTY(BlueprintReadOnly, Category = "TDS Lag Compensation")
+    float Yaw = 0.0f;
+
+    /** Размер капсулы с учётом слайда/лёжа (SetCapsuleSize) */
+    UPROPERTY(BlueprintReadOnly, Category = "TDS Lag Compensation")
+    float HalfHeight = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "TDS Lag Compensation")
+    float Radius = 0.0f;
+
+    /** EMovementMode и ETDSCustomMovementMode на момент записи */
+    UPROPERTY(BlueprintReadOnly, Category = "TDS Lag Compensation")
+    uint8 MovementMode = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "TDS Lag Compensation")
+    uint8 CustomMovementMode = 0;
+};
+
+/**
+ * История поз капсулы персонажа для серверной проверки попаданий с учётом пинга.
+ * Тикает только на сервере после физики и пишет позу в кольцевой буфер фиксированной ёмкости,
+ * выделенный один раз в BeginPlay, – память на персонажа ограничена HistoryCapacity.
+ * Поиск позы на момент времени – бинарный поиск по буферу постоянного размера плюс интерполяция
+ * между соседними тиками, поэтому стоимость запроса не зависит от длины матча.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class TOPDOWNSHOOTER_API UTDSLagCompensationComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UTDSLagCompensationComponent();
+
+    virtual void BeginPlay() override;
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+    /**
+     * Поза на момент ServerTime (интерполяция между записанными тиками).
+     * @return false, если время вне окна истории или TDS.LagCompensation.MaxRewindMs
+     */
+    bool GetPoseAtTime(double ServerTime, FTDSLagCompensationPose& OutPose) const;
+
+    /**
+     * Пересекает ли отрезок Start–End капсулу персонажа в том виде, в каком она была на ServerTime.
+     * @param OutHitLocation  точка отрезка, ближайшая к оси капсулы
+     */
+    UFUNCTION(BlueprintCallable, Category = "TDS Lag Compensation")
+    bool RewindLineTest(double ServerTime, const FVector& Start, const FVector& End, FVector& OutHitLocation) const;
+
+    /** Самое раннее время, на которое можно откатиться */
+    double GetOldestTime() const;
+
+protected:
+    /** Ёмкость истории в тиках сервера; 64 тика покрывают ~500 мс при 120 Гц и ~2 с при 30 Гц */
+    UPROPERTY(EditDefaultsOnly, Category = "TDS Lag Compensation", meta = (ClampMin = "8", ClampMax = "256"))
+    int32 HistoryCapacity = 64;
+
+private:
+    TArray<FTDSLagCompensationPose> History;
+
+    /** Индекс самой новой записи и число заполненных слотов */
+    int32 Head = INDEX_NONE;
+    int32 Count = 0;
+
+    /** Запись с логическим индексом Age (0 – самая старая) */
+    const FTDSLagCompensationPose& GetByAge(int32 Age) const
+    {
+        return History[(Head - Count + 1 + Age + History.Num()) % History.Num()];
+    }
+
+    void RecordPose();
+};
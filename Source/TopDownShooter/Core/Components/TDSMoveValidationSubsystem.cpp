@@ -0,0 +1,167 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSMoveValidationSubsystem.h"
+#include "TDSCharacterMovementComponent.h"
+#include "TDSStats.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+#include "UObject/UObjectIterator.h"
+
+DECLARE_CYCLE_STAT(TEXT("TDS Move Validation"), STAT_TDSMoveValidation, STATGROUP_TDS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("TDS Validated Moves"), STAT_TDSValidatedMoves, STATGROUP_TDS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("TDS Move Violations"), STAT_TDSMoveViolations, STATGROUP_TDS);
+
+namespace TDSMoveValidation
+{
+    static TAutoConsoleVariable<bool> CVarEnabled(
+        TEXT("TDS.MoveValidation.Enabled"), true,
+        TEXT("Проверка клиентских ходов по огибающей скорости на сервере."));
+
+    static TAutoConsoleVariable<float> CVarSpeedTolerance(
+        TEXT("TDS.MoveValidation.SpeedTolerance"), 1.1f,
+        TEXT("Множитель к разрешённой скорости."));
+
+    static TAutoConsoleVariable<float> CVarSlack(
+        TEXT("TDS.MoveValidation.Slack"), 15.0f,
+        TEXT("Допуск на расхождение позиций клиента и сервера, см."));
+
+    static FAutoConsoleCommandWithWorld ReportCommand(
+        TEXT("TDS.MoveValidation.Report"),
+        TEXT("Вывести статистику проверки ходов и персонажей с нарушениями."),
+        FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            const UTDSMoveValidationSubsystem* Validation = World ? World->GetSubsystem<UTDSMoveValidationSubsystem>() : nullptr;
+            if (!Validation)
+            {
+                return;
+            }
+
+            const UTDSMoveValidationSubsystem::FStats& Stats = Validation->GetStats();
+            UE_LOG(LogTemp, Display, TEXT("TDS.MoveValidation: %llu moves, %llu skipped, %llu speed violations, %llu slide violations"),
+                Stats.Moves, Stats.Skipped, Stats.SpeedViolations, Stats.SlideViolations);
+
+            for (TObjectIterator<UTDSCharacterMovementComponent> It; It; ++It)
+            {
+                if (It->GetWorld() == World && It->GetMoveViolations() > 0)
+                {
+                    UE_LOG(LogTemp, Display, TEXT("  %s: %u"), *GetNameSafe(It->GetPawnOwner()), It->GetMoveViolations());
+                }
+            }
+        }));
+}
+
+bool UTDSMoveValidationSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    if (!Super::ShouldCreateSubsystem(Outer))
+    {
+        return false;
+    }
+
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld();
+}
+
+TStatId UTDSMoveValidationSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UTDSMoveValidationSubsystem, STATGROUP_Tickables);
+}
+
+void UTDSMoveValidationSubsystem::QueueMove(UTDSCharacterMovementComponent& MoveComp, ETDSMoveEnvelopeSlot Slot, float DeltaTime,
+    const FVector& ServerLocation, const FVector& ClientLocation)
+{
+    if (!TDSMoveValidation::CVarEnabled.GetValueOnGameThread() || DeltaTime <= 0.0f)
+    {
+        SkipMove();
+        return;
+    }
+
+    FTDSMoveValidationState& State = MoveComp.MoveValidationState;
+    const FTDSMoveEnvelope& Envelope = State.Envelope;
+
+    uint8 Reason = Reason_None;
+    if (Slot == ETDSMoveEnvelopeSlot::Slide)
+    {
+        // Слайд тормозит с SlideDeceleration до MinSlideSpeed – держать полную скорость дольше нельзя
+        State.SlideSeconds += DeltaTime;
+        State.CarrySpeed = FMath::Max(Envelope.MinSlideSpeed,
+            Envelope.MaxSpeed[static_cast<int32>(Slot)] - Envelope.SlideDeceleration * State.SlideSeconds);
+        Reason = Reason_Slide;
+    }
+    else
+    {
+        // Скорость после более быстрого режима гаснет не мгновенно – не штрафуем переход sprint -> walk
+        State.SlideSeconds = 0.0f;
+        State.CarrySpeed = FMath::Max(Envelope.MaxSpeed[static_cast<int32>(Slot)],
+            State.CarrySpeed - Envelope.CarryDeceleration * DeltaTime);
+    }
+
+    const float Allowed = State.CarrySpeed * TDSMoveValidation::CVarSpeedTolerance.GetValueOnGameThread() * DeltaTime +
+        TDSMoveValidation::CVarSlack.GetValueOnGameThread();
+
+    DisplacementSq.Add(static_cast<float>(FVector::DistSquared2D(ServerLocation, ClientLocation)));
+    AllowedSq.Add(Allowed * Allowed);
+    SlotFlags.Add(Reason);
+    Owners.Add(&MoveComp);
+}
+
+void UTDSMoveValidationSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (!DisplacementSq.IsEmpty())
+    {
+        ValidatePending();
+    }
+}
+
+void UTDSMoveValidationSubsystem::ValidatePending()
+{
+    SCOPE_CYCLE_COUNTER(STAT_TDSMoveValidation);
+
+    const int32 Num = DisplacementSq.Num();
+    const float* RESTRICT Displacement = DisplacementSq.GetData();
+    const float* RESTRICT Allowed = AllowedSq.GetData();
+    const uint8* RESTRICT Flags = SlotFlags.GetData();
+
+    // Плотный проход без ветвлений – компилятор векторизует его
+    Violations.SetNumUninitialized(Num, EAllowShrinking::No);
+    uint8* RESTRICT Reason = Violations.GetData();
+    uint32 AnyViolation = 0;
+    for (int32 Index = 0; Index < Num; ++Index)
+    {
+        const uint8 bExceeded = Displacement[Index] > Allowed[Index];
+        Reason[Index] = bExceeded * (Reason_Speed | Flags[Index]);
+        AnyViolation |= bExceeded;
+    }
+
+    Stats.Moves += Num;
+    INC_DWORD_STAT_BY(STAT_TDSValidatedMoves, Num);
+
+    if (AnyViolation)
+    {
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            if (Reason[Index] == Reason_None)
+            {
+                continue;
+            }
+
+            Stats.SpeedViolations += (Reason[Index] & Reason_Speed) != 0;
+            Stats.SlideViolations += (Reason[Index] & Reason_Slide) != 0;
+            FTDSPerfCounters::Get().CountMoveViolation();
+            INC_DWORD_STAT(STAT_TDSMoveViolations);
+
+            if (UTDSCharacterMovementComponent* MoveComp = Owners[Index].Get())
+            {
+                ++MoveComp->MoveValidationState.Violations;
+                UE_LOG(LogTemp, Verbose, TEXT("TDS.MoveValidation: %s moved %.0f cm, allowed %.0f cm (reason %d)"),
+                    *GetNameSafe(MoveComp->GetPawnOwner()), FMath::Sqrt(Displacement[Index]), FMath::Sqrt(Allowed[Index]), Reason[Index]);
+            }
+        }
+    }
+
+    DisplacementSq.Reset();
+    AllowedSq.Reset();
+    SlotFlags.Reset();
+    Owners.Reset();
+}
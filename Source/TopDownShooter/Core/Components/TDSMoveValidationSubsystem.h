@@ -0,0 +1,115 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TDSMoveValidationSubsystem.generated.h"
+
+class UTDSCharacterMovementComponent;
+
+/** Ячейка огибающей скорости, выбирается по состоянию сервера после хода (GetMoveEnvelopeSlot) */
+enum class ETDSMoveEnvelopeSlot : uint8
+{
+    Walk,
+    Run,
+    Sprint,
+    Crouch,
+    Slide,
+    Prone,
+    WallRun,
+    Air,
+
+    Count
+};
+
+/** Предрасчитанные пределы скорости персонажа (UTDSCharacterMovementComponent::RefreshMoveEnvelope) */
+struct FTDSMoveEnvelope
+{
+    /** Максимальная горизонтальная скорость по ячейкам, см/с */
+    float MaxSpeed[static_cast<int32>(ETDSMoveEnvelopeSlot::Count)] = {};
+
+    /** Торможение слайда и скорость, ниже которой PhysSliding её не опускает */
+    float SlideDeceleration = 0.0f;
+    float MinSlideSpeed = 0.0f;
+
+    /** Нижняя оценка торможения: с такой скоростью «набранная» скорость гаснет при смене режима, см/с^2 */
+    float CarryDeceleration = 0.0f;
+};
+
+/** Состояние проверки одного персонажа; живёт в компоненте движения */
+struct FTDSMoveValidationState
+{
+    FTDSMoveEnvelope Envelope;
+
+    /** Разрешённая скорость с учётом инерции после более быстрого режима */
+    float CarrySpeed = 0.0f;
+
+    /** Сколько секунд персонаж подряд в слайде: разрешённая скорость слайда гаснет от MaxSpeed[Slide] до MinSlideSpeed */
+    float SlideSeconds = 0.0f;
+
+    /** Число ходов с нарушениями */
+    uint32 Violations = 0;
+};
+
+/**
+ * Серверная проверка клиентских ходов по огибающей скорости TDS.
+ * Компоненты движения ставят каждый полученный ход в очередь (QueueMove), а подсистема раз в кадр
+ * проверяет все ходы всех соединений одним плотным проходом по SoA-массивам.
+ * Нарушения только считаются (stat TDS, TDS.MoveValidation.Report, GetViolations у компонента);
+ * коррекцию позиции по-прежнему делает стандартный ServerCheckClientError.
+ */
+UCLASS()
+class TOPDOWNSHOOTER_API UTDSMoveValidationSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    struct FStats
+    {
+        uint64 Moves = 0;
+        uint64 Skipped = 0;
+        uint64 SpeedViolations = 0;
+
+        /** Подмножество SpeedViolations: превышение во время слайда («вечный» слайд на полной скорости) */
+        uint64 SlideViolations = 0;
+    };
+
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    /**
+     * Поставить ход в очередь проверки.
+     * @param ServerLocation  позиция персонажа на сервере до выполнения хода
+     * @param ClientLocation  заявленная клиентом позиция после хода
+     */
+    void QueueMove(UTDSCharacterMovementComponent& MoveComp, ETDSMoveEnvelopeSlot Slot, float DeltaTime,
+        const FVector& ServerLocation, const FVector& ClientLocation);
+
+    /** Ход без проверки (относительная позиция на подвижной базе и т.п.) */
+    void SkipMove() { ++Stats.Moves; ++Stats.Skipped; }
+
+    const FStats& GetStats() const { return Stats; }
+
+private:
+    enum EReason : uint8
+    {
+        Reason_None = 0,
+        Reason_Speed = 1 << 0,
+        Reason_Slide = 1 << 1,
+    };
+
+    /** Ходы текущего кадра (SoA) */
+    TArray<float> DisplacementSq;
+    TArray<float> AllowedSq;
+    TArray<uint8> SlotFlags;
+
+    /** Результат проверки кадра, параллелен массивам выше */
+    TArray<uint8> Violations;
+    TArray<TWeakObjectPtr<UTDSCharacterMovementComponent>> Owners;
+
+    FStats Stats;
+
+    void ValidatePending();
+};
@@ -0,0 +1,240 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSMovementCompression.h"
+#include "Engine/Level.h"
+#include "Engine/LevelBounds.h"
+#include "Engine/NetSerialization.h"
+#include "Engine/World.h"
+
+namespace TDSMovementCompression
+{
+    /** Шаг и разрядность осей положения относительно начала координат уровня */
+    static constexpr float PlanarScale = 1.0f;
+    static constexpr int32 PlanarBits = 16;
+    static constexpr float HeightScale = 1.0f;
+    static constexpr int32 HeightBits = 12;
+
+    /** Поворот: 1024 шага на оборот */
+    static constexpr int32 AxisBits = 10;
+
+    /** Скорость: 2 см/с, ±4094 см/с */
+    static constexpr float VelocityScale = 0.5f;
+    static constexpr int32 VelocityBits = 12;
+
+    /** Ускорение: 0.1 см/с², ±13107 см/с² */
+    static constexpr float AccelerationScale = 10.0f;
+    static constexpr int32 AccelerationBits = 18;
+
+    static int32 MaxMagnitude(int32 NumBits)
+    {
+        return (1 << (NumBits - 1)) - 1;
+    }
+
+    static bool FitsBits(double Value, float Scale, int32 NumBits)
+    {
+        return FMath::Abs(FMath::RoundToDouble(Value * Scale)) <= MaxMagnitude(NumBits);
+    }
+
+    /** Значение на сетке Scale, ограниченное разрядностью – ровно то, что прочитает SerializeScaled */
+    static double Quantize(double Value, float Scale, int32 NumBits)
+    {
+        const double Limit = MaxMagnitude(NumBits);
+        return FMath::Clamp(FMath::RoundToDouble(Value * Scale), -Limit, Limit) / Scale;
+    }
+
+    /** Знаковое целое фиксированной разрядности со смещением */
+    static void SerializeFixed(FArchive& Ar, int32& Value, int32 NumBits)
+    {
+        const int32 Bias = 1 << (NumBits - 1);
+        uint32 Packed = Ar.IsSaving() ? static_cast<uint32>(FMath::Clamp(Value, -Bias + 1, Bias - 1) + Bias) : 0;
+        Ar.SerializeBits(&Packed, NumBits);
+        Value = static_cast<int32>(Packed) - Bias;
+    }
+
+    static void SerializeScaled(FArchive& Ar, FVector::FReal& Value, float Scale, int32 NumBits)
+    {
+        int32 Quantized = Ar.IsSaving() ? static_cast<int32>(FMath::RoundToDouble(Value * Scale)) : 0;
+        SerializeFixed(Ar, Quantized, NumBits);
+        Value = Quantized / Scale;
+    }
+
+    static bool IsCompactLocation(const FVector& Location)
+    {
+        return FitsBits(Location.X, PlanarScale, PlanarBits)
+            && FitsBits(Location.Y, PlanarScale, PlanarBits)
+            && FitsBits(Location.Z, HeightScale, HeightBits);
+    }
+
+    FVector GetLevelOrigin(const UWorld* World)
+    {
+        const ALevelBounds* LevelBounds = World && World->PersistentLevel ? World->PersistentLevel->LevelBoundsActor.Get() : nullptr;
+        if (!LevelBounds)
+        {
+            return FVector::ZeroVector;
+        }
+
+        const FBox Box = LevelBounds->GetComponentsBoundingBox();
+        if (!Box.IsValid)
+        {
+            return FVector::ZeroVector;
+        }
+
+        const FVector Center = Box.GetCenter();
+        return FVector(Center.X, Center.Y, Box.Min.Z);
+    }
+
+    FVector QuantizeLocation(const FVector& Location)
+    {
+        if (!IsCompactLocation(Location))
+        {
+            return FVector(
+                FMath::RoundToDouble(Location.X * 100.0) / 100.0,
+                FMath::RoundToDouble(Location.Y * 100.0) / 100.0,
+                FMath::RoundToDouble(Location.Z * 100.0) / 100.0);
+        }
+
+        return FVector(
+            Quantize(Location.X, PlanarScale, PlanarBits),
+            Quantize(Location.Y, PlanarScale, PlanarBits),
+            Quantize(Location.Z, HeightScale, HeightBits));
+    }
+
+    void SerializeLocation(FArchive& Ar, FVector& Location)
+    {
+        uint8 bCompact = Ar.IsSaving() ? IsCompactLocation(Location) : 0;
+        Ar.SerializeBits(&bCompact, 1);
+
+        if (!bCompact)
+        {
+            FVector_NetQuantize100 Full(Location);
+            bool bSuccess = true;
+            Full.NetSerialize(Ar, nullptr, bSuccess);
+            Location = Full;
+            return;
+        }
+
+        SerializeScaled(Ar, Location.X, PlanarScale, PlanarBits);
+        SerializeScaled(Ar, Location.Y, PlanarScale, PlanarBits);
+        SerializeScaled(Ar, Location.Z, HeightScale, HeightBits);
+    }
+
+    static uint32 CompressAxis(double Angle)
+    {
+        constexpr int32 Steps = 1 << AxisBits;
+        return static_cast<uint32>(FMath::RoundToInt(FRotator::ClampAxis(Angle) * Steps / 360.0)) & (Steps - 1);
+    }
+
+    static double DecompressAxis(uint32 Packed)
+    {
+        return Packed * 360.0 / (1 << AxisBits);
+    }
+
+    double QuantizeAxis(double Angle)
+    {
+        return DecompressAxis(CompressAxis(Angle));
+    }
+
+    void SerializeAxis(FArchive& Ar, double& Angle)
+    {
+        uint32 Packed = Ar.IsSaving() ? CompressAxis(Angle) : 0;
+        Ar.SerializeBits(&Packed, AxisBits);
+        Angle = DecompressAxis(Packed);
+    }
+
+    FVector QuantizeVelocity(const FVector& Velocity, bool bPlanar)
+    {
+        return FVector(
+            Quantize(Velocity.X, VelocityScale, VelocityBits),
+            Quantize(Velocity.Y, VelocityScale, VelocityBits),
+            bPlanar ? 0.0 : Quantize(Velocity.Z, VelocityScale, VelocityBits));
+    }
+
+    void SerializeVelocity(FArchive& Ar, FVector& Velocity, bool bPlanar)
+    {
+        SerializeScaled(Ar, Velocity.X, VelocityScale, VelocityBits);
+        SerializeScaled(Ar, Velocity.Y, VelocityScale, VelocityBits);
+
+        if (bPlanar)
+        {
+            Velocity.Z = 0.0;
+        }
+        else
+        {
+            SerializeScaled(Ar, Velocity.Z, VelocityScale, VelocityBits);
+        }
+    }
+
+    void SerializeAcceleration(FArchive& Ar, FVector& Acceleration)
+    {
+        SerializeScaled(Ar, Acceleration.X, AccelerationScale, AccelerationBits);
+        SerializeScaled(Ar, Acceleration.Y, AccelerationScale, AccelerationBits);
+
+        // Ввод персонажа на земле лежит в плоскости (ConstrainInputAcceleration) – Z почти всегда ноль
+        uint8 bHasZ = Ar.IsSaving() ? FMath::RoundToDouble(Acceleration.Z * AccelerationScale) != 0.0 : 0;
+        Ar.SerializeBits(&bHasZ, 1);
+        if (bHasZ)
+        {
+            SerializeScaled(Ar, Acceleration.Z, AccelerationScale, AccelerationBits);
+        }
+        else
+        {
+            Acceleration.Z = 0.0;
+        }
+    }
+}
+
+void FTDSRepMovement::FromRepMovement(const FRepMovement& RepMovement, bool bInGrounded, const FVector& LevelOrigin)
+{
+    bGrounded = bInGrounded;
+    Location = TDSMovementCompression::QuantizeLocation(RepMovement.Location - LevelOrigin);
+
+    Rotation.Yaw = TDSMovementCompression::QuantizeAxis(RepMovement.Rotation.Yaw);
+    Rotation.Pitch = TDSMovementCompression::QuantizeAxis(RepMovement.Rotation.Pitch);
+    Rotation.Roll = TDSMovementCompression::QuantizeAxis(RepMovement.Rotation.Roll);
+
+    LinearVelocity = TDSMovementCompression::QuantizeVelocity(RepMovement.LinearVelocity, bGrounded);
+}
+
+void FTDSRepMovement::ToRepMovement(FRepMovement& RepMovement, const FVector& LevelOrigin) const
+{
+    RepMovement.Location = Location + LevelOrigin;
+    RepMovement.Rotation = Rotation;
+    RepMovement.LinearVelocity = LinearVelocity;
+    RepMovement.AngularVelocity = FVector::ZeroVector;
+    RepMovement.bRepPhysics = false;
+    RepMovement.bSimulatedPhysicSleep = false;
+}
+
+bool FTDSRepMovement::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    uint8 Flags = Ar.IsSaving() ? (bGrounded ? 1 : 0) : 0;
+
+    // Pitch/roll у персонажа вида сверху обычно нулевые – одним битом
+    const bool bHasPitchRoll = !FMath::IsNearlyZero(Rotation.Pitch) || !FMath::IsNearlyZero(Rotation.Roll);
+    if (Ar.IsSaving() && bHasPitchRoll)
+    {
+        Flags |= 2;
+    }
+    Ar.SerializeBits(&Flags, 2);
+    bGrounded = (Flags & 1) != 0;
+
+    TDSMovementCompression::SerializeLocation(Ar, Location);
+
+    TDSMovementCompression::SerializeAxis(Ar, Rotation.Yaw);
+
+    if (Flags & 2)
+    {
+        TDSMovementCompression::SerializeAxis(Ar, Rotation.Pitch);
+        TDSMovementCompression::SerializeAxis(Ar, Rotation.Roll);
+    }
+    else
+    {
+        Rotation.Pitch = 0.0;
+        Rotation.Roll = 0.0;
+    }
+
+    TDSMovementCompression::SerializeVelocity(Ar, LinearVelocity, bGrounded);
+
+    bOutSuccess = !Ar.IsError();
+    return true;
+}
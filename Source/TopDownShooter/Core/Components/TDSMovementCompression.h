@@ -0,0 +1,91 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/ReplicatedState.h"
+#include "TDSMovementCompression.generated.h"
+
+class UWorld;
+
+/**
+ * Сжатие движения для вида сверху (2.5D).
+ * Положение пишется относительно начала координат уровня (GetLevelOrigin), поэтому значения малы:
+ *   XY  – 1 см, 16 бит на ось (±327 м от центра уровня);
+ *   Z   – 1 см, 12 бит (±20 м от пола уровня);
+ *   поворот – yaw 10 бит (0.35°), pitch/roll отправляются лишь если не нулевые;
+ *   скорость – XY с шагом 2 см/с по 12 бит (±40 м/с), Z только в воздухе.
+ * Положения вне диапазона отправляются в исходном формате движка (FVector_NetQuantize100) с битом-признаком.
+ * Размер против FRepMovement проверяет тест TopDownShooter.Net.PlanarMovementCompression.
+ */
+namespace TDSMovementCompression
+{
+    /**
+     * Начало координат сжатого формата: центр границ уровня (ALevelBounds) по XY и их нижняя грань по Z.
+     * Границы сохранены в пакете уровня и одинаковы у сервера и клиентов; без них – начало координат мира.
+     */
+    TOPDOWNSHOOTER_API FVector GetLevelOrigin(const UWorld* World);
+
+    /** Округлить положение относительно GetLevelOrigin до сетки сжатого формата (то, что получит принимающая сторона) */
+    TOPDOWNSHOOTER_API FVector QuantizeLocation(const FVector& Location);
+
+    /** Положение относительно GetLevelOrigin: XY и Z по 1 см или исходный формат вне диапазона */
+    TOPDOWNSHOOTER_API void SerializeLocation(FArchive& Ar, FVector& Location);
+
+    /** Округлить угол до шага сжатого формата */
+    TOPDOWNSHOOTER_API double QuantizeAxis(double Angle);
+
+    /** Угол поворота в 10 битах */
+    TOPDOWNSHOOTER_API void SerializeAxis(FArchive& Ar, double& Angle);
+
+    /** Округлить скорость до шага сжатого формата; при bPlanar Z обнуляется */
+    TOPDOWNSHOOTER_API FVector QuantizeVelocity(const FVector& Velocity, bool bPlanar);
+
+    /** Скорость с шагом 2 см/с; Z пишется только при bPlanar == false */
+    TOPDOWNSHOOTER_API void SerializeVelocity(FArchive& Ar, FVector& Velocity, bool bPlanar);
+
+    /** Ускорение клиента с точностью FVector_NetQuantize10 (0.1), Z – только если не нулевое */
+    TOPDOWNSHOOTER_API void SerializeAcceleration(FArchive& Ar, FVector& Acceleration);
+}
+
+/**
+ * ReplicatedMovement персонажа в формате TDSMovementCompression.
+ * Значения хранятся уже округлёнными, поэтому сравнение свойств не замечает изменений мельче шага сетки
+ * и лишних отправок не бывает. См. ATDSCharacter::PreReplication.
+ */
+USTRUCT()
+struct TOPDOWNSHOOTER_API FTDSRepMovement
+{
+    GENERATED_BODY()
+
+    /** Относительно TDSMovementCompression::GetLevelOrigin */
+    UPROPERTY()
+    FVector Location = FVector::ZeroVector;
+
+    UPROPERTY()
+    FRotator Rotation = FRotator::ZeroRotator;
+
+    UPROPERTY()
+    FVector LinearVelocity = FVector::ZeroVector;
+
+    /** На полу: вертикальная скорость не отправляется */
+    UPROPERTY()
+    bool bGrounded = false;
+
+    /** Снять и округлить движение, собранное движком в GatherCurrentMovement */
+    void FromRepMovement(const FRepMovement& RepMovement, bool bInGrounded, const FVector& LevelOrigin);
+
+    /** Записать в ReplicatedMovement актора на принимающей стороне */
+    void ToRepMovement(FRepMovement& RepMovement, const FVector& LevelOrigin) const;
+
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FTDSRepMovement> : public TStructOpsTypeTraitsBase2<FTDSRepMovement>
+{
+    enum
+    {
+        WithNetSerializer = true,
+    };
+};
@@ -0,0 +1,241 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSServerGovernorSubsystem.h"
+#include "TDSCharacterMovementComponent.h"
+#include "TDSStats.h"
+#include "GameFramework/Character.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("TDS Governor Level"), STAT_TDSGovernorLevel, STATGROUP_TDS);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("TDS Governor Work Ms"), STAT_TDSGovernorWorkMs, STATGROUP_TDS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("TDS Governor Reduced Substeps"), STAT_TDSGovernorReducedSubsteps, STATGROUP_TDS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("TDS Governor Reduced NetUpdate"), STAT_TDSGovernorReducedNetUpdate, STATGROUP_TDS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("TDS Governor Suppressed Events"), STAT_TDSGovernorSuppressedEvents, STATGROUP_TDS);
+
+namespace TDSGovernor
+{
+    static TAutoConsoleVariable<bool> CVarEnabled(
+        TEXT("TDS.Governor.Enabled"), true,
+        TEXT("Снижать точность движения при перегрузке сервера."));
+
+    static TAutoConsoleVariable<float> CVarBudgetMs(
+        TEXT("TDS.Governor.BudgetMs"), 25.0f,
+        TEXT("Бюджет времени работы кадра сервера, мс."));
+
+    static TAutoConsoleVariable<float> CVarEscalateSeconds(
+        TEXT("TDS.Governor.EscalateSeconds"), 1.0f,
+        TEXT("Сколько секунд кадр должен превышать бюджет до повышения уровня."));
+
+    static TAutoConsoleVariable<float> CVarRestoreSeconds(
+        TEXT("TDS.Governor.RestoreSeconds"), 3.0f,
+        TEXT("Сколько секунд кадр должен укладываться в RestoreRatio бюджета до понижения уровня."));
+
+    static TAutoConsoleVariable<float> CVarRestoreRatio(
+        TEXT("TDS.Governor.RestoreRatio"), 0.7f,
+        TEXT("Доля бюджета, ниже которой считается, что запас вернулся."));
+
+    static TAutoConsoleVariable<float> CVarFarDistance(
+        TEXT("TDS.Governor.FarDistance"), 4000.0f,
+        TEXT("Персонаж дальше этого расстояния от остальных игроков считается дальним, см."));
+
+    static TAutoConsoleVariable<float> CVarFarMaxTimeStep(
+        TEXT("TDS.Governor.FarMaxTimeStep"), 0.1f,
+        TEXT("MaxSimulationTimeStep дальних персонажей на уровне ReducedSubsteps."));
+
+    static TAutoConsoleVariable<int32> CVarFarMaxIterations(
+        TEXT("TDS.Governor.FarMaxIterations"), 2,
+        TEXT("MaxSimulationIterations дальних персонажей на уровне ReducedSubsteps."));
+
+    static TAutoConsoleVariable<float> CVarIdleSpeed(
+        TEXT("TDS.Governor.IdleSpeed"), 10.0f,
+        TEXT("Персонаж без ускорения и медленнее этой скорости считается стоящим, см/с."));
+
+    static TAutoConsoleVariable<float> CVarIdleNetUpdateFrequency(
+        TEXT("TDS.Governor.IdleNetUpdateFrequency"), 10.0f,
+        TEXT("NetUpdateFrequency стоящих персонажей на уровне ReducedNetUpdate."));
+
+    /** Период переклассификации персонажей, сек */
+    static constexpr float ReapplyInterval = 0.25f;
+
+    /** Вес нового кадра в экспоненциальном сглаживании */
+    static constexpr float SmoothingAlpha = 0.1f;
+}
+
+bool UTDSServerGovernorSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    if (!Super::ShouldCreateSubsystem(Outer))
+    {
+        return false;
+    }
+
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld();
+}
+
+void UTDSServerGovernorSubsystem::Deinitialize()
+{
+    SetLevel(ETDSGovernorLevel::Full);
+    MoveComps.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UTDSServerGovernorSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UTDSServerGovernorSubsystem, STATGROUP_Tickables);
+}
+
+const TCHAR* UTDSServerGovernorSubsystem::LexLevel(ETDSGovernorLevel InLevel)
+{
+    switch (InLevel)
+    {
+    case ETDSGovernorLevel::Full:             return TEXT("Full");
+    case ETDSGovernorLevel::ReducedSubsteps:  return TEXT("ReducedSubsteps");
+    case ETDSGovernorLevel::ReducedNetUpdate: return TEXT("ReducedNetUpdate");
+    case ETDSGovernorLevel::NoMovementEvents: return TEXT("NoMovementEvents");
+    default:                                  return TEXT("Unknown");
+    }
+}
+
+float UTDSServerGovernorSubsystem::GetFarMaxTimeStep()
+{
+    return TDSGovernor::CVarFarMaxTimeStep.GetValueOnGameThread();
+}
+
+int32 UTDSServerGovernorSubsystem::GetFarMaxIterations()
+{
+    return FMath::Max(TDSGovernor::CVarFarMaxIterations.GetValueOnGameThread(), 1);
+}
+
+float UTDSServerGovernorSubsystem::GetIdleNetUpdateFrequency()
+{
+    return TDSGovernor::CVarIdleNetUpdateFrequency.GetValueOnGameThread();
+}
+
+void UTDSServerGovernorSubsystem::Register(UTDSCharacterMovementComponent& MoveComp)
+{
+    MoveComps.AddUnique(&MoveComp);
+    ReapplyTimer = 0.0f;
+}
+
+void UTDSServerGovernorSubsystem::Unregister(UTDSCharacterMovementComponent& MoveComp)
+{
+    MoveComp.ApplyGovernorState(false, false, false);
+    MoveComps.RemoveSwap(&MoveComp);
+}
+
+void UTDSServerGovernorSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    // Только выделенный сервер: у listen-сервера и standalone в работу кадра входит отрисовка,
+    // и регулятор снижал бы точность движения из-за нагрузки на рендер, а не на симуляцию
+    if (GetWorld()->GetNetMode() != NM_DedicatedServer)
+    {
+        SetLevel(ETDSGovernorLevel::Full);
+        return;
+    }
+
+    if (!TDSGovernor::CVarEnabled.GetValueOnGameThread())
+    {
+        SetLevel(ETDSGovernorLevel::Full);
+        return;
+    }
+
+    // Работа кадра без сна до NetServerMaxTickRate
+    const float WorkMs = static_cast<float>(FMath::Max(FApp::GetDeltaTime() - FApp::GetIdleTime(), 0.0) * 1000.0);
+    SmoothedWorkMs = SmoothedWorkMs > 0.0f ? FMath::Lerp(SmoothedWorkMs, WorkMs, TDSGovernor::SmoothingAlpha) : WorkMs;
+
+    const float BudgetMs = TDSGovernor::CVarBudgetMs.GetValueOnGameThread();
+    OverBudgetSeconds = SmoothedWorkMs > BudgetMs ? OverBudgetSeconds + DeltaTime : 0.0f;
+    UnderBudgetSeconds = SmoothedWorkMs < BudgetMs * TDSGovernor::CVarRestoreRatio.GetValueOnGameThread() ? UnderBudgetSeconds + DeltaTime : 0.0f;
+
+    if (OverBudgetSeconds >= TDSGovernor::CVarEscalateSeconds.GetValueOnGameThread() && Level < ETDSGovernorLevel::Max)
+    {
+        SetLevel(static_cast<ETDSGovernorLevel>(static_cast<uint8>(Level) + 1));
+    }
+    else if (UnderBudgetSeconds >= TDSGovernor::CVarRestoreSeconds.GetValueOnGameThread() && Level > ETDSGovernorLevel::Full)
+    {
+        SetLevel(static_cast<ETDSGovernorLevel>(static_cast<uint8>(Level) - 1));
+    }
+
+    ReapplyTimer -= DeltaTime;
+    if (ReapplyTimer <= 0.0f)
+    {
+        ReapplyTimer = TDSGovernor::ReapplyInterval;
+        ApplyLevel();
+    }
+
+    SET_DWORD_STAT(STAT_TDSGovernorLevel, static_cast<uint32>(Level));
+    SET_FLOAT_STAT(STAT_TDSGovernorWorkMs, SmoothedWorkMs);
+}
+
+void UTDSServerGovernorSubsystem::SetLevel(ETDSGovernorLevel NewLevel)
+{
+    if (NewLevel == Level)
+    {
+        return;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("TDS.Governor: %s -> %s (work %.1f ms, budget %.1f ms, %d characters)"),
+        LexLevel(Level), LexLevel(NewLevel), SmoothedWorkMs, TDSGovernor::CVarBudgetMs.GetValueOnGameThread(), MoveComps.Num());
+
+    Level = NewLevel;
+    OverBudgetSeconds = 0.0f;
+    UnderBudgetSeconds = 0.0f;
+    ApplyLevel();
+}
+
+void UTDSServerGovernorSubsystem::ApplyLevel()
+{
+    MoveComps.RemoveAllSwap([](const TWeakObjectPtr<UTDSCharacterMovementComponent>& MoveComp)
+    {
+        return !MoveComp.IsValid();
+    });
+
+    const bool bReduceSubsteps = Level >= ETDSGovernorLevel::ReducedSubsteps;
+    const bool bReduceNetUpdate = Level >= ETDSGovernorLevel::ReducedNetUpdate;
+    const bool bSuppressEvents = Level >= ETDSGovernorLevel::NoMovementEvents;
+
+    // Позиции игроков для проверки «дальности» (десятки персонажей – перебор пар)
+    TArray<FVector, TInlineAllocator<64>> Locations;
+    if (bReduceSubsteps)
+    {
+        for (const TWeakObjectPtr<UTDSCharacterMovementComponent>& MoveComp : MoveComps)
+        {
+            const AActor* Owner = MoveComp->GetOwner();
+            Locations.Add(Owner ? Owner->GetActorLocation() : FVector(UE_BIG_NUMBER));
+        }
+    }
+
+    const float FarDistanceSq = FMath::Square(TDSGovernor::CVarFarDistance.GetValueOnGameThread());
+    const float IdleSpeedSq = FMath::Square(TDSGovernor::CVarIdleSpeed.GetValueOnGameThread());
+
+    uint32 NumReducedSubsteps = 0;
+    uint32 NumReducedNetUpdate = 0;
+    for (int32 Index = 0; Index < MoveComps.Num(); ++Index)
+    {
+        UTDSCharacterMovementComponent* MoveComp = MoveComps[Index].Get();
+
+        bool bFar = false;
+        if (bReduceSubsteps)
+        {
+            bFar = true;
+            for (int32 Other = 0; Other < Locations.Num() && bFar; ++Other)
+            {
+                bFar = Other == Index || FVector::DistSquared(Locations[Index], Locations[Other]) > FarDistanceSq;
+            }
+        }
+
+        const bool bIdle = bReduceNetUpdate && MoveComp->GetCurrentAcceleration().IsNearlyZero() && MoveComp->Velocity.SizeSquared() < IdleSpeedSq;
+
+        MoveComp->ApplyGovernorState(bFar, bIdle, bSuppressEvents);
+        NumReducedSubsteps += bFar;
+        NumReducedNetUpdate += bIdle;
+    }
+
+    SET_DWORD_STAT(STAT_TDSGovernorReducedSubsteps, NumReducedSubsteps);
+    SET_DWORD_STAT(STAT_TDSGovernorReducedNetUpdate, NumReducedNetUpdate);
+    SET_DWORD_STAT(STAT_TDSGovernorSuppressedEvents, bSuppressEvents ? MoveComps.Num() : 0);
+}
@@ -0,0 +1,80 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TDSServerGovernorSubsystem.generated.h"
+
+class UTDSCharacterMovementComponent;
+
+/** Уровни деградации; каждый включает все предыдущие */
+enum class ETDSGovernorLevel : uint8
+{
+    /** Полная точность */
+    Full,
+
+    /** Меньше подшагов симуляции у персонажей далеко от остальных игроков */
+    ReducedSubsteps,
+
+    /** Пониженный NetUpdateFrequency у стоящих персонажей */
+    ReducedNetUpdate,
+
+    /** Без Blueprint-событий OnMovementParametersUpdated/OnMovementCustomUpdated */
+    NoMovementEvents,
+
+    Max = NoMovementEvents
+};
+
+/**
+ * Регулятор нагрузки сервера.
+ * Следит за сглаженным временем работы кадра (без сна до NetServerMaxTickRate) относительно бюджета
+ * TDS.Governor.BudgetMs. Если бюджет превышен дольше EscalateSeconds – поднимает уровень на одну
+ * ступень, если кадр укладывается в RestoreRatio бюджета дольше RestoreSeconds – опускает.
+ * Каждое переключение пишется в лог, уровень и число затронутых персонажей видны в stat TDS.
+ * Работает только на выделенном сервере (NM_DedicatedServer); в остальных режимах уровень всегда Full.
+ */
+UCLASS()
+class TOPDOWNSHOOTER_API UTDSServerGovernorSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    /** Компоненты движения регистрируются на сервере в BeginPlay */
+    void Register(UTDSCharacterMovementComponent& MoveComp);
+    void Unregister(UTDSCharacterMovementComponent& MoveComp);
+
+    ETDSGovernorLevel GetLevel() const { return Level; }
+
+    static const TCHAR* LexLevel(ETDSGovernorLevel InLevel);
+
+    /** Значения, которые подставляются персонажам на пониженных уровнях */
+    static float GetFarMaxTimeStep();
+    static int32 GetFarMaxIterations();
+    static float GetIdleNetUpdateFrequency();
+
+private:
+    TArray<TWeakObjectPtr<UTDSCharacterMovementComponent>> MoveComps;
+
+    ETDSGovernorLevel Level = ETDSGovernorLevel::Full;
+
+    /** Сглаженное время работы кадра, мс */
+    float SmoothedWorkMs = 0.0f;
+
+    /** Сколько секунд подряд кадр выше бюджета / ниже порога восстановления */
+    float OverBudgetSeconds = 0.0f;
+    float UnderBudgetSeconds = 0.0f;
+
+    /** Таймер переклассификации персонажей (дальние/стоящие) */
+    float ReapplyTimer = 0.0f;
+
+    void SetLevel(ETDSGovernorLevel NewLevel);
+
+    /** Применить текущий уровень ко всем персонажам */
+    void ApplyLevel();
+};
@@ -1,6 +1,23 @@
 // Copyright 2025, CRAFTCODE, All Rights Reserved.
 
 #include "TDSPlayerController.h"
+#include "TDSPlayerCameraManager.h"
+#include "TDSStats.h"
+#include "WorldPartition/WorldPartitionStreamingSource.h"
+#include "DrawDebugHelpers.h"
+
+namespace TDSAim
+{
+	static TAutoConsoleVariable<bool> CVarAimDebugDraw(
+		TEXT("TDS.Aim.DebugDraw"), true,
+		TEXT("    ."));
+}
+
+ATDSPlayerController::ATDSPlayerController()
+{
+	//          
+	PlayerCameraManagerClass = ATDSPlayerCameraManager::StaticClass();
+}
 
 void ATDSPlayerController::BeginPlay()
 {
@@ -10,7 +27,14 @@ void ATDSPlayerController::BeginPlay()
 void ATDSPlayerController::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
-	UpdateControlRotation();
+
+	//       ;        
+#if !UE_SERVER
+	if (IsLocalController())
+	{
+		UpdateControlRotation();
+	}
+#endif
 }
 
 void ATDSPlayerController::UpdateControlRotation()
@@ -29,6 +53,7 @@ void ATDSPlayerController::UpdateControlRotation()
 
         FVector TargetLocation;
 
+        FTDSPerfCounters::Get().CountTrace();
         if (GetWorld()->LineTraceSingleByChannel(CursorHit, Start, End, ECC_Visibility, Params))
         {
             TargetLocation = CursorHit.ImpactPoint; //    
@@ -48,6 +73,7 @@ void ATDSPlayerController::UpdateControlRotation()
             FCollisionQueryParams ObstacleParams;
             ObstacleParams.AddIgnoredActor(ControlledPawn); //  
 
+            FTDSPerfCounters::Get().CountTrace();
             bool bHitObstacle = GetWorld()->LineTraceSingleByChannel(
                 ObstacleHit,
                 CharacterLocation,
@@ -68,10 +94,78 @@ void ATDSPlayerController::UpdateControlRotation()
 
             SetControlRotation(NewControlRotation);
 
+#if ENABLE_DRAW_DEBUG && !UE_SERVER
             // Debug  
-            DrawDebugLine(GetWorld(), CharacterLocation, TargetLocation, FColor::Red, false, 0.1f, 0, 2.0f);
-            DrawDebugPoint(GetWorld(), TargetLocation, 10.0f, FColor::Green, false, 0.1f);
+            if (TDSAim::CVarAimDebugDraw.GetValueOnGameThread())
+            {
+                DrawDebugLine(GetWorld(), CharacterLocation, TargetLocation, FColor::Red, false, 0.1f, 0, 2.0f);
+                DrawDebugPoint(GetWorld(), TargetLocation, 10.0f, FColor::Green, false, 0.1f);
+            }
+#endif
         }
     }
 }
 
+
+bool ATDSPlayerController::GetPredictiveViewRect(FTDSViewRect& OutViewRect) const
+{
+	if (!bUsePredictiveStreamingSource || !IsLocalController())
+	{
+		return false;
+	}
+
+	const ATDSPlayerCameraManager* CameraManager = Cast<ATDSPlayerCameraManager>(PlayerCameraManager);
+	if (!CameraManager || !CameraManager->GetViewRect().IsValid())
+	{
+		return false;
+	}
+
+	OutViewRect = CameraManager->GetViewRect();
+	return true;
+}
+
+void ATDSPlayerController::GetStreamingSourceLocationAndRotation(FVector& OutLocation, FRotator& OutRotation) const
+{
+	FTDSViewRect ViewRect;
+	if (!GetPredictiveViewRect(ViewRect))
+	{
+		Super::GetStreamingSourceLocationAndRotation(OutLocation, OutRotation);
+		return;
+	}
+
+	//        ,   
+	//        
+	const FVector2D Center = ViewRect.Rect.GetCenter();
+	OutLocation = FVector(Center.X, Center.Y, ViewRect.PlaneZ);
+	OutRotation = FRotator::ZeroRotator;
+}
+
+void ATDSPlayerController::GetStreamingSourceShapes(TArray<FStreamingSourceShape>& OutShapes) const
+{
+	FTDSViewRect ViewRect;
+	if (!GetPredictiveViewRect(ViewRect))
+	{
+		Super::GetStreamingSourceShapes(OutShapes);
+		return;
+	}
+
+	const float Radius = ViewRect.Rect.GetExtent().Size() * StreamingRadiusScale;
+
+	// 1.    (     )
+	FStreamingSourceShape& GridShape = OutShapes.AddDefaulted_GetRef();
+	GridShape.bUseGridLoadingRange = true;
+
+	FStreamingSourceShape& ViewShape = OutShapes.AddDefaulted_GetRef();
+	ViewShape.bUseGridLoadingRange = false;
+	ViewShape.Radius = Radius;
+
+	// 2. :   ,          
+	const FVector2D LookAhead = ViewRect.Velocity * StreamingLookAheadTime;
+	if (!LookAhead.IsNearlyZero())
+	{
+		FStreamingSourceShape& PredictedShape = OutShapes.AddDefaulted_GetRef();
+		PredictedShape.bUseGridLoadingRange = false;
+		PredictedShape.Radius = Radius;
+		PredictedShape.Location = FVector(LookAhead.X, LookAhead.Y, 0.0f);
+	}
+}
@@ -6,6 +6,8 @@
 #include "GameFramework/PlayerController.h"
 #include "TDSPlayerController.generated.h"
 
+struct FTDSViewRect;
+
 /**
  * 
  */
@@ -13,7 +15,10 @@ UCLASS()
 class TOPDOWNSHOOTER_API ATDSPlayerController : public APlayerController
 {
 	GENERATED_BODY()
-	
+
+public:
+	ATDSPlayerController();
+
 private:
 	virtual void BeginPlay() override;
 
@@ -21,4 +26,26 @@ public:
 	virtual void Tick(float DeltaTime) override;
 
 	void UpdateControlRotation();
+
+	/** Streaming source: центр видимого прямоугольника вместо точки обзора камеры */
+	virtual void GetStreamingSourceLocationAndRotation(FVector& OutLocation, FRotator& OutRotation) const override;
+
+	/** Streaming source: текущий прямоугольник + прямоугольник, сдвинутый по скорости на StreamingLookAheadTime */
+	virtual void GetStreamingSourceShapes(TArray<FStreamingSourceShape>& OutShapes) const override;
+
+	/** Использовать прогноз видимого прямоугольника как источник стриминга World Partition */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "World Partition")
+	bool bUsePredictiveStreamingSource = true;
+
+	/** На сколько секунд вперёд по скорости сдвигается прогнозный прямоугольник */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "World Partition", meta = (ClampMin = "0.0"))
+	float StreamingLookAheadTime = 1.0f;
+
+	/** Запас к радиусу, описанному вокруг видимого прямоугольника */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "World Partition", meta = (ClampMin = "1.0"))
+	float StreamingRadiusScale = 1.25f;
+
+private:
+	/** Видимый прямоугольник из менеджера камеры; false, если он ещё не посчитан (например, на сервере) */
+	bool GetPredictiveViewRect(FTDSViewRect& OutViewRect) const;
 };
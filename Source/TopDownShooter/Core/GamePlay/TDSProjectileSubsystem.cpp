@@ -0,0 +1,248 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSProjectileSubsystem.h"
+#include "TDSStats.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "GameFramework/DamageType.h"
+#include "DrawDebugHelpers.h"
+
+DECLARE_CYCLE_STAT(TEXT("TDS Projectiles"), STAT_TDSProjectiles, STATGROUP_TDS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TDS Active Projectiles"), STAT_TDSActiveProjectiles, STATGROUP_TDS);
+
+namespace TDSProjectiles
+{
+    static TAutoConsoleVariable<int32> CVarMaxProjectiles(
+        TEXT("TDS.Projectiles.Max"), 4096,
+        TEXT("Максимальное число одновременно летящих снарядов в мире."));
+
+    static TAutoConsoleVariable<int32> CVarMaxPerInstigator(
+        TEXT("TDS.Projectiles.MaxPerInstigator"), 64,
+        TEXT("Максимальное число одновременно летящих снарядов одного инициатора; 0 – без ограничения."));
+
+    static TAutoConsoleVariable<bool> CVarDebug(
+        TEXT("TDS.Projectiles.Debug"), false,
+        TEXT("Рисовать снаряды и попадания."));
+
+    /** Шаг роста пула, слотов */
+    static constexpr int32 PoolGrowth = 256;
+}
+
+bool UTDSProjectileSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    if (!Super::ShouldCreateSubsystem(Outer))
+    {
+        return false;
+    }
+
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld();
+}
+
+void UTDSProjectileSubsystem::Deinitialize()
+{
+    ActiveSlots.Reset();
+    FreeSlots.Reset();
+    LiveByInstigator.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UTDSProjectileSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UTDSProjectileSubsystem, STATGROUP_Tickables);
+}
+
+int32 UTDSProjectileSubsystem::Spawn(AActor* Instigator, const FVector& Origin, const FVector& Direction, const FTDSProjectileParams& Params, bool bAuthoritative)
+{
+    if (ActiveSlots.Num() >= TDSProjectiles::CVarMaxProjectiles.GetValueOnGameThread())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("TDS.Projectiles: limit %d reached, projectile from %s dropped"),
+            ActiveSlots.Num(), *GetNameSafe(Instigator));
+        return INDEX_NONE;
+    }
+
+    // Один игрок не может занять весь мировой лимит
+    const TObjectKey<AActor> InstigatorKey(Instigator);
+    int32& InstigatorLive = LiveByInstigator.FindOrAdd(InstigatorKey, 0);
+    const int32 MaxPerInstigator = TDSProjectiles::CVarMaxPerInstigator.GetValueOnGameThread();
+    if (MaxPerInstigator > 0 && InstigatorLive >= MaxPerInstigator)
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("TDS.Projectiles: per-instigator limit %d reached, projectile from %s dropped"),
+            MaxPerInstigator, *GetNameSafe(Instigator));
+        return INDEX_NONE;
+    }
+    ++InstigatorLive;
+
+    if (FreeSlots.IsEmpty())
+    {
+        // Пул растёт блоками, чтобы массивы не перевыделялись на каждом выстреле
+        const int32 OldNum = Positions.Num();
+        const int32 NewNum = OldNum + TDSProjectiles::PoolGrowth;
+        Positions.SetNumUninitialized(NewNum);
+        Velocities.SetNumUninitialized(NewNum);
+        GravityZ.SetNumUninitialized(NewNum);
+        Radii.SetNumUninitialized(NewNum);
+        LifeLeft.SetNumUninitialized(NewNum);
+        Damage.SetNumUninitialized(NewNum);
+        Channels.SetNum(NewNum);
+        Instigators.SetNum(NewNum);
+        InstigatorKeys.SetNum(NewNum);
+        PendingTraces.SetNum(NewNum);
+        Authoritative.SetNum(NewNum);
+        ActiveIndex.SetNum(NewNum);
+
+        for (int32 Slot = NewNum - 1; Slot >= OldNum; --Slot)
+        {
+            FreeSlots.Add(Slot);
+        }
+    }
+
+    const int32 Slot = FreeSlots.Pop(EAllowShrinking::No);
+    Positions[Slot] = Origin;
+    Velocities[Slot] = Direction.GetSafeNormal() * Params.Speed;
+    GravityZ[Slot] = GetWorld()->GetGravityZ() * Params.GravityScale;
+    Radii[Slot] = Params.Radius;
+    LifeLeft[Slot] = Params.LifeSeconds;
+    Damage[Slot] = Params.Damage;
+    Channels[Slot] = Params.TraceChannel;
+    Instigators[Slot] = Instigator;
+    InstigatorKeys[Slot] = InstigatorKey;
+    PendingTraces[Slot] = FTraceHandle();
+    Authoritative[Slot] = bAuthoritative;
+
+    ActiveIndex[Slot] = ActiveSlots.Add(Slot);
+    return Slot;
+}
+
+void UTDSProjectileSubsystem::Release(int32 Slot)
+{
+    const int32 Index = ActiveIndex[Slot];
+    ActiveSlots.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+    if (ActiveSlots.IsValidIndex(Index))
+    {
+        ActiveIndex[ActiveSlots[Index]] = Index;
+    }
+
+    ActiveIndex[Slot] = INDEX_NONE;
+    Instigators[Slot].Reset();
+    FreeSlots.Add(Slot);
+
+    // Ключ хранится отдельно: инициатор мог быть уничтожен, пока снаряд летел
+    int32* InstigatorLive = LiveByInstigator.Find(InstigatorKeys[Slot]);
+    if (InstigatorLive && --*InstigatorLive <= 0)
+    {
+        LiveByInstigator.Remove(InstigatorKeys[Slot]);
+    }
+    InstigatorKeys[Slot] = TObjectKey<AActor>();
+}
+
+void UTDSProjectileSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (ActiveSlots.IsEmpty())
+    {
+        return;
+    }
+
+    SCOPE_CYCLE_COUNTER(STAT_TDSProjectiles);
+
+    ResolvePendingTraces();
+    Advance(DeltaTime);
+
+    SET_DWORD_STAT(STAT_TDSActiveProjectiles, ActiveSlots.Num());
+}
+
+void UTDSProjectileSubsystem::ResolvePendingTraces()
+{
+    UWorld* World = GetWorld();
+
+    // Обход с конца: Release переставляет последний элемент на место удалённого
+    for (int32 Index = ActiveSlots.Num() - 1; Index >= 0; --Index)
+    {
+        const int32 Slot = ActiveSlots[Index];
+        if (!PendingTraces[Slot].IsValid())
+        {
+            continue;
+        }
+
+        FTraceDatum Datum;
+        if (!World->QueryTraceData(PendingTraces[Slot], Datum))
+        {
+            continue;
+        }
+        PendingTraces[Slot] = FTraceHandle();
+
+        if (const FHitResult* Hit = FHitResult::GetFirstBlockingHit(Datum.OutHits))
+        {
+            HandleImpact(Slot, *Hit);
+            Release(Slot);
+        }
+    }
+}
+
+void UTDSProjectileSubsystem::Advance(float DeltaTime)
+{
+    UWorld* World = GetWorld();
+    const int32 NumActive = ActiveSlots.Num();
+
+    FVector* RESTRICT Position = Positions.GetData();
+    FVector* RESTRICT Velocity = Velocities.GetData();
+    float* RESTRICT Life = LifeLeft.GetData();
+    const float* RESTRICT Gravity = GravityZ.GetData();
+
+    for (int32 Index = NumActive - 1; Index >= 0; --Index)
+    {
+        const int32 Slot = ActiveSlots[Index];
+
+        Life[Slot] -= DeltaTime;
+        if (Life[Slot] <= 0.0f)
+        {
+            Release(Slot);
+            continue;
+        }
+
+        const FVector Start = Position[Slot];
+        Velocity[Slot].Z += Gravity[Slot] * DeltaTime;
+        Position[Slot] += Velocity[Slot] * DeltaTime;
+
+        // Sweep по отрезку кадра; результат будет готов к следующему тику
+        FCollisionQueryParams Params(SCENE_QUERY_STAT(TDSProjectile), false, Instigators[Slot].Get());
+        PendingTraces[Slot] = Radii[Slot] > 0.0f
+            ? World->AsyncSweepByChannel(EAsyncTraceType::Single, Start, Position[Slot], FQuat::Identity, Channels[Slot],
+                FCollisionShape::MakeSphere(Radii[Slot]), Params)
+            : World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, Position[Slot], Channels[Slot], Params);
+
+#if ENABLE_DRAW_DEBUG
+        if (TDSProjectiles::CVarDebug.GetValueOnGameThread())
+        {
+            DrawDebugLine(World, Start, Position[Slot], Authoritative[Slot] ? FColor::Orange : FColor::Cyan, false, 0.0f);
+        }
+#endif
+    }
+
+    FTDSPerfCounters::Get().CountTrace(ActiveSlots.Num());
+}
+
+void UTDSProjectileSubsystem::HandleImpact(int32 Slot, const FHitResult& Hit)
+{
+    AActor* Instigator = Instigators[Slot].Get();
+
+    if (Authoritative[Slot] && Hit.GetActor() && Damage[Slot] != 0.0f)
+    {
+        const APawn* InstigatorPawn = Cast<APawn>(Instigator);
+        UGameplayStatics::ApplyPointDamage(Hit.GetActor(), Damage[Slot], Velocities[Slot].GetSafeNormal(), Hit,
+            InstigatorPawn ? InstigatorPawn->GetController() : nullptr, Instigator, UDamageType::StaticClass());
+    }
+
+#if ENABLE_DRAW_DEBUG
+    if (TDSProjectiles::CVarDebug.GetValueOnGameThread())
+    {
+        DrawDebugPoint(GetWorld(), Hit.ImpactPoint, 8.0f, Authoritative[Slot] ? FColor::Red : FColor::Blue, false, 1.0f);
+    }
+#endif
+
+    OnImpact.Broadcast(Hit, Instigator);
+}
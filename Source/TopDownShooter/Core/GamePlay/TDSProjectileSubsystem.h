@@ -0,0 +1,133 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "Engine/NetSerialization.h"
+#include "WorldCollision.h"
+#include "UObject/ObjectKey.h"
+#include "TDSProjectileSubsystem.generated.h"
+
+/** Баллистика снаряда */
+USTRUCT(BlueprintType)
+struct FTDSProjectileParams
+{
+    GENERATED_BODY()
+
+    /** Начальная скорость, см/с */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile", meta = (ClampMin = "1.0"))
+    float Speed = 6000.0f;
+
+    /** Множитель гравитации мира; 0 – прямолинейный полёт */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+    float GravityScale = 0.0f;
+
+    /** Радиус sweep; 0 – луч */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile", meta = (ClampMin = "0.0"))
+    float Radius = 2.0f;
+
+    /** Время жизни, сек */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile", meta = (ClampMin = "0.01"))
+    float LifeSeconds = 2.0f;
+
+    /** Урон при попадании (только на сервере) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+    float Damage = 10.0f;
+
+    /** Минимальный интервал между выстрелами, сек; более частые ServerFireProjectile сервер отбрасывает */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile", meta = (ClampMin = "0.0"))
+    float FireInterval = 0.1f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+    TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+};
+
+/** Сетевое событие выстрела: вместо актора снаряда по сети идут только точка и направление */
+USTRUCT()
+struct FTDSProjectileSpawn
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    FVector_NetQuantize Origin;
+
+    UPROPERTY()
+    FVector_NetQuantizeNormal Direction;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FTDSOnProjectileImpact, const FHitResult& /*Hit*/, AActor* /*Instigator*/);
+
+/**
+ * Снаряды без акторов.
+ * Состояние хранится в плотных параллельных массивах (позиция, скорость, время жизни, ...),
+ * слоты освобождённых снарядов переиспользуются из пула. Раз в тик один проход двигает все
+ * активные снаряды и ставит по асинхронному sweep на отрезок, пройденный за кадр; результаты
+ * забираются в начале следующего тика, так что запросы к физике выполняются пачкой на рабочих потоках.
+ *
+ * На сервере снаряды авторитетные (урон через ApplyPointDamage), на клиентах – только визуальные
+ * (останавливаются о препятствия, урона не наносят). Спавн реплицируется событием FTDSProjectileSpawn,
+ * см. ATDSCharacter::FireProjectile.
+ */
+UCLASS()
+class TOPDOWNSHOOTER_API UTDSProjectileSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    /**
+     * Запустить снаряд.
+     * @param bAuthoritative  наносит ли снаряд урон (true только на сервере)
+     * @return индекс слота; INDEX_NONE, если превышен общий лимит или лимит на инициатора
+     */
+    int32 Spawn(AActor* Instigator, const FVector& Origin, const FVector& Direction, const FTDSProjectileParams& Params, bool bAuthoritative);
+
+    int32 GetNumActive() const { return ActiveSlots.Num(); }
+
+    /** Позиции всех слотов (для визуализации); актуальны только индексы из GetActiveSlots */
+    const TArray<FVector>& GetPositions() const { return Positions; }
+    const TArray<int32>& GetActiveSlots() const { return ActiveSlots; }
+
+    /** Попадание снаряда (и авторитетного, и визуального) */
+    FTDSOnProjectileImpact OnImpact;
+
+private:
+    /** Состояние снарядов по слотам (SoA) */
+    TArray<FVector> Positions;
+    TArray<FVector> Velocities;
+    TArray<float> GravityZ;
+    TArray<float> Radii;
+    TArray<float> LifeLeft;
+    TArray<float> Damage;
+    TArray<TEnumAsByte<ECollisionChannel>> Channels;
+    TArray<TWeakObjectPtr<AActor>> Instigators;
+    TArray<TObjectKey<AActor>> InstigatorKeys;
+    TArray<FTraceHandle> PendingTraces;
+    TArray<bool> Authoritative;
+
+    /** Плотный список занятых слотов и позиция слота в нём */
+    TArray<int32> ActiveSlots;
+    TArray<int32> ActiveIndex;
+
+    /** Пул свободных слотов */
+    TArray<int32> FreeSlots;
+
+    /** Число летящих снарядов по инициаторам (TDS.Projectiles.MaxPerInstigator) */
+    TMap<TObjectKey<AActor>, int32> LiveByInstigator;
+
+    /** Забрать результаты sweep прошлого кадра и обработать попадания */
+    void ResolvePendingTraces();
+
+    /** Сдвинуть все снаряды и поставить sweep на пройденные отрезки */
+    void Advance(float DeltaTime);
+
+    void HandleImpact(int32 Slot, const FHitResult& Hit);
+
+    void Release(int32 Slot);
+};
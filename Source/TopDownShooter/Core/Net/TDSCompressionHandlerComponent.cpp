@@ -0,0 +1,186 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSCompressionHandlerComponent.h"
+#include "TDSStats.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+DECLARE_CYCLE_STAT(TEXT("TDS Net Compress"), STAT_TDSNetCompress, STATGROUP_TDS);
+DECLARE_CYCLE_STAT(TEXT("TDS Net Decompress"), STAT_TDSNetDecompress, STATGROUP_TDS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TDS Net Raw Bytes"), STAT_TDSNetRawBytes, STATGROUP_TDS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TDS Net Sent Bytes"), STAT_TDSNetSentBytes, STATGROUP_TDS);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("TDS Net Compression Ratio"), STAT_TDSNetCompressionRatio, STATGROUP_TDS);
+
+namespace TDSNetCompression
+{
+    static const TCHAR* DefaultDictionaryPath = TEXT("/Game/Net/TDSNetDictionary.TDSNetDictionary");
+
+    /** Разрядность поля с исходной длиной сжатого пакета */
+    static constexpr int32 RawBitsFieldBits = 16;
+
+    /** Итог по процессу для коэффициента: отправлено / до сжатия */
+    static uint64 TotalRawBits = 0;
+    static uint64 TotalSentBits = 0;
+}
+
+FTDSCompressionHandlerComponent::FTDSCompressionHandlerComponent()
+    : HandlerComponent(FName(TEXT("TDSCompressionHandlerComponent")))
+{
+}
+
+FTDSCompressionHandlerComponent::~FTDSCompressionHandlerComponent()
+{
+    if (CaptureWriter)
+    {
+        CaptureWriter->Close();
+    }
+}
+
+void FTDSCompressionHandlerComponent::Initialize()
+{
+    FString DictionaryPath = TDSNetCompression::DefaultDictionaryPath;
+    FParse::Value(FCommandLine::Get(), TEXT("TDSNetDictionary="), DictionaryPath);
+
+    const UTDSNetDictionary* Dictionary = LoadObject<UTDSNetDictionary>(nullptr, *DictionaryPath);
+    if (!Dictionary)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("TDSNetCompression: dictionary %s not found, packets are sent uncompressed"), *DictionaryPath);
+    }
+    else if (!Codec.Initialize(Dictionary->CodeLengths))
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSNetCompression: dictionary %s is invalid, packets are sent uncompressed"), *DictionaryPath);
+    }
+
+    FString CaptureDir;
+    if (FParse::Value(FCommandLine::Get(), TEXT("TDSNetCapture="), CaptureDir))
+    {
+        // Каждое соединение пишет в свой файл
+        static int32 CaptureIndex = 0;
+        const FString CapturePath = CaptureDir / FString::Printf(TEXT("%u-%d.tdsnetcap"), FPlatformProcess::GetCurrentProcessId(), CaptureIndex++);
+        CaptureWriter.Reset(IFileManager::Get().CreateFileWriter(*CapturePath, FILEWRITE_Append | FILEWRITE_AllowRead));
+        UE_CLOG(!CaptureWriter, LogTemp, Error, TEXT("TDSNetCompression: failed to open capture %s"), *CapturePath);
+    }
+
+    SetActive(true);
+    Initialized();
+}
+
+bool FTDSCompressionHandlerComponent::IsValid() const
+{
+    return true;
+}
+
+int32 FTDSCompressionHandlerComponent::GetReservedPacketBits() const
+{
+    // Бит формата; сжатый вариант выбирается, только если он не длиннее исходного
+    return 1;
+}
+
+void FTDSCompressionHandlerComponent::Outgoing(FBitWriter& Packet, FOutPacketTraits& Traits)
+{
+    SCOPE_CYCLE_COUNTER(STAT_TDSNetCompress);
+
+    const int64 NumBits = Packet.GetNumBits();
+    const int32 NumBytes = static_cast<int32>(Packet.GetNumBytes());
+    Scratch.SetNumUninitialized(NumBytes, EAllowShrinking::No);
+    FMemory::Memcpy(Scratch.GetData(), Packet.GetData(), NumBytes);
+
+    if (CaptureWriter)
+    {
+        CapturePacket(Scratch.GetData(), static_cast<int32>(NumBits));
+    }
+
+    const bool bCanCompress = Codec.IsValid() && Traits.bAllowCompression && NumBits < (1 << TDSNetCompression::RawBitsFieldBits);
+    const int64 CompressedBits = bCanCompress
+        ? 1 + TDSNetCompression::RawBitsFieldBits + Codec.GetEncodedBits(Scratch.GetData(), NumBytes)
+        : MAX_int64;
+
+    Packet.Reset();
+    if (CompressedBits <= NumBits)
+    {
+        Packet.WriteBit(1);
+        uint32 RawBits = static_cast<uint32>(NumBits);
+        Packet.SerializeBits(&RawBits, TDSNetCompression::RawBitsFieldBits);
+        Codec.Encode(Scratch.GetData(), NumBytes, Packet);
+    }
+    else
+    {
+        Packet.WriteBit(0);
+        Packet.SerializeBits(Scratch.GetData(), NumBits);
+    }
+
+    TDSNetCompression::TotalRawBits += NumBits;
+    TDSNetCompression::TotalSentBits += Packet.GetNumBits();
+    INC_DWORD_STAT_BY(STAT_TDSNetRawBytes, NumBytes);
+    INC_DWORD_STAT_BY(STAT_TDSNetSentBytes, Packet.GetNumBytes());
+    SET_FLOAT_STAT(STAT_TDSNetCompressionRatio, static_cast<float>(
+        static_cast<double>(TDSNetCompression::TotalSentBits) / FMath::Max<uint64>(TDSNetCompression::TotalRawBits, 1)));
+}
+
+void FTDSCompressionHandlerComponent::Incoming(FBitReader& Packet)
+{
+    SCOPE_CYCLE_COUNTER(STAT_TDSNetDecompress);
+
+    if (Packet.GetBitsLeft() <= 0)
+    {
+        return;
+    }
+
+    const bool bCompressed = Packet.ReadBit() != 0;
+    if (!bCompressed)
+    {
+        const int64 NumBits = Packet.GetBitsLeft();
+        TArray<uint8> Data;
+        Data.SetNumZeroed(FMath::DivideAndRoundUp<int64>(NumBits, 8));
+        Packet.SerializeBits(Data.GetData(), NumBits);
+        Packet.SetData(MoveTemp(Data), NumBits);
+        return;
+    }
+
+    if (!Codec.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSNetCompression: compressed packet received without a dictionary"));
+        Packet.SetError();
+        return;
+    }
+
+    uint32 RawBits = 0;
+    Packet.SerializeBits(&RawBits, TDSNetCompression::RawBitsFieldBits);
+
+    TArray<uint8> Data;
+    Data.SetNumZeroed(FMath::DivideAndRoundUp<int64>(RawBits, 8));
+    if (Packet.IsError() || !Codec.Decode(Packet, Data.Num(), Data.GetData()))
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSNetCompression: failed to decode packet of %u bits"), RawBits);
+        Packet.SetError();
+        return;
+    }
+
+    Packet.SetData(MoveTemp(Data), RawBits);
+}
+
+void FTDSCompressionHandlerComponent::IncomingConnectionless(FIncomingPacketRef PacketRef)
+{
+    // Пакеты рукопожатия без соединения не сжимаются
+}
+
+void FTDSCompressionHandlerComponent::OutgoingConnectionless(const TSharedPtr<const FInternetAddr>& Address, FBitWriter& Packet, FOutPacketTraits& Traits)
+{
+}
+
+void FTDSCompressionHandlerComponent::CapturePacket(const uint8* Data, int32 NumBits)
+{
+    // Формат записи: число бит (int32) и байты пакета
+    int32 Bits = NumBits;
+    *CaptureWriter << Bits;
+    CaptureWriter->Serialize(const_cast<uint8*>(Data), FMath::DivideAndRoundUp(NumBits, 8));
+}
+
+TSharedPtr<HandlerComponent> UTDSCompressionHandlerComponentFactory::CreateComponentInstance(FString& Options)
+{
+    return MakeShared<FTDSCompressionHandlerComponent>();
+}
@@ -0,0 +1,61 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PacketHandler.h"
+#include "HandlerComponentFactory.h"
+#include "TDSNetCompression.h"
+#include "TDSCompressionHandlerComponent.generated.h"
+
+/**
+ * Компонент PacketHandler: сжимает исходящие пакеты статическим кодом Хаффмана из UTDSNetDictionary.
+ * Подключение (DefaultEngine.ini, одинаково у сервера и клиентов):
+ *
+ *   [PacketHandlerComponents]
+ *   +Components=/Script/TopDownShooter.TDSCompressionHandlerComponentFactory
+ *
+ * Словарь – ассет -TDSNetDictionary= (по умолчанию /Game/Net/TDSNetDictionary), папку /Game/Net
+ * нужно добавить в DirectoriesToAlwaysCook. Без словаря пакеты идут как есть.
+ *
+ * Каждый пакет начинается с бита: 0 – исходные биты, 1 – число исходных бит (16) и коды Хаффмана.
+ * Сжатие выбирается, только если оно короче исходного пакета, поэтому в худшем случае пакет длиннее на один бит.
+ *
+ * -TDSNetCapture=<папка> пишет исходящие пакеты до сжатия в <папка>/<pid>-<n>.tdsnetcap – выборка
+ * для UTDSNetDictionaryCommandlet.
+ */
+class FTDSCompressionHandlerComponent : public HandlerComponent
+{
+public:
+    FTDSCompressionHandlerComponent();
+    virtual ~FTDSCompressionHandlerComponent() override;
+
+    virtual void Initialize() override;
+    virtual bool IsValid() const override;
+    virtual void Incoming(FBitReader& Packet) override;
+    virtual void Outgoing(FBitWriter& Packet, FOutPacketTraits& Traits) override;
+    virtual void IncomingConnectionless(FIncomingPacketRef PacketRef) override;
+    virtual void OutgoingConnectionless(const TSharedPtr<const FInternetAddr>& Address, FBitWriter& Packet, FOutPacketTraits& Traits) override;
+    virtual int32 GetReservedPacketBits() const override;
+
+private:
+    FTDSHuffmanCodec Codec;
+
+    /** Запись выборки трафика (-TDSNetCapture=) */
+    TUniquePtr<FArchive> CaptureWriter;
+
+    /** Буфер исходных байт пакета, переиспользуется между пакетами */
+    TArray<uint8> Scratch;
+
+    void CapturePacket(const uint8* Data, int32 NumBits);
+};
+
+/** Фабрика для [PacketHandlerComponents] */
+UCLASS()
+class UTDSCompressionHandlerComponentFactory : public UHandlerComponentFactory
+{
+    GENERATED_BODY()
+
+public:
+    virtual TSharedPtr<HandlerComponent> CreateComponentInstance(FString& Options) override;
+};
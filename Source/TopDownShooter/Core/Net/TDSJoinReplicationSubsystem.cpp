@@ -0,0 +1,326 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSJoinReplicationSubsystem.h"
+#include "TDSCharacter.h"
+#include "TDSStats.h"
+#include "Engine/ActorChannel.h"
+#include "Engine/NetConnection.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+
+namespace TDSJoinReplication
+{
+    static TAutoConsoleVariable<bool> CVarEnabled(
+        TEXT("TDS.JoinReplication.Enabled"), true,
+        TEXT("Упорядочивать начальную репликацию персонажей для подключившихся к идущему матчу."));
+
+    static TAutoConsoleVariable<float> CVarViewHalfExtent(
+        TEXT("TDS.JoinReplication.ViewHalfExtent"), 2500.0f,
+        TEXT("Половина стороны начального прямоугольника обзора вокруг пешки, см."));
+
+    static TAutoConsoleVariable<int32> CVarCharactersPerFrame(
+        TEXT("TDS.JoinReplication.CharactersPerFrame"), 4,
+        TEXT("Сколько персонажей открывать подключающемуся за кадр, пока у соединения есть бюджет."));
+
+    static TAutoConsoleVariable<float> CVarMaxPhaseSeconds(
+        TEXT("TDS.JoinReplication.MaxPhaseSeconds"), 2.0f,
+        TEXT("Через сколько секунд фаза входа завершается, даже если клиент не подтвердил каналы."));
+
+    /** Через сколько секунд запись входа снимается, даже если клиент так и не начал ходить */
+    static constexpr double GiveUpSeconds = 30.0;
+
+    static const TCHAR* FormatSeconds(double Seconds, FString& Out)
+    {
+        Out = Seconds >= 0.0 ? FString::Printf(TEXT("%.2f s"), Seconds) : FString(TEXT("n/a"));
+        return *Out;
+    }
+}
+
+bool UTDSJoinReplicationSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    if (!Super::ShouldCreateSubsystem(Outer))
+    {
+        return false;
+    }
+
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld();
+}
+
+void UTDSJoinReplicationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    PostLoginHandle = FGameModeEvents::GameModePostLoginEvent.AddUObject(this, &UTDSJoinReplicationSubsystem::OnPostLogin);
+    LogoutHandle = FGameModeEvents::GameModeLogoutEvent.AddUObject(this, &UTDSJoinReplicationSubsystem::OnLogout);
+}
+
+void UTDSJoinReplicationSubsystem::Deinitialize()
+{
+    FGameModeEvents::GameModePostLoginEvent.Remove(PostLoginHandle);
+    FGameModeEvents::GameModeLogoutEvent.Remove(LogoutHandle);
+    Joins.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UTDSJoinReplicationSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UTDSJoinReplicationSubsystem, STATGROUP_Tickables);
+}
+
+void UTDSJoinReplicationSubsystem::OnPostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer)
+{
+    // Локальный игрок listen-сервера ничего не получает по сети
+    if (!NewPlayer || !NewPlayer->NetConnection || NewPlayer->GetWorld() != GetWorld()
+        || !TDSJoinReplication::CVarEnabled.GetValueOnGameThread())
+    {
+        return;
+    }
+
+    const double Now = GetWorld()->GetTimeSeconds();
+    FJoin& Join = Joins.AddDefaulted_GetRef();
+    Join.PlayerController = NewPlayer;
+    Join.Connection = NewPlayer->NetConnection;
+    Join.StartTime = Now;
+    Join.PhaseStartTime = Now;
+}
+
+void UTDSJoinReplicationSubsystem::OnLogout(AGameModeBase* GameMode, AController* Exiting)
+{
+    Joins.RemoveAllSwap([Exiting](const FJoin& Join) { return Join.PlayerController.Get() == Exiting; });
+}
+
+const UTDSJoinReplicationSubsystem::FJoin* UTDSJoinReplicationSubsystem::FindJoin(const AActor* RealViewer) const
+{
+    for (const FJoin& Join : Joins)
+    {
+        if (Join.PlayerController.Get() == RealViewer)
+        {
+            return &Join;
+        }
+    }
+    return nullptr;
+}
+
+bool UTDSJoinReplicationSubsystem::IsAdmitted(const AActor& Character, const AActor* RealViewer) const
+{
+    const FJoin* Join = Joins.IsEmpty() ? nullptr : FindJoin(RealViewer);
+    if (!Join || Join->Phase == EPhase::Done)
+    {
+        return true;
+    }
+
+    // Собственная пешка – всегда
+    const APlayerController* PlayerController = Join->PlayerController.Get();
+    if (PlayerController && PlayerController->GetPawn() == &Character)
+    {
+        return true;
+    }
+
+    if (Join->Phase == EPhase::OwnPawn)
+    {
+        return false;
+    }
+
+    // Персонаж, появившийся после входа, идёт вместе с «остальными»
+    const int32* Rank = Join->Ranks.Find(&Character);
+    return Rank ? *Rank < Join->Admitted : Join->Phase == EPhase::Rest;
+}
+
+void UTDSJoinReplicationSubsystem::BuildOrder(FJoin& Join, const FVector& Center) const
+{
+    const float HalfExtent = TDSJoinReplication::CVarViewHalfExtent.GetValueOnGameThread();
+    const APawn* OwnPawn = Join.PlayerController.IsValid() ? Join.PlayerController->GetPawn() : nullptr;
+
+    struct FEntry
+    {
+        AActor* Actor;
+        bool bNearby;
+        double DistanceSquared;
+    };
+    TArray<FEntry> Entries;
+
+    for (TActorIterator<ATDSCharacter> It(GetWorld()); It; ++It)
+    {
+        if (*It == OwnPawn)
+        {
+            continue;
+        }
+
+        const FVector Offset = It->GetActorLocation() - Center;
+        const bool bNearby = FMath::Abs(Offset.X) <= HalfExtent && FMath::Abs(Offset.Y) <= HalfExtent;
+        Entries.Add({ *It, bNearby, Offset.SizeSquared2D() });
+    }
+
+    Entries.Sort([](const FEntry& A, const FEntry& B)
+    {
+        return A.bNearby != B.bNearby ? A.bNearby : A.DistanceSquared < B.DistanceSquared;
+    });
+
+    Join.Order.Reset(Entries.Num());
+    Join.Ranks.Reset();
+    Join.NumNearby = 0;
+    for (const FEntry& Entry : Entries)
+    {
+        Join.Ranks.Add(Entry.Actor, Join.Order.Add(Entry.Actor));
+        Join.NumNearby += Entry.bNearby;
+    }
+    Join.Admitted = 0;
+}
+
+bool UTDSJoinReplicationSubsystem::AreChannelsAcked(const FJoin& Join, int32 FirstRank, int32 EndRank)
+{
+    UNetConnection* Connection = Join.Connection.Get();
+    if (!Connection)
+    {
+        return true;
+    }
+
+    for (int32 Rank = FirstRank; Rank < EndRank; ++Rank)
+    {
+        AActor* Actor = Join.Order[Rank].Get();
+        if (!Actor)
+        {
+            continue;
+        }
+
+        // Нерелевантный по дистанции персонаж канала не получит – его не ждём
+        const UActorChannel* Channel = Connection->FindActorChannelRef(Actor);
+        if (Channel && !Channel->OpenAcked)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void UTDSJoinReplicationSubsystem::SetPhase(FJoin& Join, EPhase NewPhase, double Now)
+{
+    const double Elapsed = Now - Join.StartTime;
+    switch (Join.Phase)
+    {
+    case EPhase::OwnPawn: Join.OwnPawnSeconds = Elapsed; break;
+    case EPhase::Nearby:  Join.NearbySeconds = Elapsed; break;
+    case EPhase::Rest:    Join.AllSeconds = Elapsed; break;
+    default: break;
+    }
+
+    Join.Phase = NewPhase;
+    Join.PhaseStartTime = Now;
+}
+
+void UTDSJoinReplicationSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (Joins.IsEmpty())
+    {
+        return;
+    }
+
+    const double Now = GetWorld()->GetTimeSeconds();
+    for (int32 Index = Joins.Num() - 1; Index >= 0; --Index)
+    {
+        if (!TickJoin(Joins[Index], Now))
+        {
+            Report(Joins[Index]);
+            Joins.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        }
+    }
+}
+
+bool UTDSJoinReplicationSubsystem::TickJoin(FJoin& Join, double Now)
+{
+    APlayerController* PlayerController = Join.PlayerController.Get();
+    UNetConnection* Connection = Join.Connection.Get();
+    if (!PlayerController || !Connection)
+    {
+        return false;
+    }
+
+    const APawn* Pawn = PlayerController->GetPawn();
+    const bool bPhaseTimedOut = Now - Join.PhaseStartTime > TDSJoinReplication::CVarMaxPhaseSeconds.GetValueOnGameThread();
+
+    // Первое управление: сервер получил от клиента ход его пешкой
+    if (Join.ControlSeconds < 0.0 && Pawn)
+    {
+        if (const ATDSCharacter* Character = Cast<ATDSCharacter>(Pawn))
+        {
+            UTDSCharacterMovementComponent* MoveComp = Character->GetTDSMovementComponent();
+            if (MoveComp && MoveComp->HasPredictionData_Server()
+                && MoveComp->GetPredictionData_Server_Character()->CurrentClientTimeStamp > 0.0f)
+            {
+                Join.ControlSeconds = Now - Join.StartTime;
+            }
+        }
+    }
+
+    const int32 PerFrame = FMath::Max(TDSJoinReplication::CVarCharactersPerFrame.GetValueOnGameThread(), 1);
+
+    switch (Join.Phase)
+    {
+    case EPhase::OwnPawn:
+    {
+        const UActorChannel* PawnChannel = Pawn ? Connection->FindActorChannelRef(Pawn) : nullptr;
+        if ((PawnChannel && PawnChannel->OpenAcked) || bPhaseTimedOut)
+        {
+            BuildOrder(Join, Pawn ? Pawn->GetActorLocation() : PlayerController->GetFocalLocation());
+            SetPhase(Join, EPhase::Nearby, Now);
+        }
+        break;
+    }
+    case EPhase::Nearby:
+        // Следующая порция – только если соединение не упирается в свой бюджет
+        if (Join.Admitted < Join.NumNearby && Connection->IsNetReady(false))
+        {
+            Join.Admitted = FMath::Min(Join.Admitted + PerFrame, Join.NumNearby);
+        }
+        if ((Join.Admitted == Join.NumNearby && AreChannelsAcked(Join, 0, Join.NumNearby)) || bPhaseTimedOut)
+        {
+            Join.Admitted = FMath::Max(Join.Admitted, Join.NumNearby);
+            SetPhase(Join, EPhase::Rest, Now);
+        }
+        break;
+    case EPhase::Rest:
+        if (Join.Admitted < Join.Order.Num() && Connection->IsNetReady(false))
+        {
+            Join.Admitted = FMath::Min(Join.Admitted + PerFrame, Join.Order.Num());
+        }
+        if (Join.Admitted == Join.Order.Num())
+        {
+            SetPhase(Join, EPhase::Done, Now);
+        }
+        break;
+    default:
+        break;
+    }
+
+    // Запись живёт до первого управления, чтобы его засечь
+    return Join.Phase != EPhase::Done || (Join.ControlSeconds < 0.0 && Now - Join.StartTime < TDSJoinReplication::GiveUpSeconds);
+}
+
+void UTDSJoinReplicationSubsystem::Report(const FJoin& Join) const
+{
+    const APlayerController* PlayerController = Join.PlayerController.Get();
+    const APlayerState* PlayerState = PlayerController ? PlayerController->PlayerState : nullptr;
+
+    FString Own;
+    FString Nearby;
+    FString All;
+    FString Control;
+    UE_LOG(LogTemp, Log, TEXT("TDSJoin: player %d: own pawn %s, %d nearby characters %s, %d total %s, first control %s"),
+        PlayerState ? PlayerState->GetPlayerId() : INDEX_NONE,
+        TDSJoinReplication::FormatSeconds(Join.OwnPawnSeconds, Own),
+        Join.NumNearby, TDSJoinReplication::FormatSeconds(Join.NearbySeconds, Nearby),
+        Join.Order.Num(), TDSJoinReplication::FormatSeconds(Join.AllSeconds, All),
+        TDSJoinReplication::FormatSeconds(Join.ControlSeconds, Control));
+
+    if (Join.ControlSeconds >= 0.0)
+    {
+        FTDSPerfCounters::Get().AddJoinToControl(Join.ControlSeconds);
+    }
+}
@@ -0,0 +1,93 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "TDSJoinReplicationSubsystem.generated.h"
+
+class AController;
+class AGameModeBase;
+class APlayerController;
+class UNetConnection;
+
+/**
+ * Порядок начальной репликации для игрока, подключившегося к идущему матчу.
+ * Пока вход не закончен, персонажи открываются этому соединению по очереди:
+ *   1. собственная пешка (контроллер реплицируется владельцу всегда);
+ *   2. персонажи в начальном прямоугольнике обзора вокруг пешки (TDS.JoinReplication.ViewHalfExtent), ближние первыми;
+ *   3. остальные персонажи.
+ * Новые персонажи допускаются порциями TDS.JoinReplication.CharactersPerFrame и только когда у соединения
+ * есть бюджет (UNetConnection::IsNetReady), поэтому начальное состояние растягивается на несколько кадров.
+ *
+ * Время до первого управления – от PostLogin до первого хода клиента его пешкой – пишется в лог
+ * и в FTDSPerfCounters (tds_join_to_control_seconds в UTDSMetricsSubsystem).
+ */
+UCLASS()
+class TOPDOWNSHOOTER_API UTDSJoinReplicationSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    /** Можно ли уже реплицировать персонажа зрителю (ATDSCharacter::IsNetRelevantFor) */
+    bool IsAdmitted(const AActor& Character, const AActor* RealViewer) const;
+
+private:
+    enum class EPhase : uint8
+    {
+        OwnPawn,
+        Nearby,
+        Rest,
+        Done
+    };
+
+    struct FJoin
+    {
+        TWeakObjectPtr<APlayerController> PlayerController;
+        TWeakObjectPtr<UNetConnection> Connection;
+        EPhase Phase = EPhase::OwnPawn;
+
+        /** Очередь персонажей: ранг – позиция в очереди; допущены ранги < Admitted */
+        TMap<TObjectKey<AActor>, int32> Ranks;
+        TArray<TWeakObjectPtr<AActor>> Order;
+        int32 NumNearby = 0;
+        int32 Admitted = 0;
+
+        double StartTime = 0.0;
+        double PhaseStartTime = 0.0;
+        double OwnPawnSeconds = -1.0;
+        double NearbySeconds = -1.0;
+        double AllSeconds = -1.0;
+        double ControlSeconds = -1.0;
+    };
+
+    TArray<FJoin> Joins;
+
+    FDelegateHandle PostLoginHandle;
+    FDelegateHandle LogoutHandle;
+
+    void OnPostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer);
+    void OnLogout(AGameModeBase* GameMode, AController* Exiting);
+
+    const FJoin* FindJoin(const AActor* RealViewer) const;
+
+    /** Выстроить очередь персонажей по положению пешки */
+    void BuildOrder(FJoin& Join, const FVector& Center) const;
+
+    /** Допущенные персонажи фазы уже открыты у клиента */
+    static bool AreChannelsAcked(const FJoin& Join, int32 FirstRank, int32 EndRank);
+
+    void SetPhase(FJoin& Join, EPhase NewPhase, double Now);
+
+    /** false – вход закончен, запись можно удалить */
+    bool TickJoin(FJoin& Join, double Now);
+
+    void Report(const FJoin& Join) const;
+};
@@ -0,0 +1,106 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSLockstep.h"
+#include "TDSCharacter.h"
+#include "TDSCharacterMovementComponent.h"
+
+namespace TDSLockstep
+{
+    /** Сотые доли сантиметра */
+    static constexpr double StateScale = 100.0;
+
+    static FIntVector QuantizeVector(const FVector& Value)
+    {
+        return FIntVector(
+            static_cast<int32>(FMath::RoundToInt64(Value.X * StateScale)),
+            static_cast<int32>(FMath::RoundToInt64(Value.Y * StateScale)),
+            static_cast<int32>(FMath::RoundToInt64(Value.Z * StateScale)));
+    }
+
+    static FVector DequantizeVector(const FIntVector& Value)
+    {
+        return FVector(Value.X / StateScale, Value.Y / StateScale, Value.Z / StateScale);
+    }
+}
+
+void FTDSLockstepInput::SetMove(const FVector& Move)
+{
+    const FVector2D Planar = FVector2D(Move).GetClampedToMaxSize(1.0);
+    MoveX = static_cast<int8>(FMath::RoundToInt(Planar.X * 127.0));
+    MoveY = static_cast<int8>(FMath::RoundToInt(Planar.Y * 127.0));
+}
+
+FVector FTDSLockstepInput::GetMove() const
+{
+    return FVector(MoveX / 127.0, MoveY / 127.0, 0.0);
+}
+
+void FTDSLockstepInput::SetAimYaw(double Yaw)
+{
+    constexpr int32 Steps = 1 << NumAimYawBits;
+    AimYaw = static_cast<uint16>(FMath::RoundToInt(FRotator::ClampAxis(Yaw) * Steps / 360.0) & (Steps - 1));
+}
+
+double FTDSLockstepInput::GetAimYaw() const
+{
+    return AimYaw * 360.0 / (1 << NumAimYawBits);
+}
+
+bool FTDSLockstepInput::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    uint32 PackedButtons = Buttons;
+    uint32 PackedAimYaw = AimYaw;
+    Ar.SerializeInt(PackedButtons, 1 << NumButtonBits);
+    Ar.SerializeInt(PackedAimYaw, 1 << NumAimYawBits);
+    Buttons = static_cast<uint8>(PackedButtons);
+    AimYaw = static_cast<uint16>(PackedAimYaw);
+
+    uint8 bMoving = (MoveX != 0 || MoveY != 0) ? 1 : 0;
+    Ar.SerializeBits(&bMoving, 1);
+    if (bMoving)
+    {
+        Ar << MoveX << MoveY;
+    }
+    else if (Ar.IsLoading())
+    {
+        MoveX = 0;
+        MoveY = 0;
+    }
+
+    bOutSuccess = !Ar.IsError();
+    return true;
+}
+
+void FTDSLockstepCharacterState::Capture(const ATDSCharacter& InCharacter)
+{
+    Character = const_cast<ATDSCharacter*>(&InCharacter);
+    Location = TDSLockstep::QuantizeVector(InCharacter.GetActorLocation());
+    Yaw = static_cast<float>(InCharacter.GetActorRotation().Yaw);
+
+    if (const UTDSCharacterMovementComponent* MoveComp = InCharacter.GetTDSMovementComponent())
+    {
+        Velocity = TDSLockstep::QuantizeVector(MoveComp->Velocity);
+        MovementMode = MoveComp->MovementMode;
+        CustomMovementMode = MoveComp->CustomMovementMode;
+    }
+}
+
+void FTDSLockstepCharacterState::Apply() const
+{
+    if (!Character)
+    {
+        return;
+    }
+
+    Character->SetActorLocationAndRotation(TDSLockstep::DequantizeVector(Location), FRotator(0.0, Yaw, 0.0),
+        false, nullptr, ETeleportType::TeleportPhysics);
+
+    if (UTDSCharacterMovementComponent* MoveComp = Character->GetTDSMovementComponent())
+    {
+        MoveComp->Velocity = TDSLockstep::DequantizeVector(Velocity);
+        if (MoveComp->MovementMode != MovementMode || MoveComp->CustomMovementMode != CustomMovementMode)
+        {
+            MoveComp->SetMovementMode(static_cast<EMovementMode>(MovementMode), CustomMovementMode);
+        }
+    }
+}
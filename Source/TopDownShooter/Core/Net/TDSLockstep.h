@@ -0,0 +1,130 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TDSLockstep.generated.h"
+
+class ATDSCharacter;
+
+/**
+ * Ввод персонажа за один шаг lockstep (UTDSLockstepSubsystem).
+ * Хранится уже квантованным: сервер и клиенты симулируют одни и те же значения.
+ * По сети – 20 бит без движения, 36 с движением.
+ */
+USTRUCT()
+struct TOPDOWNSHOOTER_API FTDSLockstepInput
+{
+    GENERATED_BODY()
+
+    enum EButtons : uint8
+    {
+        Walk    = 1 << 0,
+        Sprint  = 1 << 1,
+        Strafe  = 1 << 2,
+        Aim     = 1 << 3,
+        Slide   = 1 << 4,
+        Prone   = 1 << 5,
+        WallRun = 1 << 6,
+    };
+
+    static constexpr int32 NumButtonBits = 7;
+    static constexpr int32 NumAimYawBits = 12;
+
+    /** Ввод движения (IA_Move, уже в плоскости мира), -127..127 на ось */
+    int8 MoveX = 0;
+    int8 MoveY = 0;
+
+    /** Yaw прицела, 4096 шагов на оборот */
+    uint16 AimYaw = 0;
+
+    /** Биты EButtons */
+    uint8 Buttons = 0;
+
+    void SetMove(const FVector& Move);
+    FVector GetMove() const;
+
+    void SetAimYaw(double Yaw);
+    double GetAimYaw() const;
+
+    bool HasButton(EButtons Button) const { return (Buttons & Button) != 0; }
+
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FTDSLockstepInput> : public TStructOpsTypeTraitsBase2<FTDSLockstepInput>
+{
+    enum
+    {
+        WithNetSerializer = true
+    };
+};
+
+/** Вводы всех персонажей состава на шаг Tick; индекс – место персонажа в составе */
+USTRUCT()
+struct TOPDOWNSHOOTER_API FTDSLockstepFrame
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    int32 Tick = 0;
+
+    UPROPERTY()
+    TArray<FTDSLockstepInput> Inputs;
+};
+
+/**
+ * Состояние персонажа для пересинхронизации.
+ * Положение и скорость в целых сотых долях сантиметра: сервер применяет к себе то же округление,
+ * что получат клиенты, и после пересинхронизации состояние совпадает побитно.
+ */
+USTRUCT()
+struct TOPDOWNSHOOTER_API FTDSLockstepCharacterState
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TObjectPtr<ATDSCharacter> Character;
+
+    UPROPERTY()
+    FIntVector Location = FIntVector::ZeroValue;
+
+    UPROPERTY()
+    FIntVector Velocity = FIntVector::ZeroValue;
+
+    UPROPERTY()
+    float Yaw = 0.0f;
+
+    UPROPERTY()
+    uint8 MovementMode = 0;
+
+    UPROPERTY()
+    uint8 CustomMovementMode = 0;
+
+    void Capture(const ATDSCharacter& InCharacter);
+    void Apply() const;
+};
+
+/**
+ * Состав и состояние lockstep на шаге Tick.
+ * Рассылается при старте, смене состава и расхождении хэшей; bActive == false – lockstep выключен.
+ */
+USTRUCT()
+struct TOPDOWNSHOOTER_API FTDSLockstepSnapshot
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    bool bActive = false;
+
+    UPROPERTY()
+    int32 Tick = 0;
+
+    /** Фиксированный шаг симуляции, с – задаёт сервер */
+    UPROPERTY()
+    float StepSeconds = 0.0f;
+
+    UPROPERTY()
+    TArray<FTDSLockstepCharacterState> Characters;
+};
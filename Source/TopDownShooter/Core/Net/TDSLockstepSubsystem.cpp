@@ -0,0 +1,515 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSLockstepSubsystem.h"
+#include "TDSCharacter.h"
+#include "TDSCharacterMovementComponent.h"
+#include "TDSGameInstance.h"
+#include "TDSStats.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/Crc.h"
+
+DECLARE_CYCLE_STAT(TEXT("TDS Lockstep Simulate"), STAT_TDSLockstepSimulate, STATGROUP_TDS);
+
+namespace TDSLockstep
+{
+    static TAutoConsoleVariable<bool> CVarEnabled(
+        TEXT("TDS.Lockstep.Enabled"), false,
+        TEXT("Lockstep по вводу в небольших LAN-матчах вместо репликации движения персонажей."));
+
+    static TAutoConsoleVariable<int32> CVarTickRate(
+        TEXT("TDS.Lockstep.TickRate"), 30,
+        TEXT("Частота шагов lockstep, Гц (берётся при включении режима)."));
+
+    static TAutoConsoleVariable<int32> CVarInputDelay(
+        TEXT("TDS.Lockstep.InputDelay"), 3,
+        TEXT("На сколько шагов вперёд клиент отправляет ввод; должно покрывать RTT."));
+
+    static TAutoConsoleVariable<int32> CVarHashInterval(
+        TEXT("TDS.Lockstep.HashInterval"), 30,
+        TEXT("Раз в сколько шагов клиенты сверяют хэш состояния с сервером."));
+
+    static TAutoConsoleVariable<int32> CVarMaxPublicConnections(
+        TEXT("TDS.Lockstep.MaxPublicConnections"), 5,
+        TEXT("Наибольшее число мест LAN-сессии, при котором включается lockstep."));
+
+    /** Сколько шагов сервер или клиент догоняет за кадр */
+    static constexpr int32 MaxStepsPerFrame = 4;
+
+    /** Сколько хэшей сервер хранит для сверки */
+    static constexpr int32 HashHistory = 8;
+
+    /** Сколько вводов вперёд сервер держит на персонажа */
+    static constexpr int32 MaxPendingInputs = 16;
+}
+
+bool UTDSLockstepSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    if (!Super::ShouldCreateSubsystem(Outer))
+    {
+        return false;
+    }
+
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld();
+}
+
+void UTDSLockstepSubsystem::Deinitialize()
+{
+    if (bActive && GetWorld()->GetNetMode() != NM_Client)
+    {
+        StopServer();
+    }
+
+    Super::Deinitialize();
+}
+
+TStatId UTDSLockstepSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UTDSLockstepSubsystem, STATGROUP_Tickables);
+}
+
+void UTDSLockstepSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    switch (GetWorld()->GetNetMode())
+    {
+    case NM_DedicatedServer:
+    case NM_ListenServer:
+        TickServer(DeltaTime);
+        break;
+    case NM_Client:
+        TickClient();
+        break;
+    default:
+        break;
+    }
+}
+
+bool UTDSLockstepSubsystem::IsPlayerCharacter(const ATDSCharacter& Character)
+{
+    return Cast<APlayerController>(Character.GetController()) != nullptr;
+}
+
+bool UTDSLockstepSubsystem::IsRemotelyControlled(const ATDSCharacter& Character)
+{
+    const APlayerController* PlayerController = Cast<APlayerController>(Character.GetController());
+    return PlayerController && !PlayerController->IsLocalController();
+}
+
+void UTDSLockstepSubsystem::SetCharacterDriven(ATDSCharacter& Character, bool bDriven)
+{
+    if (UTDSCharacterMovementComponent* MoveComp = Character.GetTDSMovementComponent())
+    {
+        MoveComp->SetComponentTickEnabled(!bDriven);
+        MoveComp->SetLockstepDriven(bDriven);
+    }
+
+    if (Character.HasAuthority())
+    {
+        Character.SetReplicateMovement(!bDriven);
+        Character.ForceNetUpdate();
+    }
+}
+
+#pragma region Server
+
+bool UTDSLockstepSubsystem::ShouldRunOnServer() const
+{
+    if (!TDSLockstep::CVarEnabled.GetValueOnGameThread())
+    {
+        return false;
+    }
+
+    const UTDSGameInstance* GameInstance = GetWorld()->GetGameInstance<UTDSGameInstance>();
+    const FOnlineSessionSettings* Settings = GameInstance ? GameInstance->GetHostedSessionSettings() : nullptr;
+    if (!Settings || !Settings->bIsLANMatch
+        || Settings->NumPublicConnections > TDSLockstep::CVarMaxPublicConnections.GetValueOnGameThread())
+    {
+        return false;
+    }
+
+    // Каждому клиенту кадры идут через его персонажа
+    for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* PlayerController = It->Get();
+        if (PlayerController && !PlayerController->IsLocalController() && !Cast<ATDSCharacter>(PlayerController->GetPawn()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool UTDSLockstepSubsystem::HasRosterChanged() const
+{
+    // Состав тот же, если все персонажи игроков в нём и лишних нет (ушедших или отданных ИИ)
+    int32 NumCharacters = 0;
+    for (TActorIterator<ATDSCharacter> It(GetWorld()); It; ++It)
+    {
+        if (IsPlayerCharacter(**It))
+        {
+            if (!Roster.Contains(*It))
+            {
+                return true;
+            }
+            ++NumCharacters;
+        }
+    }
+    return NumCharacters != Roster.Num();
+}
+
+void UTDSLockstepSubsystem::BuildRoster()
+{
+    TArray<TWeakObjectPtr<ATDSCharacter>> OldRoster = MoveTemp(Roster);
+    Roster.Reset();
+    for (TActorIterator<ATDSCharacter> It(GetWorld()); It; ++It)
+    {
+        if (!IsPlayerCharacter(**It))
+        {
+            continue;
+        }
+
+        Roster.Add(*It);
+        if (!OldRoster.Contains(*It))
+        {
+            SetCharacterDriven(**It, true);
+        }
+    }
+
+    // Персонаж, которым теперь управляет ИИ, возвращается к обычному тику и репликации
+    for (const TWeakObjectPtr<ATDSCharacter>& Character : OldRoster)
+    {
+        if (Character.IsValid() && !Roster.Contains(Character))
+        {
+            SetCharacterDriven(*Character, false);
+        }
+    }
+
+    // Ввод, пришедший на старое место, к новому составу не относится
+    SlotInputs.Reset();
+    SlotInputs.SetNum(Roster.Num());
+    ServerHashes.Reset();
+}
+
+void UTDSLockstepSubsystem::TickServer(float DeltaTime)
+{
+    const bool bShouldRun = ShouldRunOnServer();
+    if (!bActive)
+    {
+        if (!bShouldRun)
+        {
+            return;
+        }
+
+        bActive = true;
+        CurrentTick = 0;
+        Accumulator = 0.0f;
+        StepSeconds = 1.0f / FMath::Clamp(TDSLockstep::CVarTickRate.GetValueOnGameThread(), 10, 120);
+        BuildRoster();
+        BroadcastSnapshot();
+        UE_LOG(LogTemp, Log, TEXT("TDSLockstep: started, %d characters at %.0f Hz"), Roster.Num(), 1.0f / StepSeconds);
+    }
+    else if (!bShouldRun)
+    {
+        StopServer();
+        return;
+    }
+    else if (HasRosterChanged())
+    {
+        BuildRoster();
+        BroadcastSnapshot();
+    }
+
+    Accumulator += DeltaTime;
+    for (int32 Step = 0; Accumulator >= StepSeconds && Step < TDSLockstep::MaxStepsPerFrame; ++Step)
+    {
+        Accumulator -= StepSeconds;
+        StepServer();
+    }
+
+    // Сервер не успевает – отставание не копим, клиенты идут за кадрами сервера
+    Accumulator = FMath::Min(Accumulator, StepSeconds);
+}
+
+void UTDSLockstepSubsystem::StepServer()
+{
+    FTDSLockstepFrame Frame;
+    Frame.Tick = CurrentTick + 1;
+    Frame.Inputs.SetNum(Roster.Num());
+
+    for (int32 Slot = 0; Slot < Roster.Num(); ++Slot)
+    {
+        ATDSCharacter* Character = Roster[Slot].Get();
+        if (!Character)
+        {
+            continue;
+        }
+
+        FSlotInputs& Inputs = SlotInputs[Slot];
+        if (IsRemotelyControlled(*Character))
+        {
+            // Опоздавший ввод заменяется последним известным
+            for (int32 Index = Inputs.Pending.Num() - 1; Index >= 0; --Index)
+            {
+                if (Inputs.Pending[Index].Key <= Frame.Tick)
+                {
+                    if (Inputs.Pending[Index].Key == Frame.Tick)
+                    {
+                        Inputs.Last = Inputs.Pending[Index].Value;
+                    }
+                    Inputs.Pending.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+                }
+            }
+        }
+        else if (UTDSCharacterMovementComponent* MoveComp = Character->GetTDSMovementComponent())
+        {
+            // Игрок listen-сервера – ввод снимается на месте
+            Inputs.Last = MoveComp->ConsumeLockstepInput();
+        }
+        Frame.Inputs[Slot] = Inputs.Last;
+    }
+
+    for (const TWeakObjectPtr<ATDSCharacter>& Character : Roster)
+    {
+        if (Character.IsValid() && IsRemotelyControlled(*Character))
+        {
+            Character->ClientLockstepFrame(Frame);
+        }
+    }
+
+    Simulate(Frame);
+    CurrentTick = Frame.Tick;
+
+    const int32 HashInterval = FMath::Max(TDSLockstep::CVarHashInterval.GetValueOnGameThread(), 1);
+    if (CurrentTick % HashInterval == 0)
+    {
+        ServerHashes.Add(CurrentTick, ComputeHash());
+        ServerHashes.Remove(CurrentTick - HashInterval * TDSLockstep::HashHistory);
+    }
+}
+
+void UTDSLockstepSubsystem::ReceiveInput(const ATDSCharacter& From, int32 Tick, const FTDSLockstepInput& Input)
+{
+    const int32 Slot = bActive ? Roster.IndexOfByKey(&From) : INDEX_NONE;
+    if (Slot == INDEX_NONE || Tick <= CurrentTick)
+    {
+        return;
+    }
+
+    TArray<TPair<int32, FTDSLockstepInput>>& Pending = SlotInputs[Slot].Pending;
+    if (Pending.Num() < TDSLockstep::MaxPendingInputs)
+    {
+        Pending.Emplace(Tick, Input);
+    }
+}
+
+void UTDSLockstepSubsystem::ReceiveHash(const ATDSCharacter& From, int32 Tick, uint32 Hash)
+{
+    const uint32* ServerHash = bActive ? ServerHashes.Find(Tick) : nullptr;
+    if (!ServerHash || *ServerHash == Hash)
+    {
+        return;
+    }
+
+    UE_LOG(LogTemp, Warning, TEXT("TDSLockstep: %s desynced at tick %d, resyncing"), *From.GetName(), Tick);
+    FTDSPerfCounters::Get().CountLockstepDesync();
+
+    // Хэши до пересинхронизации больше не сравнимы
+    ServerHashes.Reset();
+    BroadcastSnapshot();
+}
+
+void UTDSLockstepSubsystem::BroadcastSnapshot()
+{
+    FTDSLockstepSnapshot Snapshot;
+    Snapshot.bActive = bActive;
+    Snapshot.Tick = CurrentTick;
+    Snapshot.StepSeconds = StepSeconds;
+
+    if (bActive)
+    {
+        for (const TWeakObjectPtr<ATDSCharacter>& Character : Roster)
+        {
+            FTDSLockstepCharacterState& State = Snapshot.Characters.AddDefaulted_GetRef();
+            if (Character.IsValid())
+            {
+                State.Capture(*Character);
+
+                // Сервер продолжает с тех же округлённых значений, что и клиенты
+                State.Apply();
+            }
+        }
+    }
+
+    for (const TWeakObjectPtr<ATDSCharacter>& Character : Roster)
+    {
+        if (Character.IsValid() && IsRemotelyControlled(*Character))
+        {
+            Character->ClientLockstepSnapshot(Snapshot);
+        }
+    }
+}
+
+void UTDSLockstepSubsystem::StopServer()
+{
+    bActive = false;
+    BroadcastSnapshot();
+
+    for (const TWeakObjectPtr<ATDSCharacter>& Character : Roster)
+    {
+        if (Character.IsValid())
+        {
+            SetCharacterDriven(*Character, false);
+        }
+    }
+
+    Roster.Reset();
+    SlotInputs.Reset();
+    ServerHashes.Reset();
+    UE_LOG(LogTemp, Log, TEXT("TDSLockstep: stopped at tick %d"), CurrentTick);
+}
+
+#pragma endregion
+
+#pragma region Client
+
+void UTDSLockstepSubsystem::ReceiveSnapshot(const FTDSLockstepSnapshot& Snapshot)
+{
+    TArray<TWeakObjectPtr<ATDSCharacter>> OldRoster = MoveTemp(Roster);
+    Roster.Reset();
+    bActive = Snapshot.bActive;
+
+    if (bActive)
+    {
+        // Ещё не реплицированный персонаж придёт пустым местом – расхождение хэша пришлёт снимок повторно
+        for (const FTDSLockstepCharacterState& State : Snapshot.Characters)
+        {
+            Roster.Add(State.Character.Get());
+            if (State.Character)
+            {
+                State.Apply();
+                if (!OldRoster.Contains(State.Character.Get()))
+                {
+                    SetCharacterDriven(*State.Character, true);
+                }
+            }
+        }
+
+        CurrentTick = Snapshot.Tick;
+        StepSeconds = Snapshot.StepSeconds;
+        PendingFrames.RemoveAll([this](const FTDSLockstepFrame& Frame) { return Frame.Tick <= CurrentTick; });
+    }
+    else
+    {
+        PendingFrames.Reset();
+    }
+
+    for (const TWeakObjectPtr<ATDSCharacter>& Character : OldRoster)
+    {
+        if (Character.IsValid() && !Roster.Contains(Character))
+        {
+            SetCharacterDriven(*Character, false);
+        }
+    }
+}
+
+void UTDSLockstepSubsystem::ReceiveFrame(const FTDSLockstepFrame& Frame)
+{
+    if (bActive && Frame.Tick > CurrentTick)
+    {
+        PendingFrames.Add(Frame);
+    }
+}
+
+void UTDSLockstepSubsystem::TickClient()
+{
+    if (!bActive || PendingFrames.IsEmpty())
+    {
+        return;
+    }
+
+    ATDSCharacter* LocalCharacter = nullptr;
+    for (const TWeakObjectPtr<ATDSCharacter>& Character : Roster)
+    {
+        if (Character.IsValid() && Character->IsLocallyControlled())
+        {
+            LocalCharacter = Character.Get();
+            break;
+        }
+    }
+
+    const int32 InputDelay = FMath::Max(TDSLockstep::CVarInputDelay.GetValueOnGameThread(), 1);
+    const int32 HashInterval = FMath::Max(TDSLockstep::CVarHashInterval.GetValueOnGameThread(), 1);
+
+    // Кадры идут с темпом сервера; накопившиеся после подвисания догоняем по несколько за кадр
+    int32 NumSteps = 0;
+    for (; NumSteps < PendingFrames.Num() && NumSteps < TDSLockstep::MaxStepsPerFrame; ++NumSteps)
+    {
+        const FTDSLockstepFrame& Frame = PendingFrames[NumSteps];
+        Simulate(Frame);
+        CurrentTick = Frame.Tick;
+
+        if (LocalCharacter)
+        {
+            if (UTDSCharacterMovementComponent* MoveComp = LocalCharacter->GetTDSMovementComponent())
+            {
+                LocalCharacter->ServerLockstepInput(CurrentTick + InputDelay, MoveComp->ConsumeLockstepInput());
+            }
+
+            if (CurrentTick % HashInterval == 0)
+            {
+                LocalCharacter->ServerLockstepHash(CurrentTick, ComputeHash());
+            }
+        }
+    }
+    PendingFrames.RemoveAt(0, NumSteps, EAllowShrinking::No);
+}
+
+#pragma endregion
+
+void UTDSLockstepSubsystem::Simulate(const FTDSLockstepFrame& Frame)
+{
+    SCOPE_CYCLE_COUNTER(STAT_TDSLockstepSimulate);
+
+    // Другой состав – симулировать нечем, хэш это покажет
+    if (Frame.Inputs.Num() != Roster.Num())
+    {
+        return;
+    }
+
+    for (int32 Slot = 0; Slot < Roster.Num(); ++Slot)
+    {
+        ATDSCharacter* Character = Roster[Slot].Get();
+        UTDSCharacterMovementComponent* MoveComp = Character ? Character->GetTDSMovementComponent() : nullptr;
+        if (MoveComp)
+        {
+            MoveComp->SimulateLockstepTick(StepSeconds, Frame.Inputs[Slot]);
+        }
+    }
+}
+
+uint32 UTDSLockstepSubsystem::ComputeHash() const
+{
+    uint32 Hash = 0;
+    for (const TWeakObjectPtr<ATDSCharacter>& Character : Roster)
+    {
+        FTDSLockstepCharacterState State;
+        if (Character.IsValid())
+        {
+            State.Capture(*Character);
+        }
+
+        // Сантиметры: расхождения мельче не накапливаются в видимую ошибку до следующей сверки
+        const int32 Values[] =
+        {
+            State.Location.X / 100, State.Location.Y / 100, State.Location.Z / 100,
+            State.Velocity.X / 100, State.Velocity.Y / 100, State.Velocity.Z / 100,
+            State.MovementMode, State.CustomMovementMode, Character.IsValid() ? 1 : 0
+        };
+        Hash = FCrc::MemCrc32(Values, sizeof(Values), Hash);
+    }
+    return Hash;
+}
@@ -0,0 +1,99 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TDSLockstep.h"
+#include "TDSLockstepSubsystem.generated.h"
+
+class ATDSCharacter;
+
+/**
+ * Режим lockstep по вводу для небольших LAN-матчей (TDS.Lockstep.Enabled).
+ * Вместо состояния персонажей по сети идёт только сжатый ввод (FTDSLockstepInput) каждого шага:
+ *   клиент → сервер: свой ввод на шаг «последний симулированный + TDS.Lockstep.InputDelay»;
+ *   сервер → клиенты: вводы всех персонажей состава (FTDSLockstepFrame) раз в фиксированный шаг.
+ * Все участники выполняют UTDSCharacterMovementComponent::SimulateLockstepTick с одинаковым шагом
+ * в порядке состава, обычный тик компонента движения и репликация движения выключены.
+ *
+ * Раз в TDS.Lockstep.HashInterval шагов клиенты отправляют хэш состояния; при расхождении, как и при
+ * смене состава, сервер рассылает всем FTDSLockstepSnapshot и применяет его к себе.
+ * Режим включается, только пока сервер держит LAN-сессию не больше чем на TDS.Lockstep.MaxPublicConnections
+ * мест и у каждого игрока есть персонаж; иначе персонажи возвращаются к обычной репликации.
+ *
+ * В состав входят только персонажи под APlayerController. ИИ ведёт персонажа через RequestedVelocity
+ * (path following), а ввод шага берёт лишь ConsumeInputVector – под lockstep ИИ стоял бы на месте,
+ * поэтому его персонажи остаются на обычном тике и репликации.
+ */
+UCLASS()
+class TOPDOWNSHOOTER_API UTDSLockstepSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    bool IsActive() const { return bActive; }
+
+    /** Сервер: ввод владельца персонажа (ATDSCharacter::ServerLockstepInput) */
+    void ReceiveInput(const ATDSCharacter& From, int32 Tick, const FTDSLockstepInput& Input);
+
+    /** Сервер: хэш состояния клиента после шага Tick (ATDSCharacter::ServerLockstepHash) */
+    void ReceiveHash(const ATDSCharacter& From, int32 Tick, uint32 Hash);
+
+    /** Клиент: вводы шага (ATDSCharacter::ClientLockstepFrame) */
+    void ReceiveFrame(const FTDSLockstepFrame& Frame);
+
+    /** Клиент: состав и состояние (ATDSCharacter::ClientLockstepSnapshot) */
+    void ReceiveSnapshot(const FTDSLockstepSnapshot& Snapshot);
+
+private:
+    bool bActive = false;
+
+    /** Состав: порядок симуляции и индексы вводов в кадре */
+    TArray<TWeakObjectPtr<ATDSCharacter>> Roster;
+
+    /** Последний симулированный шаг */
+    int32 CurrentTick = 0;
+    float StepSeconds = 0.0f;
+
+    /** Сервер */
+    struct FSlotInputs
+    {
+        /** Ввод, пришедший заранее: шаг и значение */
+        TArray<TPair<int32, FTDSLockstepInput>> Pending;
+
+        /** Повторяется, если ввод на шаг не успел */
+        FTDSLockstepInput Last;
+    };
+    TArray<FSlotInputs> SlotInputs;
+    TMap<int32, uint32> ServerHashes;
+    float Accumulator = 0.0f;
+
+    /** Клиент: кадры, ещё не симулированные */
+    TArray<FTDSLockstepFrame> PendingFrames;
+
+    bool ShouldRunOnServer() const;
+    bool HasRosterChanged() const;
+    void BuildRoster();
+
+    void TickServer(float DeltaTime);
+    void StepServer();
+    void TickClient();
+
+    /** Разослать состав и состояние всем клиентам и применить то же округление к себе */
+    void BroadcastSnapshot();
+    void StopServer();
+
+    /** Передать движение персонажа lockstep или вернуть обычному тику и репликации */
+    static void SetCharacterDriven(ATDSCharacter& Character, bool bDriven);
+    static bool IsPlayerCharacter(const ATDSCharacter& Character);
+    static bool IsRemotelyControlled(const ATDSCharacter& Character);
+
+    void Simulate(const FTDSLockstepFrame& Frame);
+    uint32 ComputeHash() const;
+};
@@ -0,0 +1,185 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSNetCompression.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+void FTDSHuffmanCodec::BuildCodeLengths(const uint64 (&Frequencies)[NumSymbols], uint8 (&OutLengths)[NumSymbols])
+{
+    // Каждому байту нужен код: +1 к частоте, чтобы не встретившиеся в выборке значения тоже кодировались
+    uint64 Weights[NumSymbols];
+    for (int32 Symbol = 0; Symbol < NumSymbols; ++Symbol)
+    {
+        Weights[Symbol] = Frequencies[Symbol] + 1;
+    }
+
+    for (;;)
+    {
+        // Узлы дерева: листья 0..255, внутренние – дальше; Parent нужен только для глубины листьев
+        struct FNode
+        {
+            uint64 Weight;
+            int32 Index;
+        };
+        int32 Parents[NumSymbols * 2] = {};
+        TArray<FNode> Heap;
+        Heap.Reserve(NumSymbols);
+        for (int32 Symbol = 0; Symbol < NumSymbols; ++Symbol)
+        {
+            Heap.Add({ Weights[Symbol], Symbol });
+        }
+
+        const auto Less = [](const FNode& A, const FNode& B) { return A.Weight < B.Weight || (A.Weight == B.Weight && A.Index < B.Index); };
+        Heap.Heapify(Less);
+
+        int32 NextIndex = NumSymbols;
+        while (Heap.Num() > 1)
+        {
+            FNode A;
+            FNode B;
+            Heap.HeapPop(A, Less, EAllowShrinking::No);
+            Heap.HeapPop(B, Less, EAllowShrinking::No);
+            Parents[A.Index] = NextIndex;
+            Parents[B.Index] = NextIndex;
+            Heap.HeapPush({ A.Weight + B.Weight, NextIndex++ }, Less);
+        }
+
+        const int32 Root = NextIndex - 1;
+        int32 MaxLength = 0;
+        for (int32 Symbol = 0; Symbol < NumSymbols; ++Symbol)
+        {
+            int32 Length = 0;
+            for (int32 Node = Symbol; Node != Root; Node = Parents[Node])
+            {
+                ++Length;
+            }
+            OutLengths[Symbol] = static_cast<uint8>(FMath::Min(Length, 255));
+            MaxLength = FMath::Max(MaxLength, Length);
+        }
+
+        if (MaxLength <= MaxCodeLength)
+        {
+            return;
+        }
+
+        // Слишком длинные коды: сглаживаем распределение и строим заново
+        for (uint64& Weight : Weights)
+        {
+            Weight = (Weight >> 1) | 1;
+        }
+    }
+}
+
+bool FTDSHuffmanCodec::Initialize(TConstArrayView<uint8> InLengths)
+{
+    bValid = false;
+    if (InLengths.Num() != NumSymbols)
+    {
+        return false;
+    }
+
+    FMemory::Memzero(LengthCounts);
+    for (int32 Symbol = 0; Symbol < NumSymbols; ++Symbol)
+    {
+        const uint8 Length = InLengths[Symbol];
+        if (Length == 0 || Length > MaxCodeLength)
+        {
+            return false;
+        }
+        Lengths[Symbol] = Length;
+        ++LengthCounts[Length];
+    }
+
+    // Канонические коды (как в DEFLATE): коды одной длины идут подряд в порядке значений байта
+    uint16 NextCode[MaxCodeLength + 1] = {};
+    uint32 Code = 0;
+    int32 Offsets[MaxCodeLength + 1] = {};
+    for (int32 Length = 1; Length <= MaxCodeLength; ++Length)
+    {
+        Code = (Code + LengthCounts[Length - 1]) << 1;
+        NextCode[Length] = static_cast<uint16>(Code);
+        Offsets[Length] = Offsets[Length - 1] + LengthCounts[Length - 1];
+    }
+
+    // Полнота кода: сумма 2^-len == 1, иначе декодер может зависнуть на несуществующем коде
+    uint32 Kraft = 0;
+    for (int32 Length = 1; Length <= MaxCodeLength; ++Length)
+    {
+        Kraft += static_cast<uint32>(LengthCounts[Length]) << (MaxCodeLength - Length);
+    }
+    if (Kraft != (1u << MaxCodeLength))
+    {
+        return false;
+    }
+
+    for (int32 Symbol = 0; Symbol < NumSymbols; ++Symbol)
+    {
+        const uint8 Length = Lengths[Symbol];
+        Codes[Symbol] = NextCode[Length]++;
+        SortedSymbols[Offsets[Length]++] = static_cast<uint8>(Symbol);
+    }
+
+    bValid = true;
+    return true;
+}
+
+int64 FTDSHuffmanCodec::GetEncodedBits(const uint8* Data, int32 NumBytes) const
+{
+    int64 Bits = 0;
+    for (int32 Index = 0; Index < NumBytes; ++Index)
+    {
+        Bits += Lengths[Data[Index]];
+    }
+    return Bits;
+}
+
+void FTDSHuffmanCodec::Encode(const uint8* Data, int32 NumBytes, FBitWriter& Out) const
+{
+    for (int32 Index = 0; Index < NumBytes; ++Index)
+    {
+        const uint8 Symbol = Data[Index];
+        const uint16 Code = Codes[Symbol];
+
+        // Старший бит кода первым – так его читает Decode
+        for (int32 Bit = Lengths[Symbol] - 1; Bit >= 0; --Bit)
+        {
+            Out.WriteBit((Code >> Bit) & 1);
+        }
+    }
+}
+
+bool FTDSHuffmanCodec::Decode(FBitReader& In, int32 NumBytes, uint8* OutData) const
+{
+    for (int32 Index = 0; Index < NumBytes; ++Index)
+    {
+        int32 Code = 0;
+        int32 First = 0;
+        int32 SymbolIndex = 0;
+        int32 Length = 1;
+        for (; Length <= MaxCodeLength; ++Length)
+        {
+            Code |= In.ReadBit();
+            if (In.IsError())
+            {
+                return false;
+            }
+
+            const int32 Count = LengthCounts[Length];
+            if (Code - First < Count)
+            {
+                OutData[Index] = SortedSymbols[SymbolIndex + Code - First];
+                break;
+            }
+
+            SymbolIndex += Count;
+            First = (First + Count) << 1;
+            Code <<= 1;
+        }
+
+        if (Length > MaxCodeLength)
+        {
+            return false;
+        }
+    }
+    return true;
+}
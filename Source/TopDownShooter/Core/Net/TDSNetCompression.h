@@ -0,0 +1,71 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "TDSNetCompression.generated.h"
+
+class FBitReader;
+class FBitWriter;
+
+/**
+ * Статический канонический код Хаффмана по байтам пакета.
+ * Таблица не передаётся по сети: длины кодов обучены заранее (UTDSNetDictionaryCommandlet)
+ * и лежат в UTDSNetDictionary, одинаковом у сервера и клиентов.
+ */
+class TOPDOWNSHOOTER_API FTDSHuffmanCodec
+{
+public:
+    static constexpr int32 NumSymbols = 256;
+    static constexpr int32 MaxCodeLength = 15;
+
+    /** Длины кодов по частотам байтов; у каждого байта есть код, длина не больше MaxCodeLength */
+    static void BuildCodeLengths(const uint64 (&Frequencies)[NumSymbols], uint8 (&OutLengths)[NumSymbols]);
+
+    /** Построить коды по длинам; false, если длины не образуют полный префиксный код */
+    bool Initialize(TConstArrayView<uint8> Lengths);
+
+    bool IsValid() const { return bValid; }
+
+    /** Число бит, которое займут NumBytes байт */
+    int64 GetEncodedBits(const uint8* Data, int32 NumBytes) const;
+
+    void Encode(const uint8* Data, int32 NumBytes, FBitWriter& Out) const;
+
+    /** false при обрыве или повреждении потока */
+    bool Decode(FBitReader& In, int32 NumBytes, uint8* OutData) const;
+
+private:
+    uint8 Lengths[NumSymbols] = {};
+    uint16 Codes[NumSymbols] = {};
+
+    /** Число кодов каждой длины и символы, упорядоченные по (длина, байт) – для побитового декодирования */
+    uint16 LengthCounts[MaxCodeLength + 1] = {};
+    uint8 SortedSymbols[NumSymbols] = {};
+
+    bool bValid = false;
+};
+
+/** Словарь сжатия пакетов TDS: длины кодов Хаффмана, обученные на записанном трафике */
+UCLASS(BlueprintType)
+class TOPDOWNSHOOTER_API UTDSNetDictionary : public UDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    /** Длина кода для каждого значения байта (256 записей) */
+    UPROPERTY(VisibleAnywhere, Category = "TDS Net")
+    TArray<uint8> CodeLengths;
+
+    /** Объём обучающей выборки – для справки */
+    UPROPERTY(VisibleAnywhere, Category = "TDS Net")
+    int32 TrainedPackets = 0;
+
+    UPROPERTY(VisibleAnywhere, Category = "TDS Net")
+    int64 TrainedBytes = 0;
+
+    /** Степень сжатия на обучающей выборке, сжатые/исходные */
+    UPROPERTY(VisibleAnywhere, Category = "TDS Net")
+    float TrainedRatio = 1.0f;
+};
@@ -0,0 +1,353 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSReplayFormat.h"
+#include "Algo/BinarySearch.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+
+namespace TDSReplay
+{
+    /** Биты маски изменений персонажа */
+    enum EFieldBits : uint8
+    {
+        Field_Location = 1 << 0,
+        Field_Aim      = 1 << 1,
+        Field_Gait     = 1 << 2,
+        Field_Mode     = 1 << 3,
+        Field_State    = 1 << 4,
+        Field_New      = 1 << 5,
+    };
+
+    /** Размер заголовка блока: тип, время, размер */
+    static constexpr int32 ChunkHeaderSize = sizeof(uint8) + sizeof(float) + sizeof(uint32);
+
+    /** Защита от повреждённого файла */
+    static constexpr uint32 MaxEntries = 1 << 16;
+
+    /** Знаковые разности в беззнаковые: малые по модулю значения занимают один байт SerializeIntPacked */
+    static uint32 ZigZag(int32 Value)
+    {
+        return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+    }
+
+    static int32 UnZigZag(uint32 Value)
+    {
+        return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1);
+    }
+
+    static void WriteSigned(FArchive& Ar, int32 Value)
+    {
+        uint32 Packed = ZigZag(Value);
+        Ar.SerializeIntPacked(Packed);
+    }
+
+    static int32 ReadSigned(FArchive& Ar)
+    {
+        uint32 Packed = 0;
+        Ar.SerializeIntPacked(Packed);
+        return UnZigZag(Packed);
+    }
+
+    static void WritePacked(FArchive& Ar, uint32 Value)
+    {
+        Ar.SerializeIntPacked(Value);
+    }
+
+    static uint32 ReadPacked(FArchive& Ar)
+    {
+        uint32 Value = 0;
+        Ar.SerializeIntPacked(Value);
+        return Value;
+    }
+
+    static uint8 GetChangedFields(const FTDSReplayCharacterState& Base, const FTDSReplayCharacterState& Current)
+    {
+        return (Base.Location != Current.Location ? Field_Location : 0)
+            | (Base.AimYaw != Current.AimYaw ? Field_Aim : 0)
+            | (Base.Gait != Current.Gait ? Field_Gait : 0)
+            | (Base.MovementMode != Current.MovementMode || Base.CustomMovementMode != Current.CustomMovementMode ? Field_Mode : 0)
+            | (Base.StateMask != Current.StateMask ? Field_State : 0);
+    }
+
+    void WriteHeader(FArchive& Ar, const FString& MapName)
+    {
+        uint32 HeaderMagic = Magic;
+        uint32 HeaderVersion = Version;
+        FString Map = MapName;
+        Ar << HeaderMagic << HeaderVersion << Map;
+    }
+
+    void WriteChunk(FArchive& Ar, EChunk Type, float Time, const TArray<uint8>& Payload)
+    {
+        uint8 ChunkType = static_cast<uint8>(Type);
+        uint32 Size = Payload.Num();
+        Ar << ChunkType << Time << Size;
+        Ar.Serialize(const_cast<uint8*>(Payload.GetData()), Payload.Num());
+    }
+
+    bool WriteDelta(FArchive& Ar, const FTDSReplayState& Base, const FTDSReplayState& Current)
+    {
+        // Маски считаем заранее – в начале нужен счётчик изменённых
+        TArray<TPair<uint32, uint8>, TInlineAllocator<64>> Changed;
+        for (const TPair<uint32, FTDSReplayCharacterState>& Entry : Current)
+        {
+            const FTDSReplayCharacterState* Previous = Base.Find(Entry.Key);
+            const uint8 Fields = Previous ? GetChangedFields(*Previous, Entry.Value)
+                : Field_New | GetChangedFields(FTDSReplayCharacterState(), Entry.Value);
+            if (Fields)
+            {
+                Changed.Emplace(Entry.Key, Fields);
+            }
+        }
+
+        TArray<uint32, TInlineAllocator<16>> Removed;
+        for (const TPair<uint32, FTDSReplayCharacterState>& Entry : Base)
+        {
+            if (!Current.Contains(Entry.Key))
+            {
+                Removed.Add(Entry.Key);
+            }
+        }
+
+        if (Changed.IsEmpty() && Removed.IsEmpty())
+        {
+            return false;
+        }
+
+        static const FTDSReplayCharacterState Empty;
+
+        WritePacked(Ar, Changed.Num());
+        for (const TPair<uint32, uint8>& Entry : Changed)
+        {
+            const FTDSReplayCharacterState& Value = Current[Entry.Key];
+            const FTDSReplayCharacterState* Previous = Base.Find(Entry.Key);
+            const FTDSReplayCharacterState& From = Previous ? *Previous : Empty;
+            uint8 Fields = Entry.Value;
+
+            WritePacked(Ar, Entry.Key);
+            Ar << Fields;
+
+            if (Fields & Field_Location)
+            {
+                WriteSigned(Ar, Value.Location.X - From.Location.X);
+                WriteSigned(Ar, Value.Location.Y - From.Location.Y);
+                WriteSigned(Ar, Value.Location.Z - From.Location.Z);
+            }
+            if (Fields & Field_Aim)
+            {
+                // Разность по кругу: поворот через 0 – маленькое число
+                WriteSigned(Ar, static_cast<int16>(Value.AimYaw - From.AimYaw));
+            }
+            if (Fields & Field_Gait)
+            {
+                uint8 Gait = Value.Gait;
+                Ar << Gait;
+            }
+            if (Fields & Field_Mode)
+            {
+                uint8 MovementMode = Value.MovementMode;
+                uint8 CustomMovementMode = Value.CustomMovementMode;
+                Ar << MovementMode << CustomMovementMode;
+            }
+            if (Fields & Field_State)
+            {
+                uint8 StateMask = Value.StateMask;
+                Ar << StateMask;
+            }
+        }
+
+        WritePacked(Ar, Removed.Num());
+        for (const uint32 Id : Removed)
+        {
+            WritePacked(Ar, Id);
+        }
+        return true;
+    }
+
+    bool ApplyDelta(FArchive& Ar, FTDSReplayState& State)
+    {
+        const uint32 NumChanged = ReadPacked(Ar);
+        if (NumChanged > MaxEntries)
+        {
+            return false;
+        }
+
+        for (uint32 Index = 0; Index < NumChanged && !Ar.IsError(); ++Index)
+        {
+            const uint32 Id = ReadPacked(Ar);
+            uint8 Fields = 0;
+            Ar << Fields;
+
+            FTDSReplayCharacterState& Value = State.FindOrAdd(Id);
+            if (Fields & Field_New)
+            {
+                Value = FTDSReplayCharacterState();
+            }
+
+            if (Fields & Field_Location)
+            {
+                Value.Location.X += ReadSigned(Ar);
+                Value.Location.Y += ReadSigned(Ar);
+                Value.Location.Z += ReadSigned(Ar);
+            }
+            if (Fields & Field_Aim)
+            {
+                Value.AimYaw = static_cast<uint16>(Value.AimYaw + ReadSigned(Ar));
+            }
+            if (Fields & Field_Gait)
+            {
+                Ar << Value.Gait;
+            }
+            if (Fields & Field_Mode)
+            {
+                Ar << Value.MovementMode << Value.CustomMovementMode;
+            }
+            if (Fields & Field_State)
+            {
+                Ar << Value.StateMask;
+            }
+        }
+
+        const uint32 NumRemoved = ReadPacked(Ar);
+        if (NumRemoved > MaxEntries)
+        {
+            return false;
+        }
+
+        for (uint32 Index = 0; Index < NumRemoved && !Ar.IsError(); ++Index)
+        {
+            State.Remove(ReadPacked(Ar));
+        }
+        return !Ar.IsError();
+    }
+}
+
+bool FTDSReplayReader::Open(const FString& Path)
+{
+    Data.Reset();
+    Chunks.Reset();
+    Checkpoints.Reset();
+    State.Reset();
+    CheckpointState.Reset();
+    CheckpointCursor = INDEX_NONE;
+    NextChunk = 0;
+    CurrentTime = 0.0f;
+
+    if (!FFileHelper::LoadFileToArray(Data, *Path))
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSReplay: failed to read %s"), *Path);
+        return false;
+    }
+
+    FMemoryReader Reader(Data);
+    uint32 FileMagic = 0;
+    uint32 FileVersion = 0;
+    Reader << FileMagic << FileVersion;
+    if (FileMagic != TDSReplay::Magic || FileVersion != TDSReplay::Version)
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSReplay: %s is not a TDS replay (version %u)"), *Path, FileVersion);
+        return false;
+    }
+    Reader << MapName;
+
+    // Оглавление: только заголовки блоков, данные читаются при перемотке.
+    // Оборванный в конце блок (сервер упал во время записи) отбрасывается.
+    while (!Reader.IsError() && Reader.TotalSize() - Reader.Tell() >= TDSReplay::ChunkHeaderSize)
+    {
+        uint8 Type = 0;
+        FChunk Chunk;
+        uint32 Size = 0;
+        Reader << Type << Chunk.Time << Size;
+
+        Chunk.Type = static_cast<TDSReplay::EChunk>(Type);
+        Chunk.Offset = static_cast<int32>(Reader.Tell());
+        Chunk.Size = static_cast<int32>(Size);
+        if (Size > static_cast<uint32>(Reader.TotalSize() - Reader.Tell()))
+        {
+            break;
+        }
+
+        if (Chunk.Type == TDSReplay::EChunk::Checkpoint)
+        {
+            Checkpoints.Add(Chunks.Num());
+        }
+        Chunks.Add(Chunk);
+        Reader.Seek(Chunk.Offset + Chunk.Size);
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("TDSReplay: %s – %s, %.1f s, %d chunks, %d checkpoints"),
+        *Path, *MapName, GetDuration(), Chunks.Num(), Checkpoints.Num());
+    return true;
+}
+
+bool FTDSReplayReader::ApplyChunk(const FChunk& Chunk, FTDSReplayState& InOutState) const
+{
+    // Пустой блок – контрольная точка без изменений
+    if (Chunk.Size == 0)
+    {
+        return true;
+    }
+
+    // Читатель ограничен данными блока: повреждённая разность не уйдёт в следующий блок
+    FMemoryReaderView Reader(MakeArrayView(Data.GetData() + Chunk.Offset, Chunk.Size));
+    return TDSReplay::ApplyDelta(Reader, InOutState);
+}
+
+bool FTDSReplayReader::SeekTo(float Time)
+{
+    // Последняя контрольная точка не позже Time
+    const int32 Checkpoint = Algo::UpperBoundBy(Checkpoints, Time, [this](int32 ChunkIndex) { return Chunks[ChunkIndex].Time; }) - 1;
+
+    if (Checkpoint < CheckpointCursor)
+    {
+        CheckpointState.Reset();
+        CheckpointCursor = INDEX_NONE;
+    }
+
+    for (; CheckpointCursor < Checkpoint; ++CheckpointCursor)
+    {
+        if (!ApplyChunk(Chunks[Checkpoints[CheckpointCursor + 1]], CheckpointState))
+        {
+            CheckpointState.Reset();
+            CheckpointCursor = INDEX_NONE;
+            return false;
+        }
+    }
+
+    if (Checkpoint == INDEX_NONE)
+    {
+        State.Reset();
+        NextChunk = 0;
+        CurrentTime = 0.0f;
+    }
+    else
+    {
+        State = CheckpointState;
+        NextChunk = Checkpoints[Checkpoint] + 1;
+        CurrentTime = Chunks[Checkpoints[Checkpoint]].Time;
+    }
+
+    return AdvanceTo(Time);
+}
+
+bool FTDSReplayReader::AdvanceTo(float Time)
+{
+    for (; NextChunk < Chunks.Num() && Chunks[NextChunk].Time <= Time; ++NextChunk)
+    {
+        const FChunk& Chunk = Chunks[NextChunk];
+
+        // Контрольные точки повторяют уже применённые кадры
+        if (Chunk.Type != TDSReplay::EChunk::Frame)
+        {
+            continue;
+        }
+
+        if (!ApplyChunk(Chunk, State))
+        {
+            UE_LOG(LogTemp, Error, TEXT("TDSReplay: corrupted frame at %.2f s"), Chunk.Time);
+            return false;
+        }
+        CurrentTime = Chunk.Time;
+    }
+    return true;
+}
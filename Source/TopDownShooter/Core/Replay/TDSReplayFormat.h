@@ -0,0 +1,120 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Формат записи матча TDS (*.tdsreplay) – собственный поток, не DemoNetDriver.
+ * Хранится только то, что нужно для разбора: положение, прицел, гейт и режимы движения персонажей.
+ *
+ *   заголовок: Magic, Version, имя карты
+ *   блоки:     [тип uint8][время float][размер uint32][данные]
+ *
+ * Кадр – изменения относительно предыдущего кадра, контрольная точка – изменения относительно
+ * предыдущей контрольной точки. Полное состояние на контрольной точке получается применением всех
+ * предыдущих контрольных точек, дальше воспроизведение идёт кадрами (FTDSReplayReader).
+ */
+struct TOPDOWNSHOOTER_API FTDSReplayCharacterState
+{
+    /** Положение, см */
+    FIntVector Location = FIntVector::ZeroValue;
+
+    /** Yaw прицела, 65536 шагов на оборот */
+    uint16 AimYaw = 0;
+
+    /** EGait */
+    uint8 Gait = 0;
+
+    /** EMovementMode и ETDSCustomMovementMode */
+    uint8 MovementMode = 0;
+    uint8 CustomMovementMode = 0;
+
+    /** FTDSMovementState::ToMask */
+    uint8 StateMask = 0;
+
+    bool operator==(const FTDSReplayCharacterState& Other) const
+    {
+        return Location == Other.Location && AimYaw == Other.AimYaw && Gait == Other.Gait
+            && MovementMode == Other.MovementMode && CustomMovementMode == Other.CustomMovementMode
+            && StateMask == Other.StateMask;
+    }
+
+    FRotator GetAimRotation() const { return FRotator(0.0, FRotator::DecompressAxisFromShort(AimYaw), 0.0); }
+};
+
+/** Состояние всех персонажей по идентификатору записи */
+using FTDSReplayState = TMap<uint32, FTDSReplayCharacterState>;
+
+namespace TDSReplay
+{
+    static constexpr uint32 Magic = 0x52534454; // 'TDSR'
+    static constexpr uint32 Version = 1;
+
+    enum class EChunk : uint8
+    {
+        Frame,
+        Checkpoint
+    };
+
+    /** Заголовок файла */
+    TOPDOWNSHOOTER_API void WriteHeader(FArchive& Ar, const FString& MapName);
+
+    /** Блок целиком, вместе со своим заголовком */
+    TOPDOWNSHOOTER_API void WriteChunk(FArchive& Ar, EChunk Type, float Time, const TArray<uint8>& Payload);
+
+    /** Изменения Current относительно Base; false – изменений нет и ничего не записано */
+    TOPDOWNSHOOTER_API bool WriteDelta(FArchive& Ar, const FTDSReplayState& Base, const FTDSReplayState& Current);
+
+    /** Применить изменения, записанные WriteDelta */
+    TOPDOWNSHOOTER_API bool ApplyDelta(FArchive& Ar, FTDSReplayState& State);
+}
+
+/**
+ * Чтение и перемотка записи.
+ * SeekTo встаёт на ближайшую предыдущую контрольную точку и досчитывает кадры вперёд,
+ * AdvanceTo только досчитывает кадры – для обычного воспроизведения.
+ */
+class TOPDOWNSHOOTER_API FTDSReplayReader
+{
+public:
+    bool Open(const FString& Path);
+
+    const FString& GetMapName() const { return MapName; }
+    float GetDuration() const { return Chunks.Num() ? Chunks.Last().Time : 0.0f; }
+
+    /** Время последнего применённого блока */
+    float GetTime() const { return CurrentTime; }
+
+    const FTDSReplayState& GetState() const { return State; }
+
+    bool SeekTo(float Time);
+    bool AdvanceTo(float Time);
+
+private:
+    struct FChunk
+    {
+        TDSReplay::EChunk Type;
+        float Time;
+        int32 Offset;
+        int32 Size;
+    };
+
+    TArray<uint8> Data;
+    TArray<FChunk> Chunks;
+
+    /** Индексы блоков-контрольных точек в Chunks */
+    TArray<int32> Checkpoints;
+
+    FString MapName;
+
+    FTDSReplayState State;
+    int32 NextChunk = 0;
+    float CurrentTime = 0.0f;
+
+    /** Накопленное состояние контрольных точек 0..CheckpointCursor – перемотка вперёд продолжает с него */
+    FTDSReplayState CheckpointState;
+    int32 CheckpointCursor = INDEX_NONE;
+
+    bool ApplyChunk(const FChunk& Chunk, FTDSReplayState& InOutState) const;
+};
@@ -0,0 +1,343 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSReplaySubsystem.h"
+#include "TDSCharacter.h"
+#include "TDSCharacterMovementComponent.h"
+#include "TDSStats.h"
+#include "Containers/Queue.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+
+DECLARE_CYCLE_STAT(TEXT("TDS Replay Record"), STAT_TDSReplayRecord, STATGROUP_TDS);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("TDS Replay Frame Fraction"), STAT_TDSReplayFrameFraction, STATGROUP_TDS);
+
+namespace TDSReplay
+{
+    static TAutoConsoleVariable<bool> CVarRecord(
+        TEXT("TDS.Replay.Record"), false,
+        TEXT("Записывать матч в Saved/Replays (читается при старте карты; -TDSReplay=<папка> включает запись всегда)."));
+
+    static TAutoConsoleVariable<float> CVarSampleInterval(
+        TEXT("TDS.Replay.SampleInterval"), 0.05f,
+        TEXT("Интервал снимков состояния персонажей, с."));
+
+    static TAutoConsoleVariable<float> CVarCheckpointInterval(
+        TEXT("TDS.Replay.CheckpointInterval"), 5.0f,
+        TEXT("Интервал контрольных точек, с. Чем чаще, тем быстрее перемотка и больше файл."));
+
+    static TAutoConsoleVariable<float> CVarMaxFrameFraction(
+        TEXT("TDS.Replay.MaxFrameFraction"), 0.01f,
+        TEXT("Доля времени кадра, которую может занимать запись; при превышении интервал снимков удваивается."));
+
+    /** Окно сверки затрат записи с временем кадра, с */
+    static constexpr float BudgetWindowSeconds = 10.0f;
+
+    /** Предел удвоения интервала снимков, с */
+    static constexpr float MaxSampleInterval = 0.5f;
+}
+
+/** Фоновый поток записи: игровой поток только складывает готовые блоки в очередь */
+class FTDSReplayWriter : public FRunnable
+{
+public:
+    ~FTDSReplayWriter()
+    {
+        if (Thread)
+        {
+            // Kill вызывает Stop и ждёт, пока Run допишет очередь
+            Thread->Kill(true);
+            delete Thread;
+        }
+
+        if (WakeEvent)
+        {
+            FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        }
+
+        if (File)
+        {
+            File->Close();
+        }
+    }
+
+    bool Start(const FString& Path, const FString& MapName)
+    {
+        File.Reset(IFileManager::Get().CreateFileWriter(*Path, FILEWRITE_AllowRead));
+        if (!File)
+        {
+            UE_LOG(LogTemp, Error, TEXT("TDSReplay: failed to open %s"), *Path);
+            return false;
+        }
+
+        TDSReplay::WriteHeader(*File, MapName);
+
+        WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+        Thread = FRunnableThread::Create(this, TEXT("TDSReplayWriter"), 0, TPri_BelowNormal);
+        return Thread != nullptr;
+    }
+
+    void Enqueue(TArray<uint8>&& Chunk)
+    {
+        Queue.Enqueue(MoveTemp(Chunk));
+        WakeEvent->Trigger();
+    }
+
+    virtual uint32 Run() override
+    {
+        while (!bStopping)
+        {
+            WakeEvent->Wait(FTimespan::FromMilliseconds(250));
+            Drain();
+        }
+        Drain();
+        return 0;
+    }
+
+    virtual void Stop() override
+    {
+        bStopping = true;
+        WakeEvent->Trigger();
+    }
+
+private:
+    TUniquePtr<FArchive> File;
+    FRunnableThread* Thread = nullptr;
+    FEvent* WakeEvent = nullptr;
+    TQueue<TArray<uint8>, EQueueMode::Spsc> Queue;
+    std::atomic<bool> bStopping{false};
+
+    void Drain()
+    {
+        bool bWritten = false;
+        TArray<uint8> Chunk;
+        while (Queue.Dequeue(Chunk))
+        {
+            File->Serialize(Chunk.GetData(), Chunk.Num());
+            bWritten = true;
+        }
+
+        // Запись должна переживать падение сервера – сбрасываем на диск каждую порцию
+        if (bWritten)
+        {
+            File->Flush();
+        }
+    }
+};
+
+bool UTDSReplaySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    if (!Super::ShouldCreateSubsystem(Outer))
+    {
+        return false;
+    }
+
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld();
+}
+
+void UTDSReplaySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    // Пишет только авторитетная сторона
+    if (InWorld.GetNetMode() == NM_Client)
+    {
+        return;
+    }
+
+    FString Directory;
+    if (FParse::Value(FCommandLine::Get(), TEXT("TDSReplay="), Directory))
+    {
+        StartRecording(Directory);
+    }
+    else if (TDSReplay::CVarRecord.GetValueOnGameThread())
+    {
+        StartRecording(FPaths::ProjectSavedDir() / TEXT("Replays"));
+    }
+}
+
+void UTDSReplaySubsystem::Deinitialize()
+{
+    StopRecording();
+
+    Super::Deinitialize();
+}
+
+TStatId UTDSReplaySubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UTDSReplaySubsystem, STATGROUP_Tickables);
+}
+
+void UTDSReplaySubsystem::StartRecording(const FString& Directory)
+{
+    const FString MapName = UWorld::RemovePIEPrefix(GetWorld()->GetMapName());
+    IFileManager::Get().MakeDirectory(*Directory, true);
+    RecordingPath = Directory / FString::Printf(TEXT("%s-%s.tdsreplay"), *MapName, *FDateTime::Now().ToString());
+
+    Writer = MakeUnique<FTDSReplayWriter>();
+    if (!Writer->Start(RecordingPath, MapName))
+    {
+        Writer.Reset();
+        return;
+    }
+
+    StartTime = GetWorld()->GetTimeSeconds();
+    SampleInterval = FMath::Max(TDSReplay::CVarSampleInterval.GetValueOnGameThread(), 0.0f);
+    SampleTimer = 0.0f;
+    CheckpointTimer = 0.0f;
+    BudgetCycles = 0;
+    BudgetSeconds = 0.0f;
+
+    UE_LOG(LogTemp, Log, TEXT("TDSReplay: recording to %s"), *RecordingPath);
+
+    // Первая контрольная точка – полное состояние на старте
+    Sample(true);
+}
+
+void UTDSReplaySubsystem::StopRecording()
+{
+    if (!Writer)
+    {
+        return;
+    }
+
+    Writer.Reset();
+    CharacterIds.Reset();
+    FrameState.Reset();
+    CheckpointState.Reset();
+    SampleState.Reset();
+
+    UE_LOG(LogTemp, Log, TEXT("TDSReplay: saved %s (%lld bytes)"), *RecordingPath, IFileManager::Get().FileSize(*RecordingPath));
+}
+
+void UTDSReplaySubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (!Writer)
+    {
+        return;
+    }
+
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+
+    SampleTimer += DeltaTime;
+    CheckpointTimer += DeltaTime;
+    if (SampleTimer >= SampleInterval)
+    {
+        SampleTimer = FMath::Fmod(SampleTimer, FMath::Max(SampleInterval, UE_KINDA_SMALL_NUMBER));
+
+        const bool bCheckpoint = CheckpointTimer >= TDSReplay::CVarCheckpointInterval.GetValueOnGameThread();
+        if (bCheckpoint)
+        {
+            CheckpointTimer = 0.0f;
+        }
+        Sample(bCheckpoint);
+    }
+
+    BudgetCycles += FPlatformTime::Cycles64() - StartCycles;
+    CheckBudget(DeltaTime);
+}
+
+FTDSReplayCharacterState UTDSReplaySubsystem::MakeState(const ATDSCharacter& Character)
+{
+    FTDSReplayCharacterState State;
+
+    const FVector Location = Character.GetActorLocation();
+    State.Location = FIntVector(FMath::RoundToInt(Location.X), FMath::RoundToInt(Location.Y), FMath::RoundToInt(Location.Z));
+    State.AimYaw = FRotator::CompressAxisToShort(Character.GetBaseAimRotation().Yaw);
+    State.StateMask = Character.GetMovementState().ToMask();
+
+    if (const UTDSCharacterMovementComponent* MoveComp = Character.GetTDSMovementComponent())
+    {
+        State.Gait = static_cast<uint8>(MoveComp->GetCurrentGait());
+        State.MovementMode = MoveComp->MovementMode;
+        State.CustomMovementMode = MoveComp->CustomMovementMode;
+    }
+    return State;
+}
+
+void UTDSReplaySubsystem::Sample(bool bCheckpoint)
+{
+    SCOPE_CYCLE_COUNTER(STAT_TDSReplayRecord);
+
+    SampleState.Reset();
+    for (TActorIterator<ATDSCharacter> It(GetWorld()); It; ++It)
+    {
+        uint32& Id = CharacterIds.FindOrAdd(*It);
+        if (Id == 0)
+        {
+            Id = NextCharacterId++;
+        }
+        SampleState.Add(Id, MakeState(**It));
+    }
+
+    const float Time = static_cast<float>(GetWorld()->GetTimeSeconds() - StartTime);
+
+    // Неизменившийся мир не пишется вовсе
+    TArray<uint8> Payload;
+    FMemoryWriter PayloadWriter(Payload);
+    if (TDSReplay::WriteDelta(PayloadWriter, FrameState, SampleState))
+    {
+        TArray<uint8> Chunk;
+        FMemoryWriter ChunkWriter(Chunk);
+        TDSReplay::WriteChunk(ChunkWriter, TDSReplay::EChunk::Frame, Time, Payload);
+        Writer->Enqueue(MoveTemp(Chunk));
+    }
+
+    if (bCheckpoint)
+    {
+        Payload.Reset();
+        FMemoryWriter CheckpointWriter(Payload);
+        TDSReplay::WriteDelta(CheckpointWriter, CheckpointState, SampleState);
+
+        // Пустая контрольная точка тоже пишется: перемотка опирается на их регулярность
+        TArray<uint8> Chunk;
+        FMemoryWriter ChunkWriter(Chunk);
+        TDSReplay::WriteChunk(ChunkWriter, TDSReplay::EChunk::Checkpoint, Time, Payload);
+        Writer->Enqueue(MoveTemp(Chunk));
+
+        CheckpointState = SampleState;
+
+        // Заодно забываем удалённых персонажей
+        for (auto It = CharacterIds.CreateIterator(); It; ++It)
+        {
+            if (!It.Key().ResolveObjectPtr())
+            {
+                It.RemoveCurrent();
+            }
+        }
+    }
+
+    Swap(FrameState, SampleState);
+}
+
+void UTDSReplaySubsystem::CheckBudget(float DeltaTime)
+{
+    BudgetSeconds += DeltaTime;
+    if (BudgetSeconds < TDSReplay::BudgetWindowSeconds)
+    {
+        return;
+    }
+
+    const double Fraction = FPlatformTime::ToSeconds64(BudgetCycles) / BudgetSeconds;
+    SET_FLOAT_STAT(STAT_TDSReplayFrameFraction, static_cast<float>(Fraction));
+
+    if (Fraction > TDSReplay::CVarMaxFrameFraction.GetValueOnGameThread() && SampleInterval < TDSReplay::MaxSampleInterval)
+    {
+        SampleInterval = FMath::Min(FMath::Max(SampleInterval * 2.0f, 0.05f), TDSReplay::MaxSampleInterval);
+        UE_LOG(LogTemp, Warning, TEXT("TDSReplay: recording took %.2f%% of frame time, sample interval raised to %.2f s"),
+            Fraction * 100.0, SampleInterval);
+    }
+
+    BudgetCycles = 0;
+    BudgetSeconds = 0.0f;
+}
@@ -0,0 +1,71 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "TDSReplayFormat.h"
+#include "TDSReplaySubsystem.generated.h"
+
+class ATDSCharacter;
+class FTDSReplayWriter;
+
+/**
+ * Запись матча в компактном формате TDS (TDSReplayFormat.h) для разбора.
+ * Включается на сервере ключом командной строки или консольной переменной:
+ *   TopDownShooterServer MapName -TDSReplay=<папка>
+ *   TDS.Replay.Record 1            (папка Saved/Replays)
+ *
+ * Игровой поток раз в TDS.Replay.SampleInterval снимает состояние персонажей и кодирует изменения,
+ * запись на диск идёт в фоновом потоке FTDSReplayWriter. Затраты игрового потока сверяются с временем кадра:
+ * если запись дороже TDS.Replay.MaxFrameFraction, интервал снимков увеличивается.
+ */
+UCLASS()
+class TOPDOWNSHOOTER_API UTDSReplaySubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    bool IsRecording() const { return Writer.IsValid(); }
+
+    const FString& GetRecordingPath() const { return RecordingPath; }
+
+private:
+    TUniquePtr<FTDSReplayWriter> Writer;
+    FString RecordingPath;
+
+    /** Идентификаторы персонажей в записи; не переиспользуются */
+    TMap<TObjectKey<ATDSCharacter>, uint32> CharacterIds;
+    uint32 NextCharacterId = 1;
+
+    /** Состояние последнего кадра, последней контрольной точки и текущего снимка */
+    FTDSReplayState FrameState;
+    FTDSReplayState CheckpointState;
+    FTDSReplayState SampleState;
+
+    double StartTime = 0.0;
+    float SampleInterval = 0.0f;
+    float SampleTimer = 0.0f;
+    float CheckpointTimer = 0.0f;
+
+    /** Окно сверки затрат с временем кадра */
+    uint64 BudgetCycles = 0;
+    float BudgetSeconds = 0.0f;
+
+    void StartRecording(const FString& Directory);
+    void StopRecording();
+
+    /** Снять состояние персонажей и отдать кадр (и при необходимости контрольную точку) писателю */
+    void Sample(bool bCheckpoint);
+
+    void CheckBudget(float DeltaTime);
+
+    static FTDSReplayCharacterState MakeState(const ATDSCharacter& Character);
+};
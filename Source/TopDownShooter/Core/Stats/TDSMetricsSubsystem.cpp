@@ -0,0 +1,366 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSMetricsSubsystem.h"
+#include "TDSCharacterMovementComponent.h"
+#include "TDSStats.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Engine/GameInstance.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Common/TcpSocketBuilder.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+
+namespace TDSMetrics
+{
+    enum EModeSlot : int32
+    {
+        Mode_Walking,
+        Mode_Falling,
+        Mode_Flying,
+        Mode_Swimming,
+        Mode_WallRunning,
+        Mode_Sliding,
+        Mode_Prone,
+        Mode_Other,
+    };
+    static_assert(Mode_Other < FTDSPerfCounters::NumModeSlots, "FTDSPerfCounters::NumModeSlots is too small");
+
+    static int32 GetModeSlot(const UCharacterMovementComponent& MoveComp)
+    {
+        switch (MoveComp.MovementMode)
+        {
+        case MOVE_Walking:
+        case MOVE_NavWalking: return Mode_Walking;
+        case MOVE_Falling:    return Mode_Falling;
+        case MOVE_Flying:     return Mode_Flying;
+        case MOVE_Swimming:   return Mode_Swimming;
+        case MOVE_Custom:
+            switch (static_cast<ETDSCustomMovementMode>(MoveComp.CustomMovementMode))
+            {
+            case ETDSCustomMovementMode::CMOVE_WallRunning: return Mode_WallRunning;
+            case ETDSCustomMovementMode::CMOVE_Sliding:     return Mode_Sliding;
+            case ETDSCustomMovementMode::CMOVE_Prone:       return Mode_Prone;
+            default:                                        return Mode_Other;
+            }
+        default:
+            return Mode_Other;
+        }
+    }
+
+    /** Время ожидания входящего соединения – определяет, как быстро поток замечает остановку */
+    static const FTimespan AcceptWait = FTimespan::FromMilliseconds(250);
+
+    /** Сколько ждать строку запроса от клиента */
+    static const FTimespan RequestWait = FTimespan::FromMilliseconds(500);
+}
+
+/** Фоновый поток: принимает соединения и отдаёт снимок FTDSPerfCounters */
+class FTDSMetricsServer : public FRunnable
+{
+public:
+    ~FTDSMetricsServer()
+    {
+        if (Thread)
+        {
+            Thread->Kill(true);
+            delete Thread;
+        }
+
+        if (Listener)
+        {
+            Listener->Close();
+            ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Listener);
+        }
+    }
+
+    bool Start(const FIPv4Endpoint& Endpoint)
+    {
+        Listener = FTcpSocketBuilder(TEXT("TDSMetrics"))
+            .AsReusable()
+            .BoundToEndpoint(Endpoint)
+            .Listening(8);
+
+        if (!Listener)
+        {
+            UE_LOG(LogTemp, Error, TEXT("TDSMetrics: не удалось открыть %s"), *Endpoint.ToString());
+            return false;
+        }
+
+        Thread = FRunnableThread::Create(this, TEXT("TDSMetricsServer"), 0, TPri_BelowNormal);
+        UE_LOG(LogTemp, Log, TEXT("TDSMetrics: слушаю http://%s/metrics"), *Endpoint.ToString());
+        return Thread != nullptr;
+    }
+
+    virtual uint32 Run() override
+    {
+        while (!bStopping)
+        {
+            bool bPending = false;
+            if (!Listener->WaitForPendingConnection(bPending, TDSMetrics::AcceptWait) || !bPending)
+            {
+                continue;
+            }
+
+            if (FSocket* Client = Listener->Accept(TEXT("TDSMetricsClient")))
+            {
+                Serve(*Client);
+                Client->Close();
+                ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Client);
+            }
+        }
+        return 0;
+    }
+
+    virtual void Stop() override
+    {
+        bStopping = true;
+    }
+
+private:
+    FSocket* Listener = nullptr;
+    FRunnableThread* Thread = nullptr;
+    std::atomic<bool> bStopping{false};
+
+    void Serve(FSocket& Client)
+    {
+        // Путь запроса не важен – любой GET получает метрики
+        if (Client.Wait(ESocketWaitConditions::WaitForRead, TDSMetrics::RequestWait))
+        {
+            uint8 Request[1024];
+            int32 BytesRead = 0;
+            Client.Recv(Request, sizeof(Request), BytesRead);
+        }
+
+        const FTCHARToUTF8 Body(*BuildBody());
+        const FTCHARToUTF8 Header(*FString::Printf(
+            TEXT("HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %d\r\nConnection: close\r\n\r\n"),
+            Body.Length()));
+
+        SendAll(Client, reinterpret_cast<const uint8*>(Header.Get()), Header.Length());
+        SendAll(Client, reinterpret_cast<const uint8*>(Body.Get()), Body.Length());
+    }
+
+    static void SendAll(FSocket& Client, const uint8* Data, int32 Size)
+    {
+        while (Size > 0)
+        {
+            int32 BytesSent = 0;
+            if (!Client.Send(Data, Size, BytesSent) || BytesSent <= 0)
+            {
+                return;
+            }
+            Data += BytesSent;
+            Size -= BytesSent;
+        }
+    }
+
+    static FString BuildBody()
+    {
+        const FTDSPerfCounters& Counters = FTDSPerfCounters::Get();
+        constexpr std::memory_order Relaxed = std::memory_order_relaxed;
+
+        FString Body;
+        Body.Reserve(4096);
+
+        Body += TEXT("# TYPE tds_frame_work_ms histogram\n");
+        uint64 Cumulative = 0;
+        for (int32 Bucket = 0; Bucket < FTDSPerfCounters::NumFrameBuckets; ++Bucket)
+        {
+            Cumulative += Counters.FrameBuckets[Bucket].load(Relaxed);
+            const FString Bound = Bucket < FTDSPerfCounters::NumFrameBuckets - 1
+                ? FString::SanitizeFloat(FTDSPerfCounters::FrameBucketMs[Bucket])
+                : FString(TEXT("+Inf"));
+            Body += FString::Printf(TEXT("tds_frame_work_ms_bucket{le=\"%s\"} %llu\n"), *Bound, Cumulative);
+        }
+        Body += FString::Printf(TEXT("tds_frame_work_ms_sum %.3f\n"), Counters.FrameWorkMicros.load(Relaxed) / 1000.0);
+        Body += FString::Printf(TEXT("tds_frame_work_ms_count %llu\n"), Cumulative);
+
+        Body += TEXT("# TYPE tds_players gauge\n");
+        Body += FString::Printf(TEXT("tds_players %u\n"), Counters.Players.load(Relaxed));
+
+        Body += TEXT("# TYPE tds_connection_in_bytes_total counter\n");
+        Body += TEXT("# TYPE tds_connection_out_bytes_total counter\n");
+        for (const FTDSPerfCounters::FConnectionSlot& Slot : Counters.Connections)
+        {
+            const int32 PlayerId = Slot.PlayerId.load(Relaxed);
+            if (PlayerId != INDEX_NONE)
+            {
+                Body += FString::Printf(TEXT("tds_connection_in_bytes_total{player=\"%d\"} %llu\n"), PlayerId, Slot.InBytes.load(Relaxed));
+                Body += FString::Printf(TEXT("tds_connection_out_bytes_total{player=\"%d\"} %llu\n"), PlayerId, Slot.OutBytes.load(Relaxed));
+            }
+        }
+
+        Body += TEXT("# TYPE tds_movement_mode_characters gauge\n");
+        for (int32 Slot = 0; Slot <= TDSMetrics::Mode_Other; ++Slot)
+        {
+            Body += FString::Printf(TEXT("tds_movement_mode_characters{mode=\"%s\"} %u\n"),
+                UTDSMetricsSubsystem::GetModeName(Slot), Counters.ModePopulation[Slot].load(Relaxed));
+        }
+
+        Body += TEXT("# TYPE tds_server_moves_total counter\n");
+        Body += FString::Printf(TEXT("tds_server_moves_total %llu\n"), Counters.ServerMoves.load(Relaxed));
+        Body += TEXT("# TYPE tds_server_move_rpcs_total counter\n");
+        Body += FString::Printf(TEXT("tds_server_move_rpcs_total %llu\n"), Counters.ServerMoveRpcs.load(Relaxed));
+        Body += TEXT("# TYPE tds_corrections_total counter\n");
+        Body += FString::Printf(TEXT("tds_corrections_total %llu\n"), Counters.Corrections.load(Relaxed));
+        Body += TEXT("# TYPE tds_move_violations_total counter\n");
+        Body += FString::Printf(TEXT("tds_move_violations_total %llu\n"), Counters.MoveViolations.load(Relaxed));
+        Body += TEXT("# TYPE tds_traces_total counter\n");
+        Body += FString::Printf(TEXT("tds_traces_total %llu\n"), Counters.Traces.load(Relaxed));
+        Body += TEXT("# TYPE tds_movement_ticks_total counter\n");
+        Body += FString::Printf(TEXT("tds_movement_ticks_total %llu\n"), Counters.MovementTicks.load(Relaxed));
+        Body += TEXT("# TYPE tds_movement_seconds_total counter\n");
+        Body += FString::Printf(TEXT("tds_movement_seconds_total %.6f\n"),
+            FPlatformTime::ToSeconds64(Counters.MovementCycles.load(Relaxed)));
+        Body += TEXT("# TYPE tds_join_to_control_seconds summary\n");
+        Body += FString::Printf(TEXT("tds_join_to_control_seconds_sum %.3f\n"), Counters.JoinToControlMicros.load(Relaxed) / 1000000.0);
+        Body += FString::Printf(TEXT("tds_join_to_control_seconds_count %llu\n"), Counters.Joins.load(Relaxed));
+        Body += TEXT("# TYPE tds_lockstep_desyncs_total counter\n");
+        Body += FString::Printf(TEXT("tds_lockstep_desyncs_total %llu\n"), Counters.LockstepDesyncs.load(Relaxed));
+
+        return Body;
+    }
+};
+
+bool UTDSMetricsSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    int32 Port = 0;
+    return Super::ShouldCreateSubsystem(Outer) && FParse::Value(FCommandLine::Get(), TEXT("TDSMetricsPort="), Port) && Port > 0;
+}
+
+void UTDSMetricsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    int32 Port = 0;
+    FParse::Value(FCommandLine::Get(), TEXT("TDSMetricsPort="), Port);
+
+    FString AddressString = TEXT("127.0.0.1");
+    FParse::Value(FCommandLine::Get(), TEXT("TDSMetricsAddress="), AddressString);
+
+    FIPv4Address Address;
+    if (!FIPv4Address::Parse(AddressString, Address))
+    {
+        UE_LOG(LogTemp, Error, TEXT("TDSMetrics: некорректный адрес %s"), *AddressString);
+        return;
+    }
+
+    Server = MakeUnique<FTDSMetricsServer>();
+    if (!Server->Start(FIPv4Endpoint(Address, static_cast<uint16>(Port))))
+    {
+        Server.Reset();
+    }
+}
+
+void UTDSMetricsSubsystem::Deinitialize()
+{
+    // Деструктор останавливает поток и дожидается его
+    Server.Reset();
+
+    Super::Deinitialize();
+}
+
+ETickableTickType UTDSMetricsSubsystem::GetTickableTickType() const
+{
+    return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UTDSMetricsSubsystem::IsTickable() const
+{
+    return Server.IsValid();
+}
+
+TStatId UTDSMetricsSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UTDSMetricsSubsystem, STATGROUP_Tickables);
+}
+
+const TCHAR* UTDSMetricsSubsystem::GetModeName(int32 Slot)
+{
+    switch (Slot)
+    {
+    case TDSMetrics::Mode_Walking:     return TEXT("walking");
+    case TDSMetrics::Mode_Falling:     return TEXT("falling");
+    case TDSMetrics::Mode_Flying:      return TEXT("flying");
+    case TDSMetrics::Mode_Swimming:    return TEXT("swimming");
+    case TDSMetrics::Mode_WallRunning: return TEXT("wall_running");
+    case TDSMetrics::Mode_Sliding:     return TEXT("sliding");
+    case TDSMetrics::Mode_Prone:       return TEXT("prone");
+    default:                           return TEXT("other");
+    }
+}
+
+void UTDSMetricsSubsystem::Tick(float DeltaTime)
+{
+    // Работа кадра без сна до NetServerMaxTickRate
+    FTDSPerfCounters::Get().AddFrame(static_cast<float>(FMath::Max(FApp::GetDeltaTime() - FApp::GetIdleTime(), 0.0) * 1000.0));
+
+    SampleTimer -= DeltaTime;
+    if (SampleTimer <= 0.0f)
+    {
+        SampleTimer = 1.0f;
+        SampleWorld();
+    }
+}
+
+void UTDSMetricsSubsystem::SampleWorld()
+{
+    FTDSPerfCounters& Counters = FTDSPerfCounters::Get();
+    constexpr std::memory_order Relaxed = std::memory_order_relaxed;
+
+    const UWorld* World = GetGameInstance()->GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    uint32 ModePopulation[FTDSPerfCounters::NumModeSlots] = {};
+    for (TActorIterator<ACharacter> It(World); It; ++It)
+    {
+        if (const UCharacterMovementComponent* MoveComp = It->GetCharacterMovement())
+        {
+            ++ModePopulation[TDSMetrics::GetModeSlot(*MoveComp)];
+        }
+    }
+    for (int32 Slot = 0; Slot < FTDSPerfCounters::NumModeSlots; ++Slot)
+    {
+        Counters.ModePopulation[Slot].store(ModePopulation[Slot], Relaxed);
+    }
+
+    int32 NumSlots = 0;
+    const UNetDriver* NetDriver = World->GetNetDriver();
+    if (NetDriver)
+    {
+        for (const UNetConnection* Connection : NetDriver->ClientConnections)
+        {
+            if (!Connection || NumSlots >= FTDSPerfCounters::MaxConnectionSlots)
+            {
+                continue;
+            }
+
+            const APlayerState* PlayerState = Connection->PlayerController ? Connection->PlayerController->PlayerState : nullptr;
+            FTDSPerfCounters::FConnectionSlot& Slot = Counters.Connections[NumSlots++];
+            Slot.InBytes.store(static_cast<uint64>(Connection->InTotalBytes), Relaxed);
+            Slot.OutBytes.store(static_cast<uint64>(Connection->OutTotalBytes), Relaxed);
+            Slot.PlayerId.store(PlayerState ? PlayerState->GetPlayerId() : NumSlots - 1, Relaxed);
+        }
+    }
+
+    const AGameStateBase* GameState = World->GetGameState();
+    Counters.Players.store(GameState ? static_cast<uint32>(GameState->PlayerArray.Num()) : 0, Relaxed);
+    for (int32 Index = NumSlots; Index < FTDSPerfCounters::MaxConnectionSlots; ++Index)
+    {
+        Counters.Connections[Index].PlayerId.store(INDEX_NONE, Relaxed);
+    }
+}
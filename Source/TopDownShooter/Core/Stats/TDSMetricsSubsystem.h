@@ -0,0 +1,50 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "TDSMetricsSubsystem.generated.h"
+
+class FTDSMetricsServer;
+
+/**
+ * Эндпоинт метрик сервера в текстовом формате Prometheus.
+ * Включается ключом командной строки, например:
+ *   TopDownShooterServer MapName -TDSMetricsPort=9464
+ *
+ * Игровой поток только пишет в FTDSPerfCounters (relaxed atomics): время работы кадра каждый тик,
+ * игроков, трафик соединений и население режимов движения – раз в секунду. HTTP-ответы формирует
+ * фоновый поток FTDSMetricsServer, читая те же атомики, так что сбор метрик не блокирует кадр.
+ *
+ * Необязательные ключи:
+ *   -TDSMetricsAddress=0.0.0.0   адрес прослушивания (по умолчанию 127.0.0.1)
+ */
+UCLASS()
+class TOPDOWNSHOOTER_API UTDSMetricsSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+    virtual ETickableTickType GetTickableTickType() const override;
+    virtual bool IsTickable() const override;
+    virtual TStatId GetStatId() const override;
+
+    /** Метка режима движения для слота FTDSPerfCounters::ModePopulation */
+    static const TCHAR* GetModeName(int32 Slot);
+
+private:
+    TUniquePtr<FTDSMetricsServer> Server;
+
+    /** Таймер снимка мира (игроки, соединения, режимы движения) */
+    float SampleTimer = 0.0f;
+
+    /** Снять раз в секунду то, что требует обхода мира */
+    void SampleWorld();
+};
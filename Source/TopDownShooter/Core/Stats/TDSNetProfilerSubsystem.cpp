@@ -0,0 +1,566 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSNetProfilerSubsystem.h"
+#include "TDSCharacter.h"
+#include "TDSCharacterMovementComponent.h"
+#include "TDSPlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Engine/ActorChannel.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Net/UnrealNetwork.h"
+#include "UObject/CoreNet.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DECLARE_STATS_GROUP(TEXT("TDSNet"), STATGROUP_TDSNet, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("TDS Net Profiler"), STAT_TDSNetProfiler, STATGROUP_TDS);
+
+namespace TDSNetProfiler
+{
+    static TAutoConsoleVariable<bool> CVarEnabled(
+        TEXT("TDS.NetProfiler.Enabled"), false,
+        TEXT("Считать биты репликации свойств и RPC классов TDS по соединениям."));
+
+    static TAutoConsoleVariable<float> CVarIntervalSeconds(
+        TEXT("TDS.NetProfiler.IntervalSeconds"), 1.0f,
+        TEXT("Период записи строк в CSV и обновления stat TDSNet, сек."));
+
+    static FAutoConsoleCommandWithWorldAndArgs ReportCommand(
+        TEXT("TDS.NetProfiler.Report"),
+        TEXT("Вывести самых дорогих членов по трафику. Аргумент – число строк (по умолчанию 20)."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (const UTDSNetProfilerSubsystem* Profiler = World ? World->GetSubsystem<UTDSNetProfilerSubsystem>() : nullptr)
+            {
+                Profiler->Report(Args.IsEmpty() ? 20 : FCString::Atoi(*Args[0]));
+            }
+        }));
+
+    /** Оценка заголовка RPC (индекс функции и длина полезной нагрузки), бит */
+    static constexpr int32 RPCHeaderBits = 16;
+
+    /** Оценка ссылки на объект (NetGUID), бит */
+    static constexpr int32 ObjectReferenceBits = 32;
+
+    /** Соединение с сервером на клиенте */
+    static constexpr int32 ServerConnectionId = -2;
+
+    static bool IsProfiledObject(const UObject* Object)
+    {
+        return Object && (Object->IsA<ATDSCharacter>() || Object->IsA<UTDSCharacterMovementComponent>() || Object->IsA<ATDSPlayerController>());
+    }
+}
+
+UTDSNetProfilerSubsystem::FShadow::~FShadow()
+{
+    if (!Layout)
+    {
+        return;
+    }
+
+    for (const FTrackedProperty& Tracked : Layout->Properties)
+    {
+        Tracked.Property->DestroyValue(Data.GetData() + Tracked.ShadowOffset);
+    }
+}
+
+bool UTDSNetProfilerSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    if (!Super::ShouldCreateSubsystem(Outer))
+    {
+        return false;
+    }
+
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld();
+}
+
+void UTDSNetProfilerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    // После отправки всех пакетов кадра: видно, какие акторы реплицировались
+    PostTickFlushHandle = GetWorld()->OnPostTickFlush().AddUObject(this, &UTDSNetProfilerSubsystem::OnPostTickFlush);
+}
+
+void UTDSNetProfilerSubsystem::Deinitialize()
+{
+    if (!Counters.IsEmpty())
+    {
+        FlushInterval();
+    }
+
+    GetWorld()->OnPostTickFlush().Remove(PostTickFlushHandle);
+    UnbindNetDriver();
+    Shadows.Reset();
+    MeasureShadows.Reset();
+    Layouts.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UTDSNetProfilerSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UTDSNetProfilerSubsystem, STATGROUP_Tickables);
+}
+
+bool UTDSNetProfilerSubsystem::IsProfiling() const
+{
+    return TDSNetProfiler::CVarEnabled.GetValueOnGameThread() && GetWorld()->GetNetDriver() != nullptr;
+}
+
+void UTDSNetProfilerSubsystem::BindNetDriver()
+{
+    UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+    if (!NetDriver || BoundNetDriver == NetDriver)
+    {
+        return;
+    }
+
+    UnbindNetDriver();
+
+    // Делегат одиночный – не перехватываем его у другого подписчика (например, записи реплея)
+    if (NetDriver->SendRPCDel.IsBound())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("TDS.NetProfiler: SendRPCDel is already bound, RPCs are not profiled"));
+        return;
+    }
+
+    NetDriver->SendRPCDel.BindUObject(this, &UTDSNetProfilerSubsystem::OnSendRPC);
+    BoundNetDriver = NetDriver;
+}
+
+void UTDSNetProfilerSubsystem::UnbindNetDriver()
+{
+    if (UNetDriver* NetDriver = BoundNetDriver.Get())
+    {
+        NetDriver->SendRPCDel.Unbind();
+    }
+    BoundNetDriver.Reset();
+}
+
+void UTDSNetProfilerSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (!IsProfiling())
+    {
+        if (BoundNetDriver.IsValid())
+        {
+            FlushInterval();
+            UnbindNetDriver();
+            Shadows.Reset();
+        }
+        return;
+    }
+
+    BindNetDriver();
+
+    IntervalTimer += DeltaTime;
+    if (IntervalTimer >= TDSNetProfiler::CVarIntervalSeconds.GetValueOnGameThread())
+    {
+        FlushInterval();
+        IntervalTimer = 0.0f;
+    }
+}
+
+void UTDSNetProfilerSubsystem::OnPostTickFlush()
+{
+    UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+    if (!IsProfiling() || !NetDriver->IsServer())
+    {
+        return;
+    }
+
+    SCOPE_CYCLE_COUNTER(STAT_TDSNetProfiler);
+
+    const double Now = GetWorld()->GetTimeSeconds();
+    auto WasReplicated = [NetDriver, Now](const AActor& Actor)
+    {
+        const FNetworkObjectInfo* Info = NetDriver->FindNetworkObjectInfo(&Actor);
+        return Info && Info->LastNetReplicateTime == Now;
+    };
+
+    for (TActorIterator<ATDSCharacter> It(GetWorld()); It; ++It)
+    {
+        if (WasReplicated(**It))
+        {
+            ProfileProperties(**It, **It, *NetDriver);
+            if (UTDSCharacterMovementComponent* MoveComp = It->GetTDSMovementComponent())
+            {
+                ProfileProperties(*MoveComp, **It, *NetDriver);
+            }
+        }
+    }
+
+    for (TActorIterator<ATDSPlayerController> It(GetWorld()); It; ++It)
+    {
+        if (WasReplicated(**It))
+        {
+            ProfileProperties(**It, **It, *NetDriver);
+        }
+    }
+
+    // Уничтоженные объекты больше не реплицируются
+    for (auto It = Shadows.CreateIterator(); It; ++It)
+    {
+        if (!It.Key().ResolveObjectPtr())
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
+
+const UTDSNetProfilerSubsystem::FClassLayout& UTDSNetProfilerSubsystem::GetLayout(UClass* Class)
+{
+    TUniquePtr<FClassLayout>& Layout = Layouts.FindOrAdd(Class);
+    if (Layout)
+    {
+        return *Layout;
+    }
+
+    Layout = MakeUnique<FClassLayout>();
+    Class->SetUpRuntimeReplicationData();
+
+    TArray<FLifetimeProperty> LifetimeProps;
+    Class->GetDefaultObject()->GetLifetimeReplicatedProps(LifetimeProps);
+
+    for (const FLifetimeProperty& LifetimeProp : LifetimeProps)
+    {
+        const FRepRecord& Record = Class->ClassReps[LifetimeProp.RepIndex];
+
+        // Статический массив – одна запись на элемент; теневая копия хранит его целиком
+        if (Record.Index != 0 || LifetimeProp.Condition == COND_Never || LifetimeProp.Condition == COND_InitialOnly)
+        {
+            continue;
+        }
+
+        FTrackedProperty& Tracked = Layout->Properties.AddDefaulted_GetRef();
+        Tracked.Property = Record.Property;
+        Tracked.Condition = LifetimeProp.Condition;
+        Tracked.ShadowOffset = Align(Layout->ShadowSize, Record.Property->GetMinAlignment());
+
+        TArray<const FStructProperty*> EncounteredStructs;
+        Tracked.bHasObjectReferences = Record.Property->ContainsObjectReference(EncounteredStructs, EPropertyObjectReferenceType::Strong | EPropertyObjectReferenceType::Weak) ||
+            Record.Property->IsA<FArrayProperty>();
+
+        Layout->ShadowSize = Tracked.ShadowOffset + Record.Property->GetSize();
+    }
+
+    Layout->HandleBits = FMath::CeilLogTwo(Class->ClassReps.Num() + 1);
+    return *Layout;
+}
+
+int32 UTDSNetProfilerSubsystem::MeasureBits(const FProperty& Property, const void* Value, bool bHasObjectReferences)
+{
+    if (bHasObjectReferences)
+    {
+        // Без PackageMap ссылку не сериализовать: ссылка – NetGUID, остальное – по размеру в памяти
+        return Property.IsA<FObjectPropertyBase>() ? TDSNetProfiler::ObjectReferenceBits : Property.GetElementSize() * 8;
+    }
+
+    // Для структуры без STRUCT_NetSerializeNative NetSerializeItem не предназначен и падает с фатальной ошибкой
+    if (const FStructProperty* StructProperty = CastField<FStructProperty>(&Property))
+    {
+        if (!(StructProperty->Struct->StructFlags & STRUCT_NetSerializeNative))
+        {
+            return MeasureStructBits(*StructProperty->Struct, Value);
+        }
+    }
+
+    FNetBitWriter Writer(nullptr, 0);
+    const_cast<FProperty&>(Property).NetSerializeItem(Writer, nullptr, const_cast<void*>(Value));
+    return static_cast<int32>(Writer.GetNumBits());
+}
+
+int32 UTDSNetProfilerSubsystem::MeasureStructBits(const UScriptStruct& Struct, const void* Value)
+{
+    int32 Bits = 0;
+    for (TFieldIterator<FProperty> It(&Struct); It; ++It)
+    {
+        const FProperty& Inner = **It;
+        if (Inner.HasAnyPropertyFlags(CPF_RepSkip))
+        {
+            continue;
+        }
+
+        TArray<const FStructProperty*> EncounteredStructs;
+        const bool bInnerObjectReferences = Inner.ContainsObjectReference(EncounteredStructs, EPropertyObjectReferenceType::Strong | EPropertyObjectReferenceType::Weak) ||
+            Inner.IsA<FArrayProperty>();
+
+        for (int32 Index = 0; Index < Inner.ArrayDim; ++Index)
+        {
+            Bits += MeasureBits(Inner, Inner.ContainerPtrToValuePtr<void>(Value, Index), bInnerObjectReferences);
+        }
+    }
+    return Bits;
+}
+
+int32 UTDSNetProfilerSubsystem::GetConnectionId(const UNetConnection* Connection)
+{
+    if (!Connection)
+    {
+        return INDEX_NONE;
+    }
+
+    if (Connection == Connection->Driver->ServerConnection)
+    {
+        ConnectionLabels.FindOrAdd(TDSNetProfiler::ServerConnectionId, TEXT("server"));
+        return TDSNetProfiler::ServerConnectionId;
+    }
+
+    const APlayerState* PlayerState = Connection->PlayerController ? Connection->PlayerController->PlayerState : nullptr;
+    const int32 Id = PlayerState ? PlayerState->GetPlayerId() : Connection->GetConnectionId();
+    ConnectionLabels.FindOrAdd(Id, FString::Printf(TEXT("%s%d"), PlayerState ? TEXT("player") : TEXT("conn"), Id));
+    return Id;
+}
+
+TUniquePtr<UTDSNetProfilerSubsystem::FShadow> UTDSNetProfilerSubsystem::MakeShadow(const UObject& Object, const FClassLayout& Layout)
+{
+    TUniquePtr<FShadow> Shadow = MakeUnique<FShadow>();
+    Shadow->Data.SetNumZeroed(Layout.ShadowSize);
+    for (const FTrackedProperty& Tracked : Layout.Properties)
+    {
+        Tracked.Property->InitializeValue(Shadow->Data.GetData() + Tracked.ShadowOffset);
+        Tracked.Property->CopyCompleteValue(Shadow->Data.GetData() + Tracked.ShadowOffset, Tracked.Property->ContainerPtrToValuePtr<void>(&Object));
+    }
+    Shadow->Layout = &Layout;
+    return Shadow;
+}
+
+int32 UTDSNetProfilerSubsystem::DiffProperty(const UObject& Object, const FTrackedProperty& Tracked, const FClassLayout& Layout, FShadow& Shadow)
+{
+    const FProperty* Property = Tracked.Property;
+    uint8* ShadowValue = Shadow.Data.GetData() + Tracked.ShadowOffset;
+    const uint8* Value = Property->ContainerPtrToValuePtr<uint8>(&Object);
+
+    int32 Bits = 0;
+    for (int32 Element = 0; Element < Property->ArrayDim; ++Element)
+    {
+        const int32 Offset = Element * Property->GetElementSize();
+        if (!Property->Identical(ShadowValue + Offset, Value + Offset))
+        {
+            Bits += Layout.HandleBits + MeasureBits(*Property, Value + Offset, Tracked.bHasObjectReferences);
+        }
+    }
+
+    if (Bits > 0)
+    {
+        Property->CopyCompleteValue(ShadowValue, Value);
+    }
+    return Bits;
+}
+
+int64 UTDSNetProfilerSubsystem::MeasureChangedBits(UObject& Object, FName SkipProperty)
+{
+    const FClassLayout& Layout = GetLayout(Object.GetClass());
+
+    TUniquePtr<FShadow>& Shadow = MeasureShadows.FindOrAdd(&Object);
+    if (!Shadow)
+    {
+        Shadow = MakeShadow(Object, Layout);
+        return 0;
+    }
+
+    int64 Bits = 0;
+    for (const FTrackedProperty& Tracked : Layout.Properties)
+    {
+        // Наблюдатель – не владелец: свойства только для владельца ему не идут
+        const bool bOwnerOnly = Tracked.Condition == COND_OwnerOnly || Tracked.Condition == COND_AutonomousOnly
+            || Tracked.Condition == COND_ReplayOrOwner;
+        if (!bOwnerOnly && Tracked.Property->GetFName() != SkipProperty)
+        {
+            Bits += DiffProperty(Object, Tracked, Layout, *Shadow);
+        }
+    }
+    return Bits;
+}
+
+void UTDSNetProfilerSubsystem::ProfileProperties(UObject& Object, const AActor& Actor, UNetDriver& NetDriver)
+{
+    const FClassLayout& Layout = GetLayout(Object.GetClass());
+
+    TUniquePtr<FShadow>& Shadow = Shadows.FindOrAdd(&Object);
+    if (!Shadow)
+    {
+        // Первая встреча – только запоминаем значения, начальный bunch не считаем
+        Shadow = MakeShadow(Object, Layout);
+        return;
+    }
+
+    const UNetConnection* OwnerConnection = Actor.GetNetConnection();
+    const FName ClassName = Object.GetClass()->GetFName();
+
+    for (const FTrackedProperty& Tracked : Layout.Properties)
+    {
+        const FProperty* Property = Tracked.Property;
+        const int32 Bits = DiffProperty(Object, Tracked, Layout, *Shadow);
+        if (Bits == 0)
+        {
+            continue;
+        }
+
+        for (const UNetConnection* Connection : NetDriver.ClientConnections)
+        {
+            if (!Connection || !Connection->FindActorChannelRef(const_cast<AActor*>(&Actor)))
+            {
+                continue;
+            }
+
+            const bool bOwner = Connection == OwnerConnection;
+            switch (Tracked.Condition)
+            {
+            case COND_OwnerOnly:
+            case COND_AutonomousOnly:
+            case COND_ReplayOrOwner:
+                if (!bOwner) { continue; }
+                break;
+            case COND_SkipOwner:
+            case COND_SimulatedOnly:
+            case COND_SimulatedOrPhysics:
+            case COND_SkipReplay:
+                if (bOwner) { continue; }
+                break;
+            default:
+                break;
+            }
+
+            Count(GetConnectionId(Connection), ClassName, Property->GetFName(), false, Bits);
+        }
+    }
+}
+
+void UTDSNetProfilerSubsystem::OnSendRPC(AActor* Actor, UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack, UObject* SubObject, bool& bBlockSendRPC)
+{
+    UObject* Object = SubObject ? SubObject : Actor;
+    if (!Actor || !Function || !TDSNetProfiler::IsProfiledObject(Object))
+    {
+        return;
+    }
+
+    int32 Bits = TDSNetProfiler::RPCHeaderBits;
+    for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+    {
+        if (It->HasAnyPropertyFlags(CPF_ReturnParm))
+        {
+            continue;
+        }
+
+        TArray<const FStructProperty*> EncounteredStructs;
+        const bool bHasObjectReferences = It->ContainsObjectReference(EncounteredStructs, EPropertyObjectReferenceType::Strong | EPropertyObjectReferenceType::Weak) ||
+            It->IsA<FArrayProperty>();
+        Bits += MeasureBits(**It, It->ContainerPtrToValuePtr<void>(Parameters), bHasObjectReferences);
+    }
+
+    const FName ClassName = Object->GetClass()->GetFName();
+    const FName FunctionName = Function->GetFName();
+
+    if (Function->HasAnyFunctionFlags(FUNC_NetMulticast))
+    {
+        const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+        for (const UNetConnection* Connection : NetDriver->ClientConnections)
+        {
+            if (Connection && Connection->FindActorChannelRef(Actor))
+            {
+                Count(GetConnectionId(Connection), ClassName, FunctionName, true, Bits);
+            }
+        }
+    }
+    else
+    {
+        // Client RPC уходит владельцу, Server RPC – по соединению с сервером
+        Count(GetConnectionId(Actor->GetNetConnection()), ClassName, FunctionName, true, Bits);
+    }
+}
+
+void UTDSNetProfilerSubsystem::Count(int32 Connection, FName Class, FName Member, bool bRPC, int32 Bits)
+{
+    FKey Key;
+    Key.Connection = Connection;
+    Key.Class = Class;
+    Key.Member = Member;
+    Key.bRPC = bRPC;
+
+    FCounter& Counter = Counters.FindOrAdd(Key);
+    Counter.IntervalBits += Bits;
+    Counter.IntervalCount += 1;
+    Counter.TotalBits += Bits;
+    Counter.TotalCount += 1;
+}
+
+void UTDSNetProfilerSubsystem::FlushInterval()
+{
+    if (OutputPath.IsEmpty())
+    {
+        OutputPath = FPaths::ProfilingDir() / TEXT("TDSNet") /
+            FString::Printf(TEXT("TDSNet-%s.csv"), *FDateTime::Now().ToString());
+        StartTime = GetWorld()->GetTimeSeconds();
+        FFileHelper::SaveStringToFile(TEXT("Time,Connection,Class,Member,Kind,Bits,Count\n"), *OutputPath);
+        UE_LOG(LogTemp, Log, TEXT("TDS.NetProfiler: writing %s"), *OutputPath);
+    }
+
+    const double Time = GetWorld()->GetTimeSeconds() - StartTime;
+
+    FString Rows;
+    TMap<FName, uint64> StatTotals;
+    for (TPair<FKey, FCounter>& Pair : Counters)
+    {
+        FCounter& Counter = Pair.Value;
+        if (Counter.IntervalCount == 0)
+        {
+            continue;
+        }
+
+        const FKey& Key = Pair.Key;
+        const FString* Label = ConnectionLabels.Find(Key.Connection);
+        Rows += FString::Printf(TEXT("%.2f,%s,%s,%s,%s,%llu,%u\n"), Time, Label ? **Label : TEXT("unknown"),
+            *Key.Class.ToString(), *Key.Member.ToString(), Key.bRPC ? TEXT("RPC") : TEXT("Property"),
+            Counter.IntervalBits, Counter.IntervalCount);
+
+        StatTotals.FindOrAdd(*FString::Printf(TEXT("%s.%s"), *Key.Class.ToString(), *Key.Member.ToString())) += Counter.IntervalBits;
+
+        Counter.IntervalBits = 0;
+        Counter.IntervalCount = 0;
+    }
+
+    if (!Rows.IsEmpty())
+    {
+        FFileHelper::SaveStringToFile(Rows, *OutputPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+    }
+
+#if STATS
+    // stat TDSNet: биты за последний интервал по всем соединениям, одна строка на член класса
+    for (const TPair<FName, uint64>& Total : StatTotals)
+    {
+        TStatId& StatId = StatIds.FindOrAdd(Total.Key);
+        if (!StatId.IsValidStat())
+        {
+            StatId = FDynamicStats::CreateStatIdInt64<FStatGroup_STATGROUP_TDSNet>(Total.Key.ToString(), true);
+        }
+        FThreadStats::AddMessage(StatId.GetName(), EStatOperation::Set, static_cast<int64>(Total.Value));
+    }
+#endif
+}
+
+void UTDSNetProfilerSubsystem::Report(int32 MaxRows) const
+{
+    TArray<TPair<FKey, FCounter>> Sorted = Counters.Array();
+    Sorted.Sort([](const TPair<FKey, FCounter>& A, const TPair<FKey, FCounter>& B)
+    {
+        return A.Value.TotalBits > B.Value.TotalBits;
+    });
+
+    UE_LOG(LogTemp, Display, TEXT("TDS.NetProfiler: %d entries"), Sorted.Num());
+    for (int32 Index = 0; Index < FMath::Min(MaxRows, Sorted.Num()); ++Index)
+    {
+        const FKey& Key = Sorted[Index].Key;
+        const FCounter& Counter = Sorted[Index].Value;
+        const FString* Label = ConnectionLabels.Find(Key.Connection);
+        UE_LOG(LogTemp, Display, TEXT("  %-10s %-40s %-8s %10.1f KB %8u sends"), Label ? **Label : TEXT("unknown"),
+            *FString::Printf(TEXT("%s.%s"), *Key.Class.ToString(), *Key.Member.ToString()),
+            Key.bRPC ? TEXT("RPC") : TEXT("Property"), Counter.TotalBits / 8192.0, Counter.TotalCount);
+    }
+}
@@ -0,0 +1,167 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/CoreNetTypes.h"
+#include "TDSNetProfilerSubsystem.generated.h"
+
+class UNetConnection;
+class UNetDriver;
+struct FFrame;
+struct FOutParmRec;
+
+/**
+ * Профилировщик трафика репликации классов TDS (ATDSCharacter, UTDSCharacterMovementComponent,
+ * ATDSPlayerController) по свойствам и RPC, соединениям и классам.
+ * Включается TDS.NetProfiler.Enabled 1.
+ *
+ * Свойства: после отправки сети (OnPostTickFlush) для каждого актора, реплицированного в этом кадре,
+ * реплицируемые свойства сравниваются с теневой копией; изменившиеся сериализуются через
+ * NetSerializeItem, и их размер засчитывается каждому соединению с открытым каналом актора
+ * с учётом условия репликации (COND_OwnerOnly, COND_SkipOwner, ...).
+ * RPC: UNetDriver::SendRPCDel, размер – сериализованные параметры плюс заголовок.
+ *
+ * Это оценка: без учёта дельта-сжатия, заголовков пакетов и повторных отправок; точные биты –
+ * в Network Insights. Для сравнения «до/после» оценки достаточно.
+ *
+ * Раз в TDS.NetProfiler.IntervalSeconds строки интервала дописываются в CSV
+ * (Saved/Profiling/TDSNet), суммы по классам и членам видны на странице stat TDSNet,
+ * TDS.NetProfiler.Report выводит самых дорогих в лог.
+ */
+UCLASS()
+class TOPDOWNSHOOTER_API UTDSNetProfilerSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    /** Вывести в лог самых дорогих членов за всё время */
+    void Report(int32 MaxRows) const;
+
+    /**
+     * Биты реплицируемых свойств Object, изменившихся с прошлого вызова: во сколько обошлась бы отправка
+     * одному соединению-наблюдателю, не владельцу. Первый вызов только запоминает значения.
+     * Для замеров без подключённых клиентов (UTDSSoakTestSubsystem); от TDS.NetProfiler.Enabled не зависит.
+     * @param SkipProperty  свойство, сейчас выключенное для репликации (DOREPLIFETIME_ACTIVE_OVERRIDE)
+     */
+    int64 MeasureChangedBits(UObject& Object, FName SkipProperty = NAME_None);
+
+private:
+    /** Реплицируемое свойство класса и его место в теневой копии */
+    struct FTrackedProperty
+    {
+        FProperty* Property = nullptr;
+        ELifetimeCondition Condition = COND_None;
+        int32 ShadowOffset = 0;
+
+        /** Ссылки на объекты нельзя сериализовать без PackageMap – размер оценивается */
+        bool bHasObjectReferences = false;
+    };
+
+    struct FClassLayout
+    {
+        TArray<FTrackedProperty> Properties;
+        int32 ShadowSize = 0;
+
+        /** Биты на индекс изменившегося свойства */
+        int32 HandleBits = 0;
+    };
+
+    /** Теневая копия реплицируемых свойств одного объекта */
+    struct FShadow
+    {
+        const FClassLayout* Layout = nullptr;
+        TArray<uint8, TAlignedHeapAllocator<16>> Data;
+
+        ~FShadow();
+    };
+
+    struct FKey
+    {
+        int32 Connection = INDEX_NONE;
+        FName Class;
+        FName Member;
+        bool bRPC = false;
+
+        bool operator==(const FKey& Other) const
+        {
+            return Connection == Other.Connection && Class == Other.Class && Member == Other.Member && bRPC == Other.bRPC;
+        }
+
+        friend uint32 GetTypeHash(const FKey& Key)
+        {
+            return HashCombine(HashCombine(GetTypeHash(Key.Connection), GetTypeHash(Key.Class)),
+                HashCombine(GetTypeHash(Key.Member), GetTypeHash(Key.bRPC)));
+        }
+    };
+
+    struct FCounter
+    {
+        uint64 IntervalBits = 0;
+        uint32 IntervalCount = 0;
+        uint64 TotalBits = 0;
+        uint32 TotalCount = 0;
+    };
+
+    TMap<TObjectKey<UClass>, TUniquePtr<FClassLayout>> Layouts;
+    TMap<TObjectKey<UObject>, TUniquePtr<FShadow>> Shadows;
+
+    /** Теневые копии MeasureChangedBits – отдельно от профилирования по соединениям */
+    TMap<TObjectKey<UObject>, TUniquePtr<FShadow>> MeasureShadows;
+    TMap<FKey, FCounter> Counters;
+
+    /** Динамические счётчики страницы stat TDSNet */
+    TMap<FName, TStatId> StatIds;
+
+    /** Метки соединений для CSV (PlayerId или "server") */
+    TMap<int32, FString> ConnectionLabels;
+
+    TWeakObjectPtr<UNetDriver> BoundNetDriver;
+    FDelegateHandle PostTickFlushHandle;
+
+    FString OutputPath;
+    float IntervalTimer = 0.0f;
+    double StartTime = 0.0;
+
+    bool IsProfiling() const;
+
+    /** Подписаться на RPC net driver'а мира (он может появиться после Initialize) */
+    void BindNetDriver();
+    void UnbindNetDriver();
+
+    void OnPostTickFlush();
+
+    /** Сравнить свойства объекта с теневой копией и засчитать изменившиеся соединениям */
+    void ProfileProperties(UObject& Object, const AActor& Actor, UNetDriver& NetDriver);
+
+    void OnSendRPC(AActor* Actor, UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack, UObject* SubObject, bool& bBlockSendRPC);
+
+    const FClassLayout& GetLayout(UClass* Class);
+
+    /** Теневая копия с текущими значениями свойств объекта */
+    static TUniquePtr<FShadow> MakeShadow(const UObject& Object, const FClassLayout& Layout);
+
+    /** Биты изменившихся элементов свойства с индексом; теневая копия обновляется */
+    static int32 DiffProperty(const UObject& Object, const FTrackedProperty& Tracked, const FClassLayout& Layout, FShadow& Shadow);
+
+    /** Размер значения в битах: NetSerializeItem или оценка для ссылок на объекты */
+    static int32 MeasureBits(const FProperty& Property, const void* Value, bool bHasObjectReferences);
+
+    /** Сумма по полям структуры без собственного NetSerialize – так её реплицирует FRepLayout */
+    static int32 MeasureStructBits(const UScriptStruct& Struct, const void* Value);
+
+    int32 GetConnectionId(const UNetConnection* Connection);
+
+    void Count(int32 Connection, FName Class, FName Member, bool bRPC, int32 Bits);
+
+    /** Дописать интервал в CSV и обновить stat TDSNet */
+    void FlushInterval();
+};
@@ -0,0 +1,12 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "TDSStats.h"
+
+DEFINE_STAT(STAT_TDSMovementTick);
+DEFINE_STAT(STAT_TDSTraces);
+
+FTDSPerfCounters& FTDSPerfCounters::Get()
+{
+    static FTDSPerfCounters Counters;
+    return Counters;
+}
@@ -0,0 +1,148 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include <atomic>
+
+DECLARE_STATS_GROUP(TEXT("TDS"), STATGROUP_TDS, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TDS Movement Tick"), STAT_TDSMovementTick, STATGROUP_TDS, TOPDOWNSHOOTER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("TDS Traces"), STAT_TDSTraces, STATGROUP_TDS, TOPDOWNSHOOTER_API);
+
+/**
+ * Счётчики производительности TDS за всё время процесса.
+ * Пишутся с игрового потока без блокировок (relaxed atomics), читатели берут разницу между снимками.
+ */
+struct TOPDOWNSHOOTER_API FTDSPerfCounters
+{
+    /** Суммарное время тиков компонентов движения, циклы FPlatformTime::Cycles64 */
+    std::atomic<uint64> MovementCycles{0};
+
+    /** Число тиков компонентов движения */
+    std::atomic<uint64> MovementTicks{0};
+
+    /** Число трассировок/sweep, выполненных кодом TDS */
+    std::atomic<uint64> Traces{0};
+
+    /** Число клиентских ходов, выполненных сервером (ServerMove_PerformMovement) */
+    std::atomic<uint64> ServerMoves{0};
+
+    /** Число принятых сервером RPC ServerMovePacked; в одном RPC до трёх ходов */
+    std::atomic<uint64> ServerMoveRpcs{0};
+
+    /** Число ходов, на которые сервер ответил коррекцией */
+    std::atomic<uint64> Corrections{0};
+
+    /** Число ходов, не прошедших проверку огибающей скорости (UTDSMoveValidationSubsystem) */
+    std::atomic<uint64> MoveViolations{0};
+
+    /** Входы в идущий матч и суммарное время от PostLogin до первого хода игрока, мкс (UTDSJoinReplicationSubsystem) */
+    std::atomic<uint64> Joins{0};
+    std::atomic<uint64> JoinToControlMicros{0};
+
+    /** Расхождения хэша состояния в режиме lockstep (UTDSLockstepSubsystem) */
+    std::atomic<uint64> LockstepDesyncs{0};
+
+    /** Верхние границы корзин гистограммы времени работы кадра, мс; последняя корзина – +Inf */
+    static constexpr int32 NumFrameBuckets = 8;
+    static constexpr float FrameBucketMs[NumFrameBuckets - 1] = { 5.0f, 10.0f, 16.7f, 25.0f, 33.3f, 50.0f, 100.0f };
+
+    /** Гистограмма времени работы кадра (без сна до NetServerMaxTickRate), не накопительная */
+    std::atomic<uint64> FrameBuckets[NumFrameBuckets] = {};
+
+    /** Сумма времени работы кадров, мкс */
+    std::atomic<uint64> FrameWorkMicros{0};
+
+    /** Число подключённых игроков (снимок UTDSMetricsSubsystem) */
+    std::atomic<uint32> Players{0};
+
+    /** Число персонажей по режимам движения, см. UTDSMetricsSubsystem::GetModeName */
+    static constexpr int32 NumModeSlots = 8;
+    std::atomic<uint32> ModePopulation[NumModeSlots] = {};
+
+    /** Трафик клиентского соединения; PlayerId == INDEX_NONE – слот свободен */
+    struct FConnectionSlot
+    {
+        std::atomic<int32> PlayerId{INDEX_NONE};
+        std::atomic<uint64> InBytes{0};
+        std::atomic<uint64> OutBytes{0};
+    };
+
+    static constexpr int32 MaxConnectionSlots = 64;
+    FConnectionSlot Connections[MaxConnectionSlots];
+
+    static FTDSPerfCounters& Get();
+
+    void AddMovementCycles(uint64 Cycles)
+    {
+        MovementCycles.fetch_add(Cycles, std::memory_order_relaxed);
+        MovementTicks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void CountTrace(uint32 Count = 1)
+    {
+        Traces.fetch_add(Count, std::memory_order_relaxed);
+        INC_DWORD_STAT_BY(STAT_TDSTraces, Count);
+    }
+
+    void CountServerMove()
+    {
+        ServerMoves.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void CountServerMoveRpc()
+    {
+        ServerMoveRpcs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void CountCorrection()
+    {
+        Corrections.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void CountMoveViolation()
+    {
+        MoveViolations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void AddJoinToControl(double Seconds)
+    {
+        Joins.fetch_add(1, std::memory_order_relaxed);
+        JoinToControlMicros.fetch_add(static_cast<uint64>(Seconds * 1000000.0), std::memory_order_relaxed);
+    }
+
+    void CountLockstepDesync()
+    {
+        LockstepDesyncs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void AddFrame(float WorkMs)
+    {
+        int32 Bucket = 0;
+        while (Bucket < NumFrameBuckets - 1 && WorkMs > FrameBucketMs[Bucket])
+        {
+            ++Bucket;
+        }
+        FrameBuckets[Bucket].fetch_add(1, std::memory_order_relaxed);
+        FrameWorkMicros.fetch_add(static_cast<uint64>(WorkMs * 1000.0f), std::memory_order_relaxed);
+    }
+};
+
+/** Замер тика компонента движения: stat TDS + FTDSPerfCounters */
+struct FTDSScopedMovementTimer
+{
+    FTDSScopedMovementTimer()
+        : StartCycles(FPlatformTime::Cycles64())
+    {
+    }
+
+    ~FTDSScopedMovementTimer()
+    {
+        FTDSPerfCounters::Get().AddMovementCycles(FPlatformTime::Cycles64() - StartCycles);
+    }
+
+private:
+    uint64 StartCycles;
+};
@@ -36,6 +36,20 @@ void UTDSGameInstance::Init()
     SessionInterface->OnDestroySessionCompleteDelegates.AddUObject(this, &UTDSGameInstance::OnDestroySessionComplete);
 }
 
+void UTDSGameInstance::OnStart()
+{
+    Super::OnStart();
+
+    //     ,      listen-.
+    // OnStart     ,    .
+    if (IsDedicatedServerInstance())
+    {
+        FString MapName;
+        FParse::Value(FCommandLine::Get(), TEXT("TDSMap="), MapName);
+        CreateDedicatedSession(MapName);
+    }
+}
+
 void UTDSGameInstance::CreateLANSession(FString MapName)
 {
     if (!SessionInterface.IsValid())
@@ -57,6 +71,26 @@ void UTDSGameInstance::CreateLANSession(FString MapName)
     DestroyExistingSessionAndCreateNew(MapName);
 }
 
+void UTDSGameInstance::CreateDedicatedSession(FString MapName)
+{
+    if (!SessionInterface.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Error: SessionInterface is not valid!"));
+        return;
+    }
+
+    if (!IsDedicatedServerInstance())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Error: CreateDedicatedSession called on a non-dedicated instance, use CreateLANSession instead."));
+        return;
+    }
+
+    //      ,    
+    SelectedMapName = MapName;
+
+    DestroyExistingSessionAndCreateNew(MapName);
+}
+
 void UTDSGameInstance::DestroyExistingSessionAndCreateNew(FString MapName)
 {
     //      SESSION_NAME
@@ -89,6 +123,11 @@ void UTDSGameInstance::OnDestroySessionComplete(FName SessionName, bool bWasSucc
     }
 }
 
+const FOnlineSessionSettings* UTDSGameInstance::GetHostedSessionSettings() const
+{
+    return SessionInterface.IsValid() ? SessionInterface->GetSessionSettings(SESSION_NAME) : nullptr;
+}
+
 void UTDSGameInstance::CreateLANSessionInternal(FString MapName)
 {
     FOnlineSessionSettings SessionSettings;
@@ -96,6 +135,9 @@ void UTDSGameInstance::CreateLANSessionInternal(FString MapName)
     SessionSettings.NumPublicConnections = 5;
     SessionSettings.bShouldAdvertise = true;
     SessionSettings.bUsesPresence = false;
+    SessionSettings.bIsDedicated = IsDedicatedServerInstance();
+    //         , LAN-    
+    SessionSettings.bAllowJoinInProgress = SessionSettings.bIsDedicated;
 
     if (!SessionInterface->CreateSession(0, SESSION_NAME, SessionSettings))
     {
@@ -113,6 +155,17 @@ void UTDSGameInstance::OnCreateSessionComplete(FName SessionName, bool bWasSucce
     {
         UE_LOG(LogTemp, Log, TEXT("LAN session %s successfully created"), *SessionName.ToString());
 
+        //     :       
+        if (IsDedicatedServerInstance())
+        {
+            if (!SelectedMapName.IsEmpty())
+            {
+                UE_LOG(LogTemp, Log, TEXT("Dedicated server travelling to: %s"), *SelectedMapName);
+                GetWorld()->ServerTravel(SelectedMapName);
+            }
+            return;
+        }
+
         //         listen.
         //       .
         if (!SelectedMapName.IsEmpty())
@@ -33,6 +33,20 @@ public:
     UFUNCTION(BlueprintCallable)
     void FindAndJoinLANSession();
 
+    /**
+     *     (  ).
+     *    OnStart   ;    -TDSMap=,
+     *       ,    .
+     */
+    UFUNCTION(BlueprintCallable)
+    void CreateDedicatedSession(FString MapName);
+
+    /**  ,     (   ); nullptr    */
+    const FOnlineSessionSettings* GetHostedSessionSettings() const;
+
+protected:
+    virtual void OnStart() override;
+
 private:
     IOnlineSessionPtr SessionInterface;
     TSharedPtr<FOnlineSessionSearch> SessionSearch;
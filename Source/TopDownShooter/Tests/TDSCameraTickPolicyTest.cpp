@@ -0,0 +1,100 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TDSTestWorld.h"
+#include "TDSCharacter.h"
+#include "TDSCameraControlComponent.h"
+#include "GameFramework/PlayerController.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTDSCameraTickPolicyTest, "TopDownShooter.Camera.TickPolicy",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace TDSCameraTickPolicyTest
+{
+    /** Персонаж с камерным компонентом, как его собирает Blueprint; bPossess – под локальным контроллером */
+    static UTDSCameraControlComponent* SpawnCharacter(FTDSTestWorld& World, ENetRole Role, bool bPossess)
+    {
+        ATDSCharacter* Character = World.Spawn<ATDSCharacter>();
+        if (!Character)
+        {
+            return nullptr;
+        }
+
+        Character->SetRole(Role);
+        if (bPossess)
+        {
+            World.Spawn<APlayerController>()->Possess(Character);
+        }
+
+        UTDSCameraControlComponent* Camera = NewObject<UTDSCameraControlComponent>(Character);
+        // C++-класс тик не включает; политика проверяется для наследника, которому тик нужен
+        Camera->PrimaryComponentTick.bCanEverTick = true;
+        Camera->RegisterComponent();
+        return Camera;
+    }
+}
+
+bool FTDSCameraTickPolicyTest::RunTest(const FString& Parameters)
+{
+    using namespace TDSCameraTickPolicyTest;
+
+    FTDSTestWorld World;
+
+    struct FCase
+    {
+        const TCHAR* Name;
+        ENetRole Role;
+        bool bPossess;
+        int32 ExpectedTicking;
+    };
+
+    const FCase Cases[] = {
+        { TEXT("Local player"),           ROLE_Authority,       true,  1 },
+        { TEXT("Remote pawn on server"),  ROLE_Authority,       false, 0 },
+        { TEXT("Owning client"),          ROLE_AutonomousProxy, true,  1 },
+        { TEXT("Simulated proxy"),        ROLE_SimulatedProxy,  false, 0 },
+    };
+
+    // Несколько копий каждой роли: счётчик должен расти только за персонажа под локальным контроллером
+    constexpr int32 CopiesPerRole = 3;
+
+    for (const FCase& Case : Cases)
+    {
+        int32 Ticking = 0;
+        for (int32 Copy = 0; Copy < CopiesPerRole; ++Copy)
+        {
+            UTDSCameraControlComponent* Camera = SpawnCharacter(World, Case.Role, Case.bPossess && Copy == 0);
+            if (!TestNotNull(FString::Printf(TEXT("%s: camera component"), Case.Name), Camera))
+            {
+                return false;
+            }
+
+            Ticking += Camera->PrimaryComponentTick.IsTickFunctionRegistered() ? 1 : 0;
+        }
+
+        TestEqual(FString::Printf(TEXT("%s: ticking camera components"), Case.Name), Ticking, Case.ExpectedTicking);
+    }
+
+    // Смена контроллера сама переключает тик (ATDSCharacter::NotifyControllerChanged)
+    UTDSCameraControlComponent* Camera = SpawnCharacter(World, ROLE_Authority, false);
+    APawn* Pawn = CastChecked<APawn>(Camera->GetOwner());
+    TestFalse(TEXT("Not possessed: not ticking"), Camera->PrimaryComponentTick.IsTickFunctionRegistered());
+
+    APlayerController* Controller = World.Spawn<APlayerController>();
+    Controller->Possess(Pawn);
+    TestTrue(TEXT("Possessed: ticking"), Camera->PrimaryComponentTick.IsTickFunctionRegistered());
+
+    Controller->UnPossess();
+    TestFalse(TEXT("Unpossessed: not ticking"), Camera->PrimaryComponentTick.IsTickFunctionRegistered());
+
+    Controller->Possess(Pawn);
+    TestTrue(TEXT("Possessed again: ticking"), Camera->PrimaryComponentTick.IsTickFunctionRegistered());
+
+    return true;
+}
+
+#endif
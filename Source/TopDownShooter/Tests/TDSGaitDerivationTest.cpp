@@ -0,0 +1,156 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TDSTestWorld.h"
+#include "TDSCharacter.h"
+#include "TDSCharacterMovementComponent.h"
+#include "TDSMovementCompression.h"
+#include "UObject/CoreNet.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTDSGaitDerivationTest, "TopDownShooter.Movement.ProxyGaitDerivation",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace TDSGaitDerivationTest
+{
+    /**
+     * Состояние сервера: ввод величиной InputSize и ускорение направлены по скорости.
+     * ExpectedGait – ожидаемый ответ GetDesiredGait, проверка самой таблицы.
+     */
+    struct FSample
+    {
+        const TCHAR* Name;
+        EAnalogStickBehavior StickMode;
+        bool bWalk;
+        bool bSprint;
+        bool bAim;
+        double InputSize;
+        double Speed;
+        double VelocityYaw;
+        double ActorYaw;
+        EGait ExpectedGait;
+    };
+
+    /** Движение сервера в том виде, в каком его получает симулируемый прокси */
+    static FRepMovement ReceiveAsProxy(ATDSCharacter& Server, bool bPlanar)
+    {
+        Server.GatherCurrentMovement();
+        const FRepMovement& Sent = Server.GetReplicatedMovement();
+
+        // Копия несёт уровни квантования отправителя
+        FRepMovement Received = Sent;
+        bool bSuccess = true;
+
+        FNetBitWriter Writer(nullptr, 0);
+        if (bPlanar)
+        {
+            FTDSRepMovement Planar;
+            Planar.FromRepMovement(Sent, true, TDSMovementCompression::GetLevelOrigin(Server.GetWorld()));
+            Planar.NetSerialize(Writer, nullptr, bSuccess);
+
+            FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+            FTDSRepMovement ReceivedPlanar;
+            ReceivedPlanar.NetSerialize(Reader, nullptr, bSuccess);
+            ReceivedPlanar.ToRepMovement(Received, TDSMovementCompression::GetLevelOrigin(Server.GetWorld()));
+        }
+        else
+        {
+            FRepMovement ToSend = Sent;
+            ToSend.NetSerialize(Writer, nullptr, bSuccess);
+
+            FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+            Received.NetSerialize(Reader, nullptr, bSuccess);
+        }
+
+        return Received;
+    }
+}
+
+bool FTDSGaitDerivationTest::RunTest(const FString& Parameters)
+{
+    using namespace TDSGaitDerivationTest;
+
+    FTDSTestWorld World;
+    ATDSCharacter* Server = World.Spawn<ATDSCharacter>();
+    ATDSCharacter* Proxy = World.Spawn<ATDSCharacter>(FVector(0.0, 500.0, 0.0));
+    if (!TestNotNull(TEXT("Server character"), Server) || !TestNotNull(TEXT("Proxy character"), Proxy))
+    {
+        return false;
+    }
+    Proxy->SetRole(ROLE_SimulatedProxy);
+
+    UTDSCharacterMovementComponent* ServerMove = Server->GetTDSMovementComponent();
+    UTDSCharacterMovementComponent* ProxyMove = Proxy->GetTDSMovementComponent();
+    if (!TestNotNull(TEXT("Server movement"), ServerMove) || !TestNotNull(TEXT("Proxy movement"), ProxyMove))
+    {
+        return false;
+    }
+
+    // Ввод, ускорение и ориентация сервера так, как их выставляют ввод и ход для этого состояния
+    // (лямбда, а не функция пространства имён: поля кэша ввода доступны только тесту)
+    auto SetServerInput = [ServerMove](const FSample& Sample)
+    {
+        const FVector Direction = FRotator(0.0, Sample.VelocityYaw, 0.0).Vector();
+        const FVector2D Input = FVector2D(Direction) * Sample.InputSize;
+
+        // Кэш ввода считается свежим на текущий кадр, поэтому UpdateCachedInput его не перезапишет
+        ServerMove->CachedMoveInput = Input;
+        ServerMove->CachedMoveWorldSpaceInput = Input;
+        ServerMove->LastInputUpdateTime = ServerMove->GetWorld()->GetTimeSeconds();
+
+        ServerMove->Acceleration = Direction * Sample.InputSize * ServerMove->GetMaxAcceleration();
+        ServerMove->bOrientRotationToMovement = !Sample.bAim;
+    };
+
+    const FSample Samples[] = {
+        { TEXT("Run"),                           EAnalogStickBehavior::FixedSingleGait, false, false, false, 1.0, 500.0,   0.0,  0.0, EGait::Run },
+        { TEXT("Walk ignored in single gait"),   EAnalogStickBehavior::FixedSingleGait, true,  false, false, 1.0, 500.0,   0.0,  0.0, EGait::Run },
+        { TEXT("Sprint"),                        EAnalogStickBehavior::FixedSingleGait, false, true,  false, 1.0, 700.0,  45.0, 45.0, EGait::Sprint },
+        { TEXT("Sprint held, standing"),         EAnalogStickBehavior::FixedSingleGait, false, true,  false, 0.0,   0.0,   0.0,  0.0, EGait::Run },
+        { TEXT("Sprint aiming sideways"),        EAnalogStickBehavior::FixedSingleGait, false, true,  true,  1.0, 350.0,  90.0,  0.0, EGait::Run },
+        { TEXT("Sprint aiming backwards"),       EAnalogStickBehavior::FixedSingleGait, false, true,  true,  1.0, 300.0, 180.0,  0.0, EGait::Run },
+        { TEXT("Sprint aiming forward"),         EAnalogStickBehavior::FixedSingleGait, false, true,  true,  1.0, 700.0,  30.0,  0.0, EGait::Sprint },
+        { TEXT("Walk, partial input"),           EAnalogStickBehavior::FixedWalkRun,    true,  false, false, 0.5, 200.0, -60.0,  0.0, EGait::Walk },
+        { TEXT("Run, partial input"),            EAnalogStickBehavior::FixedWalkRun,    false, false, false, 0.5, 200.0, -60.0,  0.0, EGait::Run },
+        { TEXT("Walk held, full input"),         EAnalogStickBehavior::FixedWalkRun,    true,  false, false, 1.0, 500.0, 120.0,  0.0, EGait::Run },
+        { TEXT("Sprint, walk/run stick"),        EAnalogStickBehavior::VariableWalkRun, false, true,  false, 1.0, 700.0, 135.0, 135.0, EGait::Sprint },
+    };
+
+    for (const bool bPlanar : { false, true })
+    {
+        for (const FSample& Sample : Samples)
+        {
+            for (UTDSCharacterMovementComponent* MoveComp : { ServerMove, ProxyMove })
+            {
+                MoveComp->MovementStickMode = Sample.StickMode;
+                MoveComp->SetWalking(Sample.bWalk, true);
+                MoveComp->SetSprinting(Sample.bSprint, true);
+                MoveComp->SetAiming(Sample.bAim, true);
+                MoveComp->SetStrafing(false, true);
+            }
+
+            Server->SetActorRotation(FRotator(0.0, Sample.ActorYaw, 0.0));
+            ServerMove->Velocity = FRotator(0.0, Sample.VelocityYaw, 0.0).Vector() * Sample.Speed;
+            SetServerInput(Sample);
+
+            // Авторитетный гейт – выбор сервера при этом вводе, а не значение из таблицы
+            const EGait AuthoritativeGait = ServerMove->GetDesiredGait();
+            const FString Context = FString::Printf(TEXT("%s (%s)"), Sample.Name, bPlanar ? TEXT("planar") : TEXT("FRepMovement"));
+            TestEqual(Context + TEXT(": desired gait"), static_cast<uint8>(AuthoritativeGait), static_cast<uint8>(Sample.ExpectedGait));
+
+            // Прокси видит только квантованные поворот и скорость; сглаживания в тестовом мире нет
+            const FRepMovement Received = ReceiveAsProxy(*Server, bPlanar);
+            Proxy->SetActorRotation(Received.Rotation);
+            ProxyMove->Velocity = Received.LinearVelocity;
+
+            TestEqual(Context + TEXT(": derived gait"), static_cast<uint8>(ProxyMove->DeriveReplicatedGait()), static_cast<uint8>(AuthoritativeGait));
+        }
+    }
+
+    return true;
+}
+
+#endif
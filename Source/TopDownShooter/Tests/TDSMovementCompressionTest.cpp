@@ -0,0 +1,102 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TDSMovementCompression.h"
+#include "UObject/CoreNet.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTDSMovementCompressionTest, "TopDownShooter.Net.PlanarMovementCompression",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace TDSMovementCompressionTest
+{
+    /** Движение персонажа относительно начала координат уровня */
+    struct FSample
+    {
+        const TCHAR* Name;
+        FVector Location;
+        double Yaw;
+        FVector Velocity;
+        bool bGrounded;
+    };
+
+    /** Не совпадает с началом координат мира, чтобы проверить перенос */
+    static const FVector LevelOrigin(12000.0, -8000.0, -250.0);
+
+    static int64 MeasureEngine(const FRepMovement& Movement)
+    {
+        FRepMovement ToSend = Movement;
+        FNetBitWriter Writer(nullptr, 0);
+        bool bSuccess = true;
+        ToSend.NetSerialize(Writer, nullptr, bSuccess);
+        return Writer.GetNumBits();
+    }
+
+    static int64 MeasurePlanar(const FRepMovement& Movement, bool bGrounded, FRepMovement& OutReceived)
+    {
+        FTDSRepMovement Planar;
+        Planar.FromRepMovement(Movement, bGrounded, LevelOrigin);
+
+        FNetBitWriter Writer(nullptr, 0);
+        bool bSuccess = true;
+        Planar.NetSerialize(Writer, nullptr, bSuccess);
+
+        FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+        FTDSRepMovement Received;
+        Received.NetSerialize(Reader, nullptr, bSuccess);
+        Received.ToRepMovement(OutReceived, LevelOrigin);
+
+        return Writer.GetNumBits();
+    }
+}
+
+bool FTDSMovementCompressionTest::RunTest(const FString& Parameters)
+{
+    using namespace TDSMovementCompressionTest;
+
+    // Типичные состояния на уровне до ±100 м от центра; последние – в воздухе и за пределами сжатого диапазона
+    const FSample Samples[] = {
+        { TEXT("Standing near center"),  FVector(   340.0,   -120.0,  342.15),   0.0, FVector::ZeroVector,             true },
+        { TEXT("Walking"),               FVector(  2531.4,   1804.7,  342.15),  37.2, FVector(160.0, 120.0, 0.0),     true },
+        { TEXT("Running"),               FVector( -4210.9,   6620.3,  342.15), 181.7, FVector(-353.6, 353.6, 0.0),    true },
+        { TEXT("Sprinting"),             FVector(  7710.2,  -5012.8,  342.15), 270.4, FVector(0.0, -700.0, 0.0),      true },
+        { TEXT("Strafing, far edge"),    FVector( -9650.6,  -9480.1,  742.15),  92.9, FVector(350.0, 0.0, 0.0),       true },
+        { TEXT("Standing, far edge"),    FVector(  9120.0,   8870.0,  342.15), 315.0, FVector::ZeroVector,             true },
+        { TEXT("Falling"),               FVector(  1250.3,  -3380.6,  910.40), 140.0, FVector(210.0, -90.0, -640.0),  false },
+        { TEXT("Out of compact range"),  FVector( 45000.0,  -2000.0,  342.15),  10.0, FVector(500.0, 0.0, 0.0),       true },
+    };
+
+    int64 EngineBits = 0;
+    int64 PlanarBits = 0;
+    for (const FSample& Sample : Samples)
+    {
+        FRepMovement Movement;
+        Movement.Location = LevelOrigin + Sample.Location;
+        Movement.Rotation = FRotator(0.0, Sample.Yaw, 0.0);
+        Movement.LinearVelocity = Sample.Velocity;
+
+        FRepMovement Received;
+        const int64 SampleEngineBits = MeasureEngine(Movement);
+        const int64 SamplePlanarBits = MeasurePlanar(Movement, Sample.bGrounded, Received);
+        EngineBits += SampleEngineBits;
+        PlanarBits += SamplePlanarBits;
+        AddInfo(FString::Printf(TEXT("%s: FRepMovement %lld bits, planar %lld bits"), Sample.Name, SampleEngineBits, SamplePlanarBits));
+
+        // Сетка 1 см по осям и 360/1024 по yaw; скорость – шаг 2 см/с
+        TestTrue(FString::Printf(TEXT("%s: location"), Sample.Name), Received.Location.Equals(Movement.Location, 0.5 + KINDA_SMALL_NUMBER));
+        TestTrue(FString::Printf(TEXT("%s: yaw"), Sample.Name),
+            FMath::Abs(FRotator::NormalizeAxis(Received.Rotation.Yaw - Sample.Yaw)) <= 180.0 / 1024.0 + KINDA_SMALL_NUMBER);
+        TestTrue(FString::Printf(TEXT("%s: velocity"), Sample.Name), Received.LinearVelocity.Equals(Sample.Velocity, 1.0 + KINDA_SMALL_NUMBER));
+    }
+
+    AddInfo(FString::Printf(TEXT("Total: FRepMovement %lld bits, planar %lld bits (%.0f%%)"),
+        EngineBits, PlanarBits, 100.0 * PlanarBits / FMath::Max<int64>(EngineBits, 1)));
+    TestTrue(TEXT("Planar format saves at least a fifth of FRepMovement"), PlanarBits * 5 <= EngineBits * 4);
+
+    return true;
+}
+
+#endif
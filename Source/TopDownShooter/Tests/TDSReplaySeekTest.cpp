@@ -0,0 +1,149 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TDSReplayFormat.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTDSReplaySeekTest, "TopDownShooter.Replay.Seek",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace TDSReplaySeekTest
+{
+    static constexpr int32 NumSamples = 24;
+    static constexpr float SampleInterval = 0.25f;
+    static constexpr int32 CheckpointEvery = 8;
+
+    static float GetSampleTime(int32 Sample)
+    {
+        return Sample * SampleInterval;
+    }
+
+    /**
+     * Синтетический мир на снимке Sample: персонаж 3 появляется и пропадает, остальные двигаются.
+     * Снимки 9..16 повторяют 8-й – кадров нет, а контрольная точка на 16-м пустая.
+     */
+    static FTDSReplayState MakeState(int32 Sample)
+    {
+        const int32 Step = (Sample > CheckpointEvery && Sample <= 2 * CheckpointEvery) ? CheckpointEvery : Sample;
+
+        FTDSReplayState State;
+        for (int32 Id = 1; Id <= 3; ++Id)
+        {
+            if (Id == 3 && (Step < 5 || Step >= 20))
+            {
+                continue;
+            }
+
+            FTDSReplayCharacterState& Character = State.Add(Id);
+            Character.Location = FIntVector(37 * Step * Id, -11 * Step, Id == 2 ? 90 + Step % 4 : 90);
+            Character.AimYaw = static_cast<uint16>(Step * 4000 * Id);
+            Character.Gait = static_cast<uint8>((Step + Id) % 3);
+            Character.MovementMode = Step % 7 == 0 ? 3 : 1;
+            Character.CustomMovementMode = Id == 1 && Step > 12 ? 2 : 0;
+            Character.StateMask = static_cast<uint8>((Step + Id) & 0x1F);
+        }
+        return State;
+    }
+
+    /** Состояние на момент Time: последний снимок не позже него */
+    static FTDSReplayState GetExpectedState(float Time)
+    {
+        const int32 Sample = FMath::Min(FMath::FloorToInt(Time / SampleInterval), NumSamples);
+        return Sample >= 1 ? MakeState(Sample) : FTDSReplayState();
+    }
+
+    /** Запись так же, как её ведёт UTDSReplaySubsystem: кадры – от предыдущего кадра, точки – от предыдущей точки */
+    static TArray<uint8> Record()
+    {
+        TArray<uint8> File;
+        FMemoryWriter FileWriter(File);
+        TDSReplay::WriteHeader(FileWriter, TEXT("/Game/Maps/Test"));
+
+        FTDSReplayState FrameState;
+        FTDSReplayState CheckpointState;
+        for (int32 Sample = 1; Sample <= NumSamples; ++Sample)
+        {
+            const FTDSReplayState SampleState = MakeState(Sample);
+
+            TArray<uint8> Payload;
+            FMemoryWriter PayloadWriter(Payload);
+            if (TDSReplay::WriteDelta(PayloadWriter, FrameState, SampleState))
+            {
+                TDSReplay::WriteChunk(FileWriter, TDSReplay::EChunk::Frame, GetSampleTime(Sample), Payload);
+            }
+            FrameState = SampleState;
+
+            if (Sample % CheckpointEvery == 0)
+            {
+                Payload.Reset();
+                FMemoryWriter CheckpointWriter(Payload);
+                TDSReplay::WriteDelta(CheckpointWriter, CheckpointState, SampleState);
+                TDSReplay::WriteChunk(FileWriter, TDSReplay::EChunk::Checkpoint, GetSampleTime(Sample), Payload);
+                CheckpointState = SampleState;
+            }
+        }
+        return File;
+    }
+
+    static bool StatesEqual(const FTDSReplayState& A, const FTDSReplayState& B)
+    {
+        if (A.Num() != B.Num())
+        {
+            return false;
+        }
+
+        for (const TPair<uint32, FTDSReplayCharacterState>& Entry : A)
+        {
+            const FTDSReplayCharacterState* Other = B.Find(Entry.Key);
+            if (!Other || !(*Other == Entry.Value))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+bool FTDSReplaySeekTest::RunTest(const FString& Parameters)
+{
+    using namespace TDSReplaySeekTest;
+
+    const FString Path = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("TDSReplaySeekTest.tdsreplay"));
+    if (!TestTrue(TEXT("Replay written"), FFileHelper::SaveArrayToFile(Record(), *Path)))
+    {
+        return false;
+    }
+
+    FTDSReplayReader Reader;
+    if (!TestTrue(TEXT("Replay opened"), Reader.Open(Path)))
+    {
+        IFileManager::Get().Delete(*Path);
+        return false;
+    }
+    TestEqual(TEXT("Duration"), Reader.GetDuration(), GetSampleTime(NumSamples));
+
+    // Вперёд, через пустую контрольную точку (4.0), назад, до первой точки (2.0) и до первого кадра
+    const float SeekTimes[] = { 1.3f, 3.1f, 4.0f, 5.4f, 6.0f, 4.6f, 2.0f, 1.9f, 0.1f, 5.4f, 0.6f };
+    for (const float Time : SeekTimes)
+    {
+        TestTrue(FString::Printf(TEXT("SeekTo %.2f"), Time), Reader.SeekTo(Time));
+        TestTrue(FString::Printf(TEXT("SeekTo %.2f: state"), Time), StatesEqual(Reader.GetState(), GetExpectedState(Time)));
+    }
+
+    // Воспроизведение после перемотки досчитывает кадры поверх восстановленного состояния
+    TestTrue(TEXT("SeekTo 1.30"), Reader.SeekTo(1.3f));
+    TestTrue(TEXT("AdvanceTo 4.60"), Reader.AdvanceTo(4.6f));
+    TestTrue(TEXT("AdvanceTo 4.60: state"), StatesEqual(Reader.GetState(), GetExpectedState(4.6f)));
+
+    IFileManager::Get().Delete(*Path);
+    return true;
+}
+
+#endif
@@ -0,0 +1,52 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+/**
+ * Пустой игровой мир на время автотеста: создаётся с BeginPlay, уничтожается вместе с объектом.
+ * Сетевого драйвера нет – мир в режиме NM_Standalone, роли акторов тест выставляет сам.
+ */
+class FTDSTestWorld
+{
+public:
+    FTDSTestWorld()
+    {
+        World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("TDSTestWorld"));
+        FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
+        Context.SetCurrentWorld(World);
+
+        World->InitializeActorsForPlay(FURL());
+        World->BeginPlay();
+    }
+
+    ~FTDSTestWorld()
+    {
+        GEngine->DestroyWorldContext(World);
+        World->DestroyWorld(false);
+    }
+
+    FTDSTestWorld(const FTDSTestWorld&) = delete;
+    FTDSTestWorld& operator=(const FTDSTestWorld&) = delete;
+
+    UWorld* Get() const { return World; }
+
+    template<typename T>
+    T* Spawn(const FVector& Location = FVector::ZeroVector)
+    {
+        FActorSpawnParameters Params;
+        Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+        return World->SpawnActor<T>(T::StaticClass(), Location, FRotator::ZeroRotator, Params);
+    }
+
+private:
+    UWorld* World = nullptr;
+};
+
+#endif
@@ -19,6 +19,7 @@ public class TopDownShooter : ModuleRules
             "Networking",
             "Sockets",
             "NetCore",
+            "PacketHandler",
             "GameplayAbilities",
             "GameplayTags",
             "GameplayTasks"
@@ -34,7 +35,11 @@ public class TopDownShooter : ModuleRules
             "TopDownShooter/Core/Controllers",
             "TopDownShooter/Core/GamePlay",
             "TopDownShooter/Core/HUD",
-            "TopDownShooter/Camera"
+            "TopDownShooter/Core/Stats",
+            "TopDownShooter/Core/Net",
+            "TopDownShooter/Core/Replay",
+            "TopDownShooter/Camera",
+            "TopDownShooter/Automation"
         });
 
         // ����������� ����������� ������ ��� OnlineSubsystem (��������, Steam)
@@ -0,0 +1,18 @@
+// Copyright 2025, CRAFTCODE, All Rights Reserved.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+public class TopDownShooterServerTarget : TargetRules
+{
+	public TopDownShooterServerTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Server;
+		DefaultBuildSettings = BuildSettingsVersion.V5;
+
+		ExtraModuleNames.AddRange(new string[] { "TopDownShooter" });
+
+		// Выделенный сервер без рендера: логи нужны и в Shipping
+		bUseLoggingInShipping = true;
+	}
+}